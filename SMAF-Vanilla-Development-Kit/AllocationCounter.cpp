@@ -0,0 +1,140 @@
+/**
+* @file AllocationCounter.cpp
+* @brief Implementation of the per-task heap allocation counter for Arduino project.
+*
+* This file contains the implementation of the functions that count heap operations made by
+* selected tasks. setup() attaches the pipeline stages, and the transport stage takes a
+* checkpoint for every PVT solution, so the number of heap allocations and frees per fix
+* is exported as a metric. In steady-state operation it must stay at zero.
+*
+* Counting uses the allocation and free hooks of the ESP-IDF heap, which the core must be
+* built with (CONFIG_HEAP_USE_HOOKS, ESP-IDF 5 or later). Without them the per-fix gauge
+* reports -1. The loop task is not attached: the TCP/IP stack allocates its packet buffers
+* in the task that writes to a socket, by design.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Arduino.h"
+#include "AllocationCounter.h"
+#include "Metrics.h"
+#include "Logger.h"
+#include <atomic>
+
+// Tasks whose heap operations are counted. Slots are filled once and never released.
+static std::atomic<TaskHandle_t> attachedTasks[ALLOCATION_COUNTER_MAX_TASKS];
+static std::atomic<uint8_t> attachedTaskCount(0);
+
+static MetricCounter allocationCount("smaf_heap_allocations_total", "Heap allocations made by the pipeline tasks.");
+static MetricCounter freeCount("smaf_heap_frees_total", "Heap frees made by the pipeline tasks.");
+static MetricGauge operationsPerFixGauge("smaf_heap_operations_per_fix", "Heap operations of the pipeline tasks during the last PVT solution, -1 if not counted.");
+
+#if CONFIG_HEAP_USE_HOOKS
+/**
+* @brief Check if the running task is attached.
+*
+* @return true if the heap operation must be counted.
+*/
+static bool IRAM_ATTR isAttachedTask() {
+  TaskHandle_t task = xTaskGetCurrentTaskHandle();
+  uint8_t count = attachedTaskCount.load(std::memory_order_acquire);
+
+  for (uint8_t i = 0; i < count; ++i) {
+    if (attachedTasks[i].load(std::memory_order_relaxed) == task) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+* @brief Heap hook called by ESP-IDF after every successful allocation.
+*/
+extern "C" void IRAM_ATTR esp_heap_trace_alloc_hook(void* ptr, size_t size, uint32_t caps) {
+  if (isAttachedTask()) {
+    allocationCount.increment();
+  }
+}
+
+/**
+* @brief Heap hook called by ESP-IDF for every free.
+*/
+extern "C" void IRAM_ATTR esp_heap_trace_free_hook(void* ptr) {
+  if (ptr != NULL && isAttachedTask()) {
+    freeCount.increment();
+  }
+}
+#endif
+
+/**
+* @brief Initializes the allocation counter metrics.
+*
+* Logs once if the core was built without heap hooks and nothing can be counted.
+*/
+void initAllocationCounter() {
+#if !CONFIG_HEAP_USE_HOOKS
+  operationsPerFixGauge.set(-1);
+  debug(LOG, "Heap hooks are not enabled in this core, heap operations are not counted.");
+#endif
+}
+
+/**
+* @brief Starts counting the heap operations of a task.
+*
+* Must be called from a single task, normally from setup() right after creating the task.
+*
+* @param task Handle of the task to count.
+*/
+void allocationCounterAttach(TaskHandle_t task) {
+  uint8_t slot = attachedTaskCount.load(std::memory_order_relaxed);
+
+  if (task == NULL || slot >= ALLOCATION_COUNTER_MAX_TASKS) {
+    debug(ERR, "Allocation counter has no free slot for this task.");
+    return;
+  }
+
+  // Fill the slot before the count makes it visible to the hooks.
+  attachedTasks[slot].store(task, std::memory_order_relaxed);
+  attachedTaskCount.store(slot + 1, std::memory_order_release);
+}
+
+/**
+* @brief Records the heap operations of the attached tasks since the previous checkpoint.
+*
+* Called once per PVT solution from the transport stage. Any operation in steady state is
+* logged as an error.
+*/
+void allocationCounterCheckpoint() {
+#if CONFIG_HEAP_USE_HOOKS
+  static uint32_t lastOperations = 0;
+
+  uint32_t operations = allocationCount.value() + freeCount.value();
+  uint32_t operationsPerFix = operations - lastOperations;
+  lastOperations = operations;
+
+  operationsPerFixGauge.set(operationsPerFix);
+
+  if (operationsPerFix != 0) {
+    debug(ERR, "Pipeline made %u heap operations during the last PVT solution.", (unsigned int)operationsPerFix);
+  }
+#endif
+}
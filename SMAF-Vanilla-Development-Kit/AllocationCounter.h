@@ -0,0 +1,68 @@
+/**
+* @file AllocationCounter.h
+* @brief Declaration of the per-task heap allocation counter for Arduino project.
+*
+* This file contains the declarations of the functions that count heap operations made by
+* selected tasks. setup() attaches the pipeline stages, and the transport stage takes a
+* checkpoint for every PVT solution, so the number of heap allocations and frees per fix
+* is exported as a metric. In steady-state operation it must stay at zero.
+*
+* Counting uses the allocation and free hooks of the ESP-IDF heap, which the core must be
+* built with (CONFIG_HEAP_USE_HOOKS, ESP-IDF 5 or later). Without them the per-fix gauge
+* reports -1. The loop task is not attached: the TCP/IP stack allocates its packet buffers
+* in the task that writes to a socket, by design.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include "Arduino.h"
+
+// Define allocation counter parameters.
+#define ALLOCATION_COUNTER_MAX_TASKS 4  // Tasks whose heap operations can be counted.
+
+/**
+* @brief Initializes the allocation counter metrics.
+*
+* Logs once if the core was built without heap hooks and nothing can be counted.
+*/
+void initAllocationCounter();
+
+/**
+* @brief Starts counting the heap operations of a task.
+*
+* Must be called from a single task, normally from setup() right after creating the task.
+*
+* @param task Handle of the task to count.
+*/
+void allocationCounterAttach(TaskHandle_t task);
+
+/**
+* @brief Records the heap operations of the attached tasks since the previous checkpoint.
+*
+* Called once per PVT solution from the transport stage. Any operation in steady state is
+* logged as an error.
+*/
+void allocationCounterCheckpoint();
+
+#endif
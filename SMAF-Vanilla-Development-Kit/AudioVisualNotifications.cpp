@@ -31,6 +31,115 @@
 #include "Arduino.h"
 #include "AudioVisualNotifications.h"
 #include "Adafruit_NeoPixel.h"
+#include "Metrics.h"
+#include "EnergyMonitor.h"
+
+// Notification metrics.
+static MetricCounter visualFrameCount("smaf_led_frames_total", "Frames sent to the NeoPixel LED strip.");
+static MetricCounter audioNotificationCount("smaf_audio_notifications_total", "Melodies played on the speaker.");
+static MetricCounter audioDroppedCount("smaf_audio_notifications_dropped_total", "Melodies dropped because the queue was full.");
+
+// Notes of the audio notification melodies, as {frequency, duration}.
+static constexpr AudioNote introNotes[] = {
+  { NOTE_E6, 120 },
+  { NOTE_F6, 120 },
+  { NOTE_G6, 320 }
+};
+
+static constexpr AudioNote maintenanceNotes[] = {
+  { NOTE_E6, 120 },
+  { 0, 80 },
+  { NOTE_E6, 120 },
+  { 0, 80 },
+  { NOTE_F6, 120 },
+  { 0, 80 },
+  { NOTE_G6, 280 },
+  { NOTE_E6, 120 },
+  { NOTE_F6, 120 },
+  { NOTE_G6, 320 }
+};
+
+// Audio notification melodies.
+static constexpr AudioMelody introMelody = { introNotes, sizeof(introNotes) / sizeof(introNotes[0]) };
+static constexpr AudioMelody maintenanceMelody = { maintenanceNotes, sizeof(maintenanceNotes) / sizeof(maintenanceNotes[0]) };
+
+// Protects the melody queue, which the caller and the note timer callback both change.
+static portMUX_TYPE audioLock = portMUX_INITIALIZER_UNLOCKED;
+
+// Marks a pixel whose color has not been sent yet, colors only use the lower 24 bits.
+#define VISUAL_COLOR_UNKNOWN 0xFFFFFFFF
+
+/**
+* @brief Packs a color the way Adafruit_NeoPixel::Color() does, usable in constant tables.
+*/
+static constexpr uint32_t rgb(uint8_t red, uint8_t green, uint8_t blue) {
+  return ((uint32_t)red << 16) | ((uint32_t)green << 8) | blue;
+}
+
+// Colors of the visual notification patterns.
+static constexpr uint32_t colorOff = rgb(0, 0, 0);
+static constexpr uint32_t colorRed = rgb(255, 0, 0);
+static constexpr uint32_t colorGreen = rgb(0, 255, 0);
+static constexpr uint32_t colorBlue = rgb(0, 0, 255);
+static constexpr uint32_t colorMagenta = rgb(255, 0, 255);
+
+// Keyframes of the visual notification patterns, as {{pixel 0, pixel 1}, duration}.
+static constexpr VisualKeyframe offFrames[] = {
+  { { colorOff, colorOff }, 0 }
+};
+
+static constexpr VisualKeyframe notReadyFrames[] = {
+  { { colorRed, colorOff }, 240 },
+  { { colorOff, colorRed }, 240 }
+};
+
+static constexpr VisualKeyframe readyToSendFrames[] = {
+  { { colorOff, colorOff }, 0 }
+};
+
+static constexpr VisualKeyframe waitingGnssFixFrames[] = {
+  { { colorBlue, colorOff }, 240 },
+  { { colorOff, colorBlue }, 240 }
+};
+
+static constexpr VisualKeyframe loadingFrames[] = {
+  { { colorMagenta, colorOff }, 240 },
+  { { colorOff, colorMagenta }, 240 }
+};
+
+static constexpr VisualKeyframe maintenanceFrames[] = {
+  { { colorMagenta, colorMagenta }, 240 },
+  { { colorOff, colorOff }, 240 }
+};
+
+// Keyframes of the one-shot patterns played over the selected one.
+static constexpr VisualKeyframe publishedFrames[] = {
+  { { colorGreen, colorGreen }, 40 },
+  { { colorOff, colorOff }, 40 },
+  { { colorGreen, colorGreen }, 40 },
+  { { colorOff, colorOff }, 40 },
+  { { colorGreen, colorGreen }, 40 },
+  { { colorOff, colorOff }, 40 },
+  { { colorGreen, colorGreen }, 40 },
+  { { colorOff, colorOff }, 40 }
+};
+
+static constexpr VisualKeyframe fixLostFrames[] = {
+  { { colorRed, colorRed }, 120 },
+  { { colorOff, colorOff }, 120 },
+  { { colorRed, colorRed }, 120 },
+  { { colorOff, colorOff }, 240 }
+};
+
+// Visual notification patterns.
+static constexpr VisualPattern offPattern = { offFrames, sizeof(offFrames) / sizeof(offFrames[0]) };
+static constexpr VisualPattern notReadyPattern = { notReadyFrames, sizeof(notReadyFrames) / sizeof(notReadyFrames[0]) };
+static constexpr VisualPattern readyToSendPattern = { readyToSendFrames, sizeof(readyToSendFrames) / sizeof(readyToSendFrames[0]) };
+static constexpr VisualPattern waitingGnssFixPattern = { waitingGnssFixFrames, sizeof(waitingGnssFixFrames) / sizeof(waitingGnssFixFrames[0]) };
+static constexpr VisualPattern loadingPattern = { loadingFrames, sizeof(loadingFrames) / sizeof(loadingFrames[0]) };
+static constexpr VisualPattern maintenancePattern = { maintenanceFrames, sizeof(maintenanceFrames) / sizeof(maintenanceFrames[0]) };
+static constexpr VisualPattern publishedPattern = { publishedFrames, sizeof(publishedFrames) / sizeof(publishedFrames[0]) };
+static constexpr VisualPattern fixLostPattern = { fixLostFrames, sizeof(fixLostFrames) / sizeof(fixLostFrames[0]) };
 
 /**
 * @brief Constructs an instance of the AudioVisualNotifications class.
@@ -48,30 +157,78 @@ AudioVisualNotifications::AudioVisualNotifications(int neoPixelPin, int neoPixel
     _neoPixelCount(neoPixelCount),
     _neoPixelBrightness(neoPixelBrightness),
     _speakerPin(speakerPin),
-    _neoPixel(neoPixelCount, neoPixelPin, NEO_GRB + NEO_KHZ800) {
+    _neoPixel(neoPixelCount, neoPixelPin, NEO_GRB + NEO_KHZ800),
+    _frameTimer(NULL),
+    _requestedPattern(nullptr),
+    _requestedOverlay(nullptr),
+    _activePattern(nullptr),
+    _activeOverlay(nullptr),
+    _frameIndex(0),
+    _overlayFrameIndex(0),
+    _noteTimer(NULL),
+    _melodyCount(0),
+    _noteIndex(0) {
+  for (uint8_t i = 0; i < VISUAL_KEYFRAME_PIXELS; ++i) {
+    _shownColors[i] = VISUAL_COLOR_UNKNOWN;
+  }
 }
 
 /**
 * @brief Initializes the NeoPixel LED strip.
 *
 * This function initializes the NeoPixel LED strip with the specified pin and settings
-* provided during the construction of the SensoryAlert object.
-* It should be called once at the beginning of the program or whenever the NeoPixel strip needs to be re-initialized.
+* provided during the construction of the SensoryAlert object, and starts the frame timer
+* that plays the visual notification patterns. A pattern selected earlier starts playing now.
+* It should be called once at the beginning of the program.
 */
 void AudioVisualNotifications::initializeVisualNotifications() {
   _neoPixel.begin();                             // INITIALIZE NeoPixel strip object (REQUIRED)
   _neoPixel.setBrightness(_neoPixelBrightness);  // Set BRIGHTNESS to about 1/5 (max = 255)
+
+  // Patterns are played by a one-shot timer that is re-armed for every keyframe,
+  // so nothing runs between keyframes and a held frame costs no CPU time at all.
+  const esp_timer_create_args_t timerArguments = {
+    .callback = &AudioVisualNotifications::onFrameTimer,
+    .arg = this,
+    .dispatch_method = ESP_TIMER_TASK,
+    .name = "VisualFrames",
+    .skip_unhandled_events = true
+  };
+
+  if (_frameTimer == NULL && esp_timer_create(&timerArguments, &_frameTimer) == ESP_OK) {
+    esp_timer_start_once(_frameTimer, 0);
+  }
 }
 
 /**
 * @brief Clears all visual notifications.
 *
-* This function turns off all NeoPixels in the LED strip, effectively clearing any previous colors or patterns.
-* It can be used to reset the NeoPixel strip to its default state or turn off any active visual feedback.
+* This function stops the playing pattern and turns off all NeoPixels in the LED strip.
+* It returns immediately, the strip is updated by the frame timer.
 */
 void AudioVisualNotifications::clearAllVisualNotifications() {
-  _neoPixel.clear();
-  _neoPixel.show();
+  playVisualPattern(&offPattern);
+}
+
+/**
+* @brief Initializes the melody sequencer.
+*
+* This function starts the note timer that plays the audio notifications in the background.
+* It should be called once at the beginning of the program, melodies requested earlier are ignored.
+*/
+void AudioVisualNotifications::initializeAudioNotifications() {
+  // Every note re-arms a one-shot timer, the tone itself is generated by the LEDC peripheral.
+  const esp_timer_create_args_t timerArguments = {
+    .callback = &AudioVisualNotifications::onNoteTimer,
+    .arg = this,
+    .dispatch_method = ESP_TIMER_TASK,
+    .name = "AudioNotes",
+    .skip_unhandled_events = true
+  };
+
+  if (_noteTimer == NULL) {
+    esp_timer_create(&timerArguments, &_noteTimer);
+  }
 }
 
 /**
@@ -79,19 +236,11 @@ void AudioVisualNotifications::clearAllVisualNotifications() {
 *
 * This function plays a melody indicating the start of the device operation.
 * It can be used to provide auditory feedback when the device is powered on or initialized.
+*
+* @note The melody plays in the background after any melody already playing, this function returns immediately.
 */
 void AudioVisualNotifications::introAudioNotification() {
-  tone(_speakerPin, NOTE_E6);
-  delay(120);
-  noTone(_speakerPin);
-
-  tone(_speakerPin, NOTE_F6);
-  delay(120);
-  noTone(_speakerPin);
-
-  tone(_speakerPin, NOTE_G6);
-  delay(320);
-  noTone(_speakerPin);
+  playMelody(&introMelody, false);
 }
 
 /**
@@ -99,43 +248,11 @@ void AudioVisualNotifications::introAudioNotification() {
 *
 * This function plays a melody indicating that the device is in maintenance mode.
 * It can be used to provide auditory feedback when the device is undergoing maintenance or configuration changes.
+*
+* @note The melody interrupts the playing melody and plays in the background, this function returns immediately.
 */
 void AudioVisualNotifications::maintenanceAudioNotification() {
-  // First part.
-  tone(_speakerPin, NOTE_E6);
-  delay(120);
-  noTone(_speakerPin);
-
-  delay(80);
-
-  tone(_speakerPin, NOTE_E6);
-  delay(120);
-  noTone(_speakerPin);
-
-  delay(80);
-
-  tone(_speakerPin, NOTE_F6);
-  delay(120);
-  noTone(_speakerPin);
-
-  delay(80);
-
-  tone(_speakerPin, NOTE_G6);
-  delay(280);
-  noTone(_speakerPin);
-
-  // Second part.
-  tone(_speakerPin, NOTE_E6);
-  delay(120);
-  noTone(_speakerPin);
-
-  tone(_speakerPin, NOTE_F6);
-  delay(120);
-  noTone(_speakerPin);
-
-  tone(_speakerPin, NOTE_G6);
-  delay(320);
-  noTone(_speakerPin);
+  playMelody(&maintenanceMelody, true);
 }
 
 /**
@@ -143,55 +260,47 @@ void AudioVisualNotifications::maintenanceAudioNotification() {
 *
 * This function visually indicates that the device is not yet ready for operation
 * by alternating the color of the first two NeoPixels between red and black.
-* It can be used as part of the device initialization process or when certain conditions are not met for operation.
 *
-* @note This function alternates the color of the first two NeoPixels between red and black to indicate a not-ready state,
-*       pausing for a brief interval between color changes.
+* @note The pattern plays on the frame timer until another one is selected, this function returns immediately.
 */
 void AudioVisualNotifications::notReadyVisualNotification() {
-  uint32_t interval = 240;
-
-  _neoPixel.setPixelColor(0, _neoPixel.Color(255, 0, 0));
-  _neoPixel.setPixelColor(1, _neoPixel.Color(0, 0, 0));
-  _neoPixel.show();
-
-  delay(interval);
-
-  _neoPixel.setPixelColor(0, _neoPixel.Color(0, 0, 0));
-  _neoPixel.setPixelColor(1, _neoPixel.Color(255, 0, 0));
-  _neoPixel.show();
-
-  // clearNeoPixel();
-  delay(interval);
+  playVisualPattern(&notReadyPattern);
 }
 
 /**
 * @brief Displays a ready-to-send indication.
 *
 * This function visually indicates that the device is ready to send data or perform its main function
-* by blinking the first two NeoPixels in green color for a specified number of times in bursts.
-* It can be used to indicate that the device has completed its initialization process and is ready for operation.
+* by keeping the first two NeoPixels dark between the bursts of publishedVisualNotification().
 *
-* @param delayBeforeNextBurst The delay (in milliseconds) before starting the next burst of blinks.
-* @param blinkCount The number of times the NeoPixels should blink in one burst.
+* @note The pattern plays on the frame timer until another one is selected, this function returns immediately.
 */
 void AudioVisualNotifications::readyToSendVisualNotification() {
-  uint32_t delayBeforeNextBurst = 1200;
-  int blinkCount = 4;
-
-  // Loop through the specified number of blinks in one burst.
-  for (int i = 0; i < blinkCount; ++i) {
-    _neoPixel.setPixelColor(0, _neoPixel.Color(0, 255, 0));
-    _neoPixel.setPixelColor(1, _neoPixel.Color(0, 255, 0));
-    _neoPixel.show();
-
-    delay(40);
-    clearAllVisualNotifications();
-    delay(40);
-  }
+  playVisualPattern(&readyToSendPattern);
+}
+
+/**
+* @brief Displays a published indication.
+*
+* This function visually indicates that a position was published by blinking the first two NeoPixels
+* in green color four times, then returns to the selected pattern.
+*
+* @note The burst plays once on the frame timer over the selected pattern, this function returns immediately.
+*/
+void AudioVisualNotifications::publishedVisualNotification() {
+  playVisualOverlay(&publishedPattern);
+}
 
-  // Add a delay before starting the next burst.
-  delay(delayBeforeNextBurst);
+/**
+* @brief Displays a fix-lost indication.
+*
+* This function visually indicates that the GNSS fix was lost by blinking the first two NeoPixels
+* in red color twice, then returns to the selected pattern.
+*
+* @note The burst plays once on the frame timer over the selected pattern, this function returns immediately.
+*/
+void AudioVisualNotifications::fixLostVisualNotification() {
+  playVisualOverlay(&fixLostPattern);
 }
 
 /**
@@ -199,72 +308,271 @@ void AudioVisualNotifications::readyToSendVisualNotification() {
 *
 * This function visually indicates that the device is waiting to acquire a GNSS (Global Navigation Satellite System) fix
 * by alternating the color of the first two NeoPixels between blue and black.
-* It can be used in applications where GNSS data is required for operation and the device is waiting for a valid signal.
 *
-* @note This function alternates the color of the first two NeoPixels between blue and black to indicate a waiting state for a GNSS fix,
-*       pausing for a brief interval between color changes.
+* @note The pattern plays on the frame timer until another one is selected, this function returns immediately.
 */
 void AudioVisualNotifications::waitingGnssFixVisualNotification() {
-  uint32_t interval = 240;
-
-  _neoPixel.setPixelColor(0, _neoPixel.Color(0, 0, 255));
-  _neoPixel.setPixelColor(1, _neoPixel.Color(0, 0, 0));
-  _neoPixel.show();
-
-  delay(interval);
-
-  _neoPixel.setPixelColor(0, _neoPixel.Color(0, 0, 0));
-  _neoPixel.setPixelColor(1, _neoPixel.Color(0, 0, 255));
-  _neoPixel.show();
-
-  // clearNeoPixel();
-  delay(interval);
+  playVisualPattern(&waitingGnssFixPattern);
 }
 
 /**
 * @brief Displays a loading indication.
 *
 * This function visually indicates a loading state by alternating the color of the first two NeoPixels between magenta and black.
-* It can be used to provide visual feedback when the device is performing initialization or loading tasks.
 *
-* @note This function alternates the color of the first two NeoPixels between magenta and black to indicate a loading state,
-*       pausing for a brief interval between color changes.
+* @note The pattern plays on the frame timer until another one is selected, this function returns immediately.
 */
 void AudioVisualNotifications::loadingVisualNotification() {
-  uint32_t interval = 240;
+  playVisualPattern(&loadingPattern);
+}
 
-  _neoPixel.setPixelColor(0, _neoPixel.Color(255, 0, 255));
-  _neoPixel.setPixelColor(1, _neoPixel.Color(0, 0, 0));
-  _neoPixel.show();
+/**
+* @brief Displays a maintenance indication.
+*
+* This function visually indicates maintenance mode by blinking the first two NeoPixels in magenta color.
+*
+* @note The pattern plays on the frame timer until another one is selected, this function returns immediately.
+*/
+void AudioVisualNotifications::maintenanceVisualNotification() {
+  playVisualPattern(&maintenancePattern);
+}
+
+/**
+* @brief Queues a melody or lets it interrupt the playing one.
+*
+* @param melody The melody to play.
+* @param preempt If true, the playing melody is stopped and the waiting ones play afterwards.
+*/
+void AudioVisualNotifications::playMelody(const AudioMelody* melody, bool preempt) {
+  if (_noteTimer == NULL) {
+    return;
+  }
 
-  delay(interval);
+  bool isQueued = true;
+  bool startNow = true;
+
+  portENTER_CRITICAL(&audioLock);
+
+  if (_melodyCount == 0 || preempt) {
+    // Take the place of the playing melody.
+    _melodyQueue[0] = melody;
+    _melodyCount = max(_melodyCount, (uint8_t)1);
+    _noteIndex = 0;
+  } else if (_melodyCount < AUDIO_MELODY_QUEUE_LENGTH) {
+    // Wait behind the playing melody, the note timer is already running.
+    _melodyQueue[_melodyCount++] = melody;
+    startNow = false;
+  } else {
+    isQueued = false;
+  }
 
-  _neoPixel.setPixelColor(0, _neoPixel.Color(0, 0, 0));
-  _neoPixel.setPixelColor(1, _neoPixel.Color(255, 0, 255));
-  _neoPixel.show();
+  portEXIT_CRITICAL(&audioLock);
+
+  if (!isQueued) {
+    audioDroppedCount.increment();
+    return;
+  }
 
-  // clearNeoPixel();
-  delay(interval);
+  // Play the first note right away. The callback can re-arm the timer between the two calls, then try again.
+  if (startNow) {
+    do {
+      esp_timer_stop(_noteTimer);
+    } while (esp_timer_start_once(_noteTimer, 0) != ESP_OK);
+  }
 }
 
 /**
-* @brief Displays a maintenance indication.
+* @brief Note timer callback.
+*
+* @param argument The AudioVisualNotifications instance.
+*/
+void AudioVisualNotifications::onNoteTimer(void* argument) {
+  static_cast<AudioVisualNotifications*>(argument)->playNextNote();
+}
+
+/**
+* @brief Plays the next note of the queue and schedules the one after it.
+*/
+void AudioVisualNotifications::playNextNote() {
+  AudioNote note = { 0, 0 };
+  bool isMelodyStarted = false;
+  bool isQueueEmpty = false;
+
+  portENTER_CRITICAL(&audioLock);
+
+  // Move on to the next waiting melody once the playing one is done.
+  while (_melodyCount > 0 && _noteIndex >= _melodyQueue[0]->noteCount) {
+    for (uint8_t i = 1; i < _melodyCount; ++i) {
+      _melodyQueue[i - 1] = _melodyQueue[i];
+    }
+
+    _melodyCount--;
+    _noteIndex = 0;
+  }
+
+  if (_melodyCount == 0) {
+    isQueueEmpty = true;
+  } else {
+    isMelodyStarted = _noteIndex == 0;
+    note = _melodyQueue[0]->notes[_noteIndex++];
+  }
+
+  portEXIT_CRITICAL(&audioLock);
+
+  if (isQueueEmpty) {
+    stopTone();
+    return;
+  }
+
+  if (isMelodyStarted) {
+    audioNotificationCount.increment();
+  }
+
+  if (note.frequency != 0) {
+    startTone(note.frequency);
+  } else {
+    stopTone();
+  }
+
+  esp_timer_start_once(_noteTimer, (uint64_t)note.duration * 1000);
+}
+
+/**
+* @brief Selects the pattern to play and shows its first keyframe right away.
 *
-* This function visually indicates maintenance mode by illuminating the first two NeoPixels with magenta color.
-* It can be used to temporarily signal that the device is undergoing maintenance or configuration changes,
-* without actually setting the device to a specific mode.
+* @param pattern The pattern to play. Selecting the playing pattern again does nothing.
+*/
+void AudioVisualNotifications::playVisualPattern(const VisualPattern* pattern) {
+  if (_requestedPattern.exchange(pattern, std::memory_order_acq_rel) != pattern) {
+    restartFrameTimer();
+  }
+}
+
+/**
+* @brief Plays a pattern once over the selected one, starting right away.
 *
-* @note This function illuminates the first two NeoPixels with magenta color to indicate maintenance mode,
-*       pauses for a brief interval, then clears the NeoPixel strip.
+* @param pattern The pattern to play once. Every keyframe needs a duration.
 */
-void AudioVisualNotifications::maintenanceVisualNotification() {
-  uint32_t interval = 240;
+void AudioVisualNotifications::playVisualOverlay(const VisualPattern* pattern) {
+  _requestedOverlay.store(pattern, std::memory_order_release);
+  restartFrameTimer();
+}
+
+/**
+* @brief Shows the next keyframe right away, cutting the current one short.
+*/
+void AudioVisualNotifications::restartFrameTimer() {
+  if (_frameTimer == NULL) {
+    return;
+  }
+
+  // The callback can re-arm the timer between the two calls, then try again.
+  do {
+    esp_timer_stop(_frameTimer);
+  } while (esp_timer_start_once(_frameTimer, 0) != ESP_OK);
+}
 
-  _neoPixel.setPixelColor(0, _neoPixel.Color(255, 0, 255));
-  _neoPixel.setPixelColor(1, _neoPixel.Color(255, 0, 255));
+/**
+* @brief Frame timer callback.
+*
+* @param argument The AudioVisualNotifications instance.
+*/
+void AudioVisualNotifications::onFrameTimer(void* argument) {
+  static_cast<AudioVisualNotifications*>(argument)->renderVisualFrame();
+}
+
+/**
+* @brief Shows the next keyframe of the active overlay or pattern and schedules the one after it.
+*
+* The strip is only updated if a pixel color changes.
+*/
+void AudioVisualNotifications::renderVisualFrame() {
+  const VisualPattern* requested = _requestedPattern.load(std::memory_order_acquire);
+  const VisualPattern* overlay = _requestedOverlay.exchange(nullptr, std::memory_order_acq_rel);
+
+  if (requested != _activePattern) {
+    _activePattern = requested;
+    _frameIndex = 0;
+  }
+
+  // A new overlay restarts, even if the same one is still playing.
+  if (overlay != nullptr) {
+    _activeOverlay = overlay;
+    _overlayFrameIndex = 0;
+  }
+
+  const VisualKeyframe* frame = nullptr;
+
+  if (_activeOverlay != nullptr) {
+    // Play the overlay once, the selected pattern continues afterwards.
+    frame = &_activeOverlay->frames[_overlayFrameIndex++];
+
+    if (_overlayFrameIndex >= _activeOverlay->frameCount) {
+      _activeOverlay = nullptr;
+    }
+  } else if (_activePattern != nullptr) {
+    frame = &_activePattern->frames[_frameIndex];
+
+    // A held keyframe stays until another pattern is selected.
+    if (frame->duration != 0) {
+      _frameIndex = (_frameIndex + 1) % _activePattern->frameCount;
+    }
+  } else {
+    return;
+  }
+  bool isChanged = false;
+
+  for (uint8_t i = 0; i < VISUAL_KEYFRAME_PIXELS; ++i) {
+    if (_shownColors[i] != frame->colors[i]) {
+      _shownColors[i] = frame->colors[i];
+      _neoPixel.setPixelColor(i, frame->colors[i]);
+      isChanged = true;
+    }
+  }
+
+  if (isChanged) {
+    showVisualFrame();
+  }
+
+  if (frame->duration != 0) {
+    esp_timer_start_once(_frameTimer, (uint64_t)frame->duration * 1000);
+  }
+}
+
+/**
+* @brief Sends the current pixel colors to the NeoPixel LED strip.
+*
+* All visual notifications show their frames through this function, so that every
+* frame is counted and the LED on-time is accounted.
+*/
+void AudioVisualNotifications::showVisualFrame() {
   _neoPixel.show();
+  visualFrameCount.increment();
+
+  // Account the LEDs as on while any pixel is lit.
+  bool isLit = false;
+
+  for (uint16_t i = 0; i < _neoPixel.numPixels() && !isLit; ++i) {
+    isLit = _neoPixel.getPixelColor(i) != 0;
+  }
+
+  energySetState(ENERGY_LED, isLit ? ENERGY_LED_ON : ENERGY_LED_OFF);
+}
 
-  delay(interval);
-  clearAllVisualNotifications();
-  delay(interval);
-}
\ No newline at end of file
+/**
+* @brief Starts playing a tone on the speaker.
+*
+* @param frequency The tone frequency in hertz.
+*/
+void AudioVisualNotifications::startTone(unsigned int frequency) {
+  tone(_speakerPin, frequency);
+  energySetState(ENERGY_BUZZER, ENERGY_BUZZER_ON);
+}
+
+/**
+* @brief Stops the tone playing on the speaker.
+*/
+void AudioVisualNotifications::stopTone() {
+  noTone(_speakerPin);
+  energySetState(ENERGY_BUZZER, ENERGY_BUZZER_OFF);
+}
@@ -33,6 +33,8 @@
 
 #include "Arduino.h"
 #include "Adafruit_NeoPixel.h"
+#include "esp_timer.h"
+#include <atomic>
 
 // Define piano notes.
 #define NOTE_B0 31
@@ -125,6 +127,48 @@
 #define NOTE_D8 4699
 #define NOTE_DS8 4978
 
+// Number of pixels animated by the visual notification patterns.
+#define VISUAL_KEYFRAME_PIXELS 2
+
+// Number of melodies that can wait behind the playing one.
+#define AUDIO_MELODY_QUEUE_LENGTH 4
+
+/**
+* @struct AudioNote
+* @brief Single note of a melody.
+*/
+struct AudioNote {
+  uint16_t frequency;  // Tone frequency in hertz, 0 for a rest.
+  uint16_t duration;   // Time the note is held in milliseconds.
+};
+
+/**
+* @struct AudioMelody
+* @brief Sequence of notes played in order.
+*/
+struct AudioMelody {
+  const AudioNote* notes;  // Notes in playing order.
+  uint8_t noteCount;       // Number of notes.
+};
+
+/**
+* @struct VisualKeyframe
+* @brief Colors of the animated pixels and the time they are shown.
+*/
+struct VisualKeyframe {
+  uint32_t colors[VISUAL_KEYFRAME_PIXELS];  // Pixel colors as 0xRRGGBB, before brightness scaling.
+  uint16_t duration;                        // Time the frame is shown in milliseconds, 0 holds it.
+};
+
+/**
+* @struct VisualPattern
+* @brief Looping sequence of keyframes.
+*/
+struct VisualPattern {
+  const VisualKeyframe* frames;  // Keyframes in playing order.
+  uint8_t frameCount;            // Number of keyframes.
+};
+
 class AudioVisualNotifications {
 public:
   /**
@@ -144,24 +188,35 @@ public:
   * @brief Initializes the NeoPixel LED strip.
   *
   * This function initializes the NeoPixel LED strip with the specified pin and settings
-  * provided during the construction of the SensoryAlert object.
-  * It should be called once at the beginning of the program or whenever the NeoPixel strip needs to be re-initialized.
+  * provided during the construction of the SensoryAlert object, and starts the frame timer
+  * that plays the visual notification patterns. A pattern selected earlier starts playing now.
+  * It should be called once at the beginning of the program.
   */
   void initializeVisualNotifications();
 
   /**
   * @brief Clears all visual notifications.
   *
-  * This function turns off all NeoPixels in the LED strip, effectively clearing any previous colors or patterns.
-  * It can be used to reset the NeoPixel strip to its default state or turn off any active visual feedback.
+  * This function stops the playing pattern and turns off all NeoPixels in the LED strip.
+  * It returns immediately, the strip is updated by the frame timer.
   */
   void clearAllVisualNotifications();
 
+  /**
+  * @brief Initializes the melody sequencer.
+  *
+  * This function starts the note timer that plays the audio notifications in the background.
+  * It should be called once at the beginning of the program, melodies requested earlier are ignored.
+  */
+  void initializeAudioNotifications();
+
   /**
   * @brief Plays an introductory melody.
   *
   * This function plays a melody indicating the start of the device operation.
   * It can be used to provide auditory feedback when the device is powered on or initialized.
+  *
+  * @note The melody plays in the background after any melody already playing, this function returns immediately.
   */
   void introAudioNotification();
 
@@ -170,6 +225,8 @@ public:
   *
   * This function plays a melody indicating that the device is in maintenance mode.
   * It can be used to provide auditory feedback when the device is undergoing maintenance or configuration changes.
+  *
+  * @note The melody interrupts the playing melody and plays in the background, this function returns immediately.
   */
   void maintenanceAudioNotification();
 
@@ -178,10 +235,8 @@ public:
   *
   * This function visually indicates that the device is not yet ready for operation
   * by alternating the color of the first two NeoPixels between red and black.
-  * It can be used as part of the device initialization process or when certain conditions are not met for operation.
   *
-  * @note This function alternates the color of the first two NeoPixels between red and black to indicate a not-ready state,
-  *       pausing for a brief interval between color changes.
+  * @note The pattern plays on the frame timer until another one is selected, this function returns immediately.
   */
   void notReadyVisualNotification();
 
@@ -189,23 +244,39 @@ public:
   * @brief Displays a ready-to-send indication.
   *
   * This function visually indicates that the device is ready to send data or perform its main function
-  * by blinking the first two NeoPixels in green color for a specified number of times in bursts.
-  * It can be used to indicate that the device has completed its initialization process and is ready for operation.
+  * by keeping the first two NeoPixels dark between the bursts of publishedVisualNotification().
   *
-  * @param delayBeforeNextBurst The delay (in milliseconds) before starting the next burst of blinks.
-  * @param blinkCount The number of times the NeoPixels should blink in one burst.
+  * @note The pattern plays on the frame timer until another one is selected, this function returns immediately.
   */
   void readyToSendVisualNotification();
 
+  /**
+  * @brief Displays a published indication.
+  *
+  * This function visually indicates that a position was published by blinking the first two NeoPixels
+  * in green color four times, then returns to the selected pattern.
+  *
+  * @note The burst plays once on the frame timer over the selected pattern, this function returns immediately.
+  */
+  void publishedVisualNotification();
+
+  /**
+  * @brief Displays a fix-lost indication.
+  *
+  * This function visually indicates that the GNSS fix was lost by blinking the first two NeoPixels
+  * in red color twice, then returns to the selected pattern.
+  *
+  * @note The burst plays once on the frame timer over the selected pattern, this function returns immediately.
+  */
+  void fixLostVisualNotification();
+
   /**
   * @brief Displays a waiting for GNSS fix indication.
   *
   * This function visually indicates that the device is waiting to acquire a GNSS (Global Navigation Satellite System) fix
   * by alternating the color of the first two NeoPixels between blue and black.
-  * It can be used in applications where GNSS data is required for operation and the device is waiting for a valid signal.
   *
-  * @note This function alternates the color of the first two NeoPixels between blue and black to indicate a waiting state for a GNSS fix,
-  *       pausing for a brief interval between color changes.
+  * @note The pattern plays on the frame timer until another one is selected, this function returns immediately.
   */
   void waitingGnssFixVisualNotification();
 
@@ -213,22 +284,17 @@ public:
   * @brief Displays a loading indication.
   *
   * This function visually indicates a loading state by alternating the color of the first two NeoPixels between magenta and black.
-  * It can be used to provide visual feedback when the device is performing initialization or loading tasks.
   *
-  * @note This function alternates the color of the first two NeoPixels between magenta and black to indicate a loading state,
-  *       pausing for a brief interval between color changes.
+  * @note The pattern plays on the frame timer until another one is selected, this function returns immediately.
   */
   void loadingVisualNotification();
 
   /**
   * @brief Displays a maintenance indication.
   *
-  * This function visually indicates maintenance mode by illuminating the first two NeoPixels with magenta color.
-  * It can be used to temporarily signal that the device is undergoing maintenance or configuration changes,
-  * without actually setting the device to a specific mode.
+  * This function visually indicates maintenance mode by blinking the first two NeoPixels in magenta color.
   *
-  * @note This function illuminates the first two NeoPixels with magenta color to indicate maintenance mode,
-  *       pauses for a brief interval, then clears the NeoPixel strip.
+  * @note The pattern plays on the frame timer until another one is selected, this function returns immediately.
   */
   void maintenanceVisualNotification();
 
@@ -238,6 +304,92 @@ private:
   int _neoPixelBrightness;
   int _speakerPin;
   Adafruit_NeoPixel _neoPixel;  // Declare neoPixel as a member variable
+
+  // Keyframe animation state. Only the frame timer callback touches the pixels.
+  esp_timer_handle_t _frameTimer;
+  std::atomic<const VisualPattern*> _requestedPattern;  // Pattern selected by the caller.
+  std::atomic<const VisualPattern*> _requestedOverlay;  // One-shot pattern requested by the caller, taken by the frame timer.
+  const VisualPattern* _activePattern;                  // Pattern being played by the frame timer.
+  const VisualPattern* _activeOverlay;                  // One-shot pattern being played over it, or nullptr.
+  uint8_t _frameIndex;                                  // Keyframe of the active pattern shown next.
+  uint8_t _overlayFrameIndex;                           // Keyframe of the active overlay shown next.
+  uint32_t _shownColors[VISUAL_KEYFRAME_PIXELS];        // Colors last sent to the strip.
+
+  // Melody sequencer state, shared with the note timer callback under the audio lock.
+  esp_timer_handle_t _noteTimer;
+  const AudioMelody* _melodyQueue[AUDIO_MELODY_QUEUE_LENGTH];  // Playing melody first, then the waiting ones.
+  uint8_t _melodyCount;                                        // Number of melodies in the queue.
+  uint8_t _noteIndex;                                          // Note of the playing melody played next.
+
+  /**
+  * @brief Queues a melody or lets it interrupt the playing one.
+  *
+  * @param melody The melody to play.
+  * @param preempt If true, the playing melody is stopped and the waiting ones play afterwards.
+  */
+  void playMelody(const AudioMelody* melody, bool preempt);
+
+  /**
+  * @brief Note timer callback.
+  *
+  * @param argument The AudioVisualNotifications instance.
+  */
+  static void onNoteTimer(void* argument);
+
+  /**
+  * @brief Plays the next note of the queue and schedules the one after it.
+  */
+  void playNextNote();
+
+  /**
+  * @brief Selects the pattern to play and shows its first keyframe right away.
+  *
+  * @param pattern The pattern to play. Selecting the playing pattern again does nothing.
+  */
+  void playVisualPattern(const VisualPattern* pattern);
+
+  /**
+  * @brief Plays a pattern once over the selected one, starting right away.
+  *
+  * @param pattern The pattern to play once. Every keyframe needs a duration.
+  */
+  void playVisualOverlay(const VisualPattern* pattern);
+
+  /**
+  * @brief Shows the next keyframe right away, cutting the current one short.
+  */
+  void restartFrameTimer();
+
+  /**
+  * @brief Frame timer callback.
+  *
+  * @param argument The AudioVisualNotifications instance.
+  */
+  static void onFrameTimer(void* argument);
+
+  /**
+  * @brief Shows the next keyframe of the active overlay or pattern and schedules the one after it.
+  *
+  * The strip is only updated if a pixel color changes.
+  */
+  void renderVisualFrame();
+
+  /**
+  * @brief Sends the current pixel colors to the NeoPixel LED strip.
+  */
+  void showVisualFrame();
+
+  /**
+  * @brief Starts playing a tone on the speaker.
+  *
+  * @param frequency The tone frequency in hertz.
+  */
+  void startTone(unsigned int frequency);
+
+  /**
+  * @brief Stops the tone playing on the speaker.
+  */
+  void stopTone();
 };
 
 #endif
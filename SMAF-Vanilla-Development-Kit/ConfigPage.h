@@ -0,0 +1,273 @@
+/**
+* @file ConfigPage.h
+* @brief Gzip-compressed configuration page for Arduino project.
+*
+* This file is generated by tools/smaf_config_page.py from tools/config_page.html.
+* Do not edit it by hand. The page is 11503 bytes, 3702 bytes compressed.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#ifndef CONFIG_PAGE_H
+#define CONFIG_PAGE_H
+
+#include "Arduino.h"
+
+// Entity tag of the page, changes with every change of the page.
+#define CONFIG_PAGE_ETAG "\"7513bd1b7ed1432d\""
+
+// Compressed page, stays in flash.
+static const uint8_t configPageGzip[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xad, 0x5a, 0x59, 0x73, 0xdb, 0x46,
+  0x12, 0x7e, 0xd7, 0xaf, 0x18, 0xa3, 0x2a, 0x09, 0x95, 0x08, 0x10, 0x49, 0x89, 0xb2, 0x4d, 0x8a,
+  0x72, 0x39, 0x3e, 0x76, 0xb3, 0x49, 0xbc, 0x8e, 0xa5, 0x6c, 0x2a, 0xe5, 0xd2, 0x03, 0x08, 0x0c,
+  0x89, 0x89, 0x40, 0x00, 0x8b, 0x19, 0x48, 0xa2, 0x15, 0xfd, 0x90, 0x7d, 0xda, 0x97, 0xfd, 0x81,
+  0xfb, 0x13, 0xb6, 0xbb, 0xe7, 0x20, 0x2e, 0x4a, 0x4e, 0x6a, 0xcb, 0xa5, 0x83, 0x33, 0x3d, 0x7d,
+  0x7e, 0xd3, 0xc7, 0xc8, 0xa7, 0x4f, 0x5e, 0xff, 0xfd, 0xd5, 0xc5, 0xaf, 0xef, 0xdf, 0xb0, 0x44,
+  0xad, 0xd3, 0xb3, 0xbd, 0x53, 0xfc, 0xc1, 0xd2, 0x30, 0x5b, 0xcd, 0x3d, 0x9e, 0x79, 0xb8, 0xc0,
+  0xc3, 0x18, 0x7e, 0xac, 0xb9, 0x0a, 0x59, 0x94, 0x84, 0xa5, 0xe4, 0x6a, 0xee, 0xfd, 0x7c, 0xf1,
+  0xd6, 0x7f, 0xe6, 0x9d, 0xe9, 0xd5, 0x2c, 0x5c, 0xf3, 0xb9, 0x77, 0x2d, 0xf8, 0x4d, 0x91, 0x97,
+  0xca, 0x63, 0x51, 0x9e, 0x29, 0x9e, 0x01, 0xd5, 0x8d, 0x88, 0x55, 0x32, 0x8f, 0xf9, 0xb5, 0x88,
+  0xb8, 0x4f, 0x1f, 0x0e, 0x98, 0xc8, 0x84, 0x12, 0x61, 0xea, 0xcb, 0x28, 0x4c, 0xf9, 0x7c, 0x14,
+  0x0c, 0x0f, 0x58, 0x25, 0x79, 0x49, 0x9f, 0xc3, 0x05, 0x2c, 0x65, 0x39, 0x4a, 0x55, 0x42, 0xa5,
+  0xfc, 0xec, 0xfc, 0xc7, 0x97, 0x6f, 0xfd, 0xd7, 0xdf, 0xfb, 0xe7, 0x2f, 0xdf, 0x9f, 0x1e, 0xea,
+  0xa5, 0xbd, 0x53, 0xa9, 0x36, 0xf8, 0x73, 0x5a, 0xe6, 0xb9, 0x62, 0x77, 0x7b, 0xbe, 0xbf, 0xce,
+  0xb3, 0x3c, 0x4a, 0xca, 0x7c, 0xcd, 0xfd, 0xd1, 0x70, 0x38, 0x65, 0x89, 0x4c, 0x07, 0xe3, 0x11,
+  0x30, 0x1e, 0x0d, 0xbf, 0xa0, 0x6f, 0xfb, 0x33, 0xd6, 0xa4, 0x1a, 0x4f, 0xda, 0x54, 0x93, 0x1e,
+  0xaa, 0x49, 0x87, 0xd7, 0xd3, 0x2e, 0xd5, 0xb8, 0x2b, 0xf1, 0xd9, 0xa4, 0x4b, 0xd5, 0xe5, 0xf5,
+  0xbc, 0x4b, 0x75, 0x64, 0x79, 0x01, 0x8d, 0x56, 0x1d, 0xe5, 0x81, 0x85, 0x22, 0x5b, 0xe6, 0x7e,
+  0x8b, 0x05, 0x12, 0x8c, 0x8d, 0x3e, 0xb4, 0xff, 0x74, 0xd2, 0xd9, 0x3f, 0x9a, 0xd4, 0xf6, 0xdb,
+  0xbe, 0xa9, 0x9b, 0x4d, 0x04, 0xe3, 0x1e, 0x02, 0xd2, 0x12, 0x34, 0x90, 0x55, 0x14, 0x71, 0x29,
+  0x9d, 0x12, 0xa3, 0x23, 0x47, 0x32, 0x32, 0x42, 0x2c, 0x89, 0xd5, 0xa3, 0x46, 0x32, 0x6e, 0x91,
+  0x38, 0x55, 0x6a, 0x34, 0xc7, 0xc3, 0x26, 0xcd, 0xb8, 0x87, 0xc6, 0x6a, 0xc3, 0xcb, 0x32, 0x2f,
+  0x9d, 0x2e, 0x5b, 0x31, 0xc7, 0x9a, 0x85, 0xde, 0xb6, 0x7a, 0x74, 0xbc, 0xa1, 0xb7, 0x47, 0xc3,
+  0xf6, 0xf1, 0x93, 0x61, 0x7d, 0x7f, 0xdc, 0xd9, 0x7f, 0xfe, 0x14, 0xa5, 0xdf, 0xef, 0x7d, 0xcd,
+  0xee, 0x96, 0x00, 0x71, 0x7f, 0x19, 0xae, 0x45, 0xba, 0x99, 0x32, 0xb9, 0x91, 0x8a, 0xaf, 0xfd,
+  0x4a, 0x1c, 0x30, 0x19, 0x66, 0xd2, 0x07, 0x38, 0x8b, 0xe5, 0x8c, 0x11, 0x8d, 0x14, 0x9f, 0xf8,
+  0x94, 0x8d, 0x4e, 0x8a, 0xdb, 0x19, 0x4b, 0x45, 0xc6, 0xfd, 0x84, 0x8b, 0x55, 0xa2, 0x60, 0x29,
+  0x98, 0xcc, 0xe0, 0xa6, 0xa4, 0x79, 0x39, 0x65, 0xd7, 0x61, 0x39, 0x68, 0xc3, 0x18, 0x34, 0x59,
+  0x87, 0xe5, 0x4a, 0x64, 0x53, 0x36, 0x9c, 0xb1, 0x22, 0x8c, 0x63, 0x91, 0xad, 0xe8, 0xf7, 0x45,
+  0x7e, 0x8b, 0x6c, 0xe9, 0xe3, 0x22, 0x2f, 0x63, 0xb8, 0x3c, 0xb0, 0x34, 0x63, 0x79, 0xa5, 0x50,
+  0xc2, 0x94, 0x65, 0x79, 0xc6, 0x51, 0x9a, 0x04, 0xf1, 0x78, 0x57, 0xec, 0xca, 0x0d, 0x10, 0xfb,
+  0x37, 0x65, 0x58, 0xc0, 0xb9, 0x92, 0x87, 0x57, 0x3e, 0x2e, 0x48, 0xd0, 0xa2, 0x2a, 0x25, 0xaa,
+  0x11, 0xf3, 0x65, 0x58, 0xa5, 0x6a, 0x76, 0xbf, 0xb7, 0xc8, 0xe3, 0x0d, 0xbb, 0x8b, 0x85, 0x2c,
+  0xd2, 0x10, 0x0c, 0x5c, 0xa6, 0xfc, 0x76, 0x86, 0xdf, 0xfc, 0x58, 0x94, 0x3c, 0x52, 0x22, 0x07,
+  0xad, 0x40, 0xf7, 0x6a, 0x9d, 0xe9, 0x65, 0xcd, 0x34, 0xcb, 0xf1, 0xe7, 0x2c, 0x4c, 0xc5, 0x2a,
+  0xf3, 0x05, 0xb8, 0x44, 0x02, 0x15, 0x24, 0x02, 0x5e, 0xce, 0x9c, 0xfe, 0x60, 0x76, 0xc9, 0xd7,
+  0xf6, 0xc7, 0x33, 0xf8, 0x06, 0xe2, 0x92, 0xd1, 0x01, 0x4b, 0xc6, 0xf0, 0x75, 0x04, 0x5f, 0xc7,
+  0xf0, 0x35, 0x81, 0xaf, 0x13, 0x76, 0x67, 0xdc, 0x23, 0xb2, 0x04, 0x3c, 0xaa, 0x3a, 0x0e, 0x1c,
+  0x4d, 0xac, 0x8f, 0x7c, 0x95, 0x83, 0xfc, 0x23, 0x62, 0xea, 0xd6, 0x16, 0xb9, 0x52, 0xf9, 0x1a,
+  0x08, 0x69, 0x91, 0xa2, 0x71, 0x63, 0xce, 0x3e, 0x1d, 0x82, 0x1f, 0x53, 0xae, 0x14, 0x26, 0x9e,
+  0x22, 0x8c, 0x48, 0x35, 0x7f, 0x18, 0x8c, 0x8b, 0x5b, 0xd4, 0xc6, 0xc4, 0x57, 0xc7, 0x6e, 0x1c,
+  0x0c, 0xc7, 0x4f, 0xfb, 0x59, 0x00, 0xed, 0xb8, 0x41, 0x3b, 0x0a, 0x9e, 0x0d, 0xc7, 0xc6, 0xa6,
+  0xa3, 0xd6, 0xce, 0x89, 0xdb, 0x39, 0x6e, 0xed, 0x1c, 0x8f, 0x8f, 0xcd, 0xce, 0xa4, 0xb5, 0x33,
+  0x3e, 0x39, 0xe9, 0xb3, 0x68, 0xa8, 0x0d, 0x85, 0x03, 0x27, 0xad, 0x03, 0x90, 0xd9, 0x1e, 0x3c,
+  0x50, 0x74, 0x9d, 0x5a, 0xf7, 0xe0, 0x68, 0xa7, 0xff, 0xee, 0xf7, 0x20, 0x3b, 0xf3, 0xd4, 0x88,
+  0xb3, 0x4e, 0x98, 0x90, 0x13, 0x96, 0x79, 0xb9, 0x66, 0x77, 0xeb, 0xf0, 0x56, 0xe7, 0xf8, 0x29,
+  0x3b, 0x3e, 0x19, 0x02, 0xde, 0xef, 0xf7, 0x44, 0x56, 0x54, 0xea, 0xa3, 0xda, 0x14, 0x7c, 0xfe,
+  0x95, 0xe2, 0xb7, 0xea, 0xab, 0x4b, 0xcc, 0xff, 0xdb, 0x35, 0x59, 0x2d, 0xd6, 0xa2, 0xb3, 0x5a,
+  0x72, 0x28, 0x31, 0xb8, 0x28, 0x79, 0x0a, 0x60, 0x6b, 0x6e, 0x46, 0x09, 0x8f, 0xae, 0x00, 0xee,
+  0xb8, 0xbf, 0xa8, 0x40, 0xc1, 0x8c, 0xdd, 0x85, 0x69, 0x3a, 0x65, 0x55, 0x06, 0xa7, 0x76, 0xc8,
+  0xd4, 0x8c, 0x5a, 0xb7, 0x16, 0xaf, 0x1b, 0xc6, 0x9e, 0x37, 0x6f, 0xed, 0xf6, 0xa6, 0x05, 0x4f,
+  0x35, 0x54, 0xc9, 0x27, 0x74, 0xe9, 0x92, 0x30, 0xce, 0x6f, 0x60, 0x87, 0xfe, 0x8d, 0x8a, 0xdb,
+  0xee, 0xc5, 0x85, 0xa4, 0xb1, 0x0f, 0xfa, 0xa2, 0x2a, 0xee, 0x5a, 0xa1, 0x16, 0xbd, 0x8a, 0x4d,
+  0x93, 0xfc, 0x9a, 0x97, 0x56, 0x3d, 0xfd, 0x89, 0xdd, 0x75, 0x25, 0x8d, 0x1f, 0x91, 0xd4, 0xcb,
+  0x7b, 0x99, 0x47, 0x95, 0x74, 0xbc, 0xe9, 0xd3, 0xc3, 0xbc, 0x6d, 0x8d, 0xe8, 0xe7, 0xfa, 0x48,
+  0xa8, 0x6c, 0x28, 0x3a, 0xe8, 0x70, 0x5e, 0x28, 0x72, 0x41, 0x99, 0x60, 0xeb, 0xe0, 0xd1, 0x36,
+  0x11, 0xcc, 0x28, 0xc5, 0xf8, 0xab, 0x12, 0x15, 0x1b, 0xcf, 0xc8, 0x65, 0x3e, 0xe5, 0x11, 0x97,
+  0x41, 0xfa, 0xd5, 0x01, 0x93, 0xc2, 0xe8, 0x0a, 0xce, 0x55, 0x59, 0x3c, 0x6d, 0x1b, 0xb2, 0x3b,
+  0xbf, 0x1e, 0xe1, 0x6e, 0x93, 0x63, 0xc7, 0x94, 0x3f, 0x11, 0x71, 0x32, 0x42, 0x26, 0xa5, 0xc8,
+  0xae, 0xc8, 0x8c, 0x9a, 0x51, 0xa3, 0x1d, 0x06, 0xb8, 0xa8, 0xf7, 0x9b, 0xf1, 0x74, 0xb2, 0xbf,
+  0xeb, 0x60, 0x08, 0x79, 0xf8, 0x9a, 0xef, 0x3c, 0x39, 0xd9, 0x65, 0xa1, 0x45, 0x9d, 0xb6, 0xf3,
+  0xff, 0x85, 0x3a, 0xcb, 0x5c, 0x6b, 0xe5, 0xb8, 0x3b, 0x25, 0xff, 0x30, 0x7b, 0xd6, 0xb5, 0xab,
+  0xd9, 0x4f, 0xa1, 0x79, 0x41, 0x92, 0x97, 0xe2, 0x13, 0x60, 0x0e, 0x1a, 0xca, 0x65, 0x09, 0x6d,
+  0x68, 0xbb, 0x68, 0xb1, 0x5a, 0x79, 0xa2, 0xe2, 0xc4, 0xda, 0x65, 0x0c, 0xa2, 0x33, 0x63, 0x2b,
+  0xdc, 0x87, 0x5e, 0xb4, 0x9e, 0xfe, 0x74, 0x42, 0xd4, 0x6b, 0xf7, 0x7b, 0x52, 0xd3, 0xa3, 0x25,
+  0x54, 0x71, 0x53, 0xbe, 0x04, 0x84, 0x1f, 0x81, 0x11, 0x32, 0x4f, 0x45, 0xdc, 0x85, 0xde, 0x8e,
+  0xb0, 0x8c, 0xbb, 0xb8, 0x74, 0xe1, 0xea, 0x5c, 0x8d, 0x46, 0x32, 0x77, 0xb5, 0xb3, 0xa9, 0x51,
+  0x60, 0xfa, 0xa5, 0x47, 0x34, 0xab, 0x75, 0x5e, 0xbd, 0xca, 0xd5, 0xba, 0xae, 0xb6, 0x7e, 0xdb,
+  0xd6, 0x6f, 0xbf, 0x26, 0x96, 0x9a, 0xa4, 0x47, 0x84, 0xba, 0x46, 0xab, 0x57, 0xa4, 0x6b, 0xb3,
+  0xda, 0x02, 0x6d, 0x77, 0x57, 0x13, 0xc7, 0x0a, 0x2c, 0x30, 0x7d, 0xed, 0xd0, 0x96, 0x04, 0x8b,
+  0x61, 0x3d, 0x76, 0xb8, 0xf7, 0x31, 0x11, 0x71, 0xcc, 0xb3, 0xcb, 0x1a, 0x2e, 0xb0, 0x17, 0x62,
+  0x4f, 0xc4, 0x1a, 0x67, 0x95, 0x30, 0x43, 0x1c, 0x07, 0x0f, 0x40, 0xa7, 0xdb, 0xf0, 0x58, 0xb0,
+  0x4c, 0x7a, 0xc0, 0x62, 0xaa, 0x6c, 0x40, 0x37, 0xc3, 0xff, 0x13, 0x6c, 0x87, 0x26, 0xe6, 0xc0,
+  0xc3, 0x56, 0xba, 0xcf, 0x64, 0x43, 0x38, 0xfe, 0xad, 0x92, 0x4a, 0x2c, 0x37, 0xbe, 0x99, 0xc0,
+  0xa0, 0x35, 0xc5, 0x02, 0xe7, 0x2f, 0xb8, 0xba, 0xe1, 0x1c, 0x64, 0xe8, 0xd6, 0xcc, 0xed, 0x9a,
+  0xd4, 0xca, 0xfa, 0x3a, 0x36, 0xab, 0x8f, 0x55, 0x47, 0xde, 0x08, 0x15, 0x25, 0xec, 0xae, 0xc8,
+  0xa5, 0x30, 0x12, 0x79, 0x1a, 0xe2, 0xed, 0x9e, 0xb1, 0x3e, 0xd5, 0x6c, 0x1a, 0x84, 0x68, 0xd9,
+  0xae, 0x00, 0x9b, 0x02, 0x66, 0xdb, 0xb7, 0xf1, 0x31, 0xb5, 0x08, 0x81, 0x2a, 0x01, 0x18, 0xd0,
+  0x95, 0xb4, 0xcb, 0x44, 0x8b, 0x67, 0xc7, 0x32, 0x2d, 0x44, 0x85, 0xa5, 0xda, 0xa1, 0xff, 0x16,
+  0x70, 0xfe, 0xae, 0x32, 0xa0, 0xb1, 0xd7, 0xcd, 0x4d, 0x47, 0xbb, 0x72, 0x93, 0xb3, 0x05, 0x07,
+  0x82, 0xad, 0x2d, 0xfa, 0x93, 0xb9, 0x0a, 0x65, 0x18, 0x8b, 0x4a, 0xd2, 0x62, 0xcd, 0xc2, 0x6e,
+  0x9e, 0xdf, 0xa9, 0xd5, 0x68, 0xf2, 0x07, 0xb4, 0x1a, 0x99, 0x44, 0xa8, 0x85, 0x74, 0x6b, 0xc2,
+  0x6e, 0x29, 0xe3, 0xc9, 0x1f, 0x90, 0x32, 0x9e, 0x68, 0x29, 0x49, 0xb5, 0x5e, 0x74, 0xa0, 0xd8,
+  0x89, 0xcd, 0x83, 0xb8, 0x32, 0x1e, 0xa4, 0xf8, 0x37, 0xd1, 0x60, 0x83, 0xef, 0xf3, 0x6b, 0xa0,
+  0x95, 0x76, 0x6c, 0xe9, 0xfa, 0xf5, 0x8b, 0x3e, 0xc5, 0x9f, 0x07, 0x93, 0x3e, 0xd5, 0x8f, 0x3a,
+  0x15, 0x6b, 0x4a, 0x37, 0x8b, 0xc7, 0xec, 0x1b, 0x66, 0xd1, 0xb7, 0xcb, 0x5f, 0xf5, 0x7c, 0xfe,
+  0x80, 0xa7, 0x6a, 0x64, 0xfd, 0x38, 0xe5, 0x59, 0xbc, 0x53, 0xfa, 0x63, 0xc8, 0x70, 0x7d, 0xc0,
+  0xe3, 0x2a, 0xd4, 0xba, 0x85, 0xae, 0x98, 0xc7, 0xb0, 0xb1, 0x2d, 0x43, 0x8f, 0xca, 0xb1, 0xc5,
+  0x77, 0xe4, 0xa3, 0xea, 0xa5, 0x88, 0x79, 0x33, 0xf3, 0x8e, 0x76, 0x0c, 0x62, 0x2e, 0x99, 0x2c,
+  0xc3, 0x2b, 0xee, 0xc3, 0x34, 0x07, 0xae, 0xa7, 0x56, 0x2f, 0xe6, 0x51, 0x5e, 0x86, 0x3a, 0xad,
+  0x80, 0x62, 0xbc, 0xc4, 0x49, 0xaf, 0xaf, 0x4c, 0x6a, 0x27, 0x3f, 0xde, 0x65, 0xde, 0xef, 0x41,
+  0xa1, 0xac, 0x0f, 0x06, 0x7d, 0x15, 0x66, 0x07, 0xb3, 0xfb, 0xbd, 0xd3, 0x43, 0xf3, 0xc6, 0x74,
+  0x7a, 0x68, 0x5e, 0xbf, 0x70, 0x20, 0x86, 0x1f, 0x34, 0xe9, 0x84, 0x94, 0x71, 0xe7, 0xde, 0x21,
+  0xc4, 0x78, 0x29, 0x56, 0x95, 0x56, 0xdc, 0x63, 0x6b, 0xae, 0x92, 0x3c, 0x9e, 0x7b, 0x2b, 0xae,
+  0xe8, 0xdd, 0x6c, 0x74, 0xf6, 0xdf, 0x7f, 0xff, 0xe7, 0x5f, 0xc0, 0x62, 0x44, 0x9f, 0x58, 0x94,
+  0x86, 0x52, 0xce, 0xbd, 0x9a, 0xd7, 0xbc, 0xb3, 0x0f, 0xc0, 0x7e, 0xc3, 0x54, 0xce, 0xaa, 0x22,
+  0x0e, 0x15, 0x3f, 0x5d, 0x94, 0x67, 0x9b, 0xbc, 0x2a, 0xa1, 0x6d, 0x57, 0x0a, 0x0a, 0x9c, 0x7c,
+  0x61, 0x8e, 0x17, 0x67, 0xbf, 0xf0, 0x34, 0x02, 0x3c, 0x23, 0x2d, 0xbe, 0x8a, 0xb1, 0x57, 0x24,
+  0x9c, 0xfd, 0xb5, 0x5a, 0x3c, 0x61, 0x3f, 0x55, 0x22, 0xba, 0x4a, 0x37, 0x78, 0x0a, 0x18, 0x31,
+  0xe2, 0x40, 0x44, 0xfa, 0xe9, 0x0d, 0xcf, 0x80, 0xae, 0x19, 0xce, 0x40, 0xd7, 0x22, 0x64, 0xbf,
+  0x88, 0xb7, 0x82, 0x85, 0x59, 0xcc, 0x00, 0x18, 0x99, 0x84, 0x6e, 0x92, 0x81, 0xec, 0x90, 0x55,
+  0x12, 0x24, 0xb2, 0x1f, 0x7f, 0xba, 0xb8, 0x08, 0x4e, 0x0f, 0x0b, 0x7c, 0x68, 0x33, 0x85, 0x55,
+  0x80, 0x51, 0x32, 0xbc, 0xe6, 0xb1, 0x67, 0x6d, 0x30, 0x2d, 0x81, 0xc7, 0x74, 0x79, 0x45, 0xfb,
+  0x4e, 0xce, 0xce, 0xf5, 0xe2, 0x13, 0x50, 0xf9, 0x84, 0x54, 0xfe, 0xb5, 0xad, 0x47, 0x12, 0x4a,
+  0x66, 0x8e, 0x2e, 0xab, 0x14, 0x14, 0x0e, 0x17, 0x10, 0xb5, 0x05, 0xa0, 0x54, 0x25, 0x9c, 0x65,
+  0xfc, 0x86, 0x35, 0x5c, 0x1a, 0xb0, 0xef, 0xd4, 0x57, 0x12, 0x9f, 0x15, 0x20, 0x93, 0xa4, 0x64,
+  0x1d, 0x58, 0x52, 0xe6, 0x70, 0x63, 0x51, 0xfb, 0x32, 0x87, 0x45, 0xa8, 0x4a, 0x09, 0x9d, 0xd6,
+  0x0e, 0x8c, 0x9d, 0xe7, 0x8c, 0x0d, 0x87, 0xc6, 0x88, 0x96, 0x39, 0xcb, 0x50, 0xa4, 0x35, 0x7b,
+  0x08, 0x0f, 0x4d, 0x6b, 0x5e, 0x6b, 0x95, 0xb3, 0x5c, 0x41, 0xa1, 0x0b, 0xa3, 0x04, 0xdf, 0x26,
+  0x9d, 0x65, 0x17, 0x20, 0x10, 0x20, 0x57, 0xc2, 0x0d, 0x77, 0x02, 0x41, 0xf7, 0x2a, 0x8d, 0xe9,
+  0xc0, 0x82, 0xb3, 0x34, 0x0f, 0x63, 0x1e, 0x07, 0xec, 0x03, 0xc7, 0xdf, 0x48, 0xc3, 0x22, 0x5c,
+  0x71, 0x96, 0x67, 0x18, 0x0f, 0xf8, 0x64, 0x5c, 0x22, 0x24, 0x15, 0xaa, 0xae, 0xb6, 0xc9, 0xf1,
+  0x19, 0xc5, 0x09, 0x6e, 0x2a, 0x00, 0x1a, 0x81, 0xd1, 0xf0, 0x0d, 0xa8, 0x72, 0x4c, 0xaa, 0x9c,
+  0x73, 0x50, 0x84, 0xdb, 0xf8, 0x8a, 0x6b, 0xa1, 0x36, 0x6c, 0xb1, 0x61, 0x94, 0x6c, 0x31, 0x9e,
+  0x04, 0x06, 0xe2, 0x14, 0x73, 0x05, 0x56, 0x4b, 0xe6, 0xb3, 0xf3, 0xf3, 0xef, 0x5e, 0x93, 0x0b,
+  0x0b, 0xb0, 0x1e, 0x1f, 0x81, 0x02, 0x1d, 0x26, 0x28, 0xa7, 0x1b, 0x89, 0xaf, 0x2c, 0x98, 0x38,
+  0xc0, 0xd5, 0x3a, 0x2a, 0x0a, 0x28, 0xae, 0xe0, 0x9a, 0x20, 0x2a, 0xc3, 0x75, 0x8a, 0xbd, 0x66,
+  0x5e, 0x70, 0x13, 0x22, 0xad, 0x77, 0x61, 0x1d, 0xe9, 0x2e, 0xb6, 0x47, 0x6e, 0x2e, 0xf9, 0x12,
+  0x06, 0x83, 0xc4, 0x43, 0xb3, 0x53, 0xc0, 0xa8, 0x5b, 0x39, 0x8f, 0xc2, 0x6c, 0xb0, 0x8f, 0xf8,
+  0xa7, 0x8f, 0x4e, 0x0a, 0x3e, 0x5a, 0x69, 0x96, 0xb1, 0xb8, 0x76, 0x4c, 0xb1, 0x01, 0xd2, 0x0c,
+  0x8d, 0x7f, 0xfc, 0xa1, 0x77, 0x76, 0x7a, 0x08, 0x24, 0xda, 0x51, 0x88, 0x59, 0x50, 0xae, 0xbc,
+  0x7e, 0xc8, 0x51, 0x17, 0x55, 0x86, 0x6e, 0x5a, 0xaf, 0xab, 0x4c, 0x44, 0xb4, 0xa5, 0xc1, 0x53,
+  0x3b, 0xbc, 0x05, 0x0f, 0x7b, 0x83, 0xfe, 0x23, 0x07, 0x2c, 0xca, 0xfc, 0x8a, 0x97, 0x80, 0x43,
+  0xe8, 0x39, 0x41, 0x57, 0x98, 0xa9, 0xb1, 0x73, 0x3c, 0x20, 0xff, 0x85, 0x15, 0x50, 0x64, 0xca,
+  0xf2, 0xb3, 0x1e, 0x46, 0x5f, 0x85, 0x10, 0xb9, 0x05, 0x14, 0x03, 0x17, 0x19, 0xe7, 0xac, 0x87,
+  0x2d, 0x1b, 0x75, 0x2d, 0x03, 0xd7, 0x21, 0xd0, 0xbe, 0x0c, 0xd7, 0x30, 0xbf, 0x40, 0x82, 0x15,
+  0xd1, 0x6e, 0x2b, 0xdf, 0x73, 0x48, 0x84, 0x19, 0x14, 0xde, 0x4f, 0xdc, 0x5a, 0x66, 0xe0, 0x89,
+  0x4a, 0x51, 0x94, 0x01, 0x1d, 0x31, 0x5f, 0x8a, 0x0c, 0xd1, 0x61, 0x58, 0xcb, 0x82, 0x47, 0x62,
+  0x29, 0x22, 0x49, 0x56, 0x45, 0x49, 0x9e, 0x53, 0x2e, 0x08, 0x33, 0x88, 0xb4, 0x12, 0xeb, 0x30,
+  0xd5, 0x62, 0x01, 0x26, 0x16, 0x01, 0x4d, 0x47, 0x02, 0x8a, 0xb1, 0xf0, 0x81, 0xd1, 0x14, 0x66,
+  0x16, 0xde, 0x84, 0x9b, 0xcf, 0xb2, 0x76, 0xdc, 0xb0, 0xf6, 0x65, 0x15, 0x8b, 0xfc, 0xf0, 0x1f,
+  0x42, 0x56, 0x61, 0x8a, 0x26, 0xc2, 0x5d, 0x42, 0xad, 0x48, 0x86, 0x74, 0x26, 0x52, 0x5a, 0xd9,
+  0x5e, 0x1f, 0xfe, 0xcf, 0x4a, 0x14, 0x05, 0x00, 0x96, 0xa2, 0x19, 0xc2, 0xe4, 0xf9, 0xe9, 0x13,
+  0x84, 0x8e, 0xf2, 0xdb, 0x4d, 0xce, 0x3e, 0xfc, 0xe5, 0x5b, 0xf6, 0xc3, 0x9b, 0xd7, 0x12, 0xf1,
+  0x2c, 0x13, 0x48, 0x25, 0x50, 0x01, 0x44, 0x5e, 0x49, 0x04, 0xbb, 0xaa, 0x24, 0x07, 0x30, 0x2f,
+  0xeb, 0x31, 0x62, 0xc0, 0x9e, 0x01, 0x3a, 0xe1, 0x06, 0xe1, 0x95, 0x67, 0xe0, 0x35, 0x68, 0x77,
+  0xe8, 0x57, 0x48, 0xef, 0x12, 0x44, 0x2e, 0xf1, 0x4e, 0xb1, 0x10, 0x2e, 0x9d, 0x80, 0x2c, 0xae,
+  0x28, 0xeb, 0x80, 0x4f, 0xe9, 0x8a, 0xe7, 0x37, 0x20, 0x1a, 0x18, 0xe2, 0x07, 0x92, 0x9a, 0x6b,
+  0x10, 0x49, 0xac, 0xb7, 0x76, 0x43, 0x6b, 0xf8, 0x59, 0xfe, 0x39, 0x6a, 0xf8, 0xe7, 0x2d, 0x04,
+  0x4d, 0x26, 0xbb, 0x83, 0xef, 0xaa, 0x09, 0xa6, 0xc6, 0x17, 0xec, 0x15, 0xc5, 0xc2, 0xfb, 0xb9,
+  0xa0, 0x14, 0xf4, 0xaa, 0x59, 0xad, 0x80, 0x2a, 0x2c, 0x0a, 0xc8, 0xc1, 0x90, 0xda, 0xb2, 0x15,
+  0x97, 0x1a, 0xd0, 0x04, 0x90, 0x1b, 0x01, 0x89, 0x55, 0xff, 0x9d, 0x46, 0x81, 0x91, 0x0a, 0xac,
+  0xb8, 0xc9, 0x18, 0x4d, 0xf8, 0xe4, 0x45, 0x83, 0x01, 0x38, 0x0b, 0x53, 0x54, 0xca, 0xd7, 0x88,
+  0xa0, 0x07, 0x52, 0xb0, 0xcd, 0xbb, 0xc6, 0x4a, 0xac, 0xe3, 0x1e, 0xa9, 0xfb, 0x2e, 0x57, 0x7c,
+  0x0a, 0x37, 0x4d, 0x62, 0x02, 0xc3, 0x0c, 0x0f, 0x31, 0x00, 0xbe, 0x61, 0xb9, 0xd1, 0x05, 0x09,
+  0x83, 0x8b, 0xd7, 0x10, 0x58, 0x42, 0x7b, 0x80, 0x93, 0x4e, 0xba, 0x99, 0x19, 0x15, 0xf3, 0xec,
+  0x2b, 0x77, 0xb5, 0xc8, 0xc9, 0x8d, 0x52, 0x06, 0x31, 0x92, 0x39, 0xd6, 0x63, 0x44, 0xb1, 0x2b,
+  0x11, 0x96, 0xe9, 0x4d, 0x99, 0x67, 0xab, 0x6e, 0xc6, 0xad, 0x45, 0xa2, 0xfd, 0xac, 0x80, 0xfa,
+  0x52, 0x5b, 0xc5, 0xe8, 0xb5, 0xc3, 0x23, 0x5f, 0x78, 0x00, 0xa5, 0xb4, 0x82, 0x4f, 0x1f, 0xc8,
+  0x33, 0xd8, 0x1b, 0xb4, 0xe9, 0xf4, 0x63, 0x8d, 0x23, 0x34, 0x91, 0x68, 0xf6, 0x0d, 0xa8, 0x84,
+  0x8e, 0xf0, 0x21, 0xb2, 0x40, 0x87, 0x45, 0xa5, 0x28, 0xd4, 0xd9, 0x1e, 0x20, 0xd5, 0x26, 0xc6,
+  0xb7, 0x82, 0x43, 0x6d, 0x99, 0xb3, 0x0c, 0xca, 0xe6, 0x8c, 0x36, 0x24, 0x60, 0xf4, 0x3d, 0x56,
+  0x40, 0xbb, 0xb8, 0xb7, 0xac, 0x32, 0xed, 0x68, 0xae, 0x63, 0x32, 0x50, 0xe1, 0x0a, 0xa2, 0xaa,
+  0x54, 0x29, 0x16, 0x50, 0x43, 0x20, 0xc2, 0x51, 0x22, 0x52, 0xc8, 0x61, 0xd9, 0x3e, 0xbb, 0xdb,
+  0x63, 0x8c, 0xd8, 0xe7, 0xd0, 0xbb, 0xcd, 0x59, 0x9c, 0x47, 0x15, 0x1e, 0x09, 0x22, 0xa8, 0x75,
+  0x8a, 0xbf, 0xd9, 0x32, 0xd8, 0x9f, 0x01, 0x25, 0xa6, 0x8e, 0x01, 0x91, 0xe3, 0x24, 0x2a, 0xb2,
+  0x1a, 0x53, 0xcd, 0x8a, 0x11, 0xa3, 0x00, 0xdc, 0xf0, 0xd2, 0xee, 0x0c, 0x90, 0xb6, 0x2e, 0xfe,
+  0x23, 0x2e, 0x5c, 0x12, 0xbf, 0x7b, 0xf8, 0x1a, 0x58, 0x65, 0xd8, 0xef, 0xbf, 0xb3, 0x8f, 0x97,
+  0xfb, 0x01, 0x08, 0x79, 0x03, 0x75, 0x76, 0xe0, 0xcc, 0xd0, 0x14, 0x0d, 0x01, 0x80, 0x58, 0x68,
+  0xa5, 0x5f, 0xe1, 0xfa, 0x00, 0x3d, 0x8c, 0x57, 0x17, 0x3f, 0xb0, 0xf9, 0x7c, 0xce, 0x3c, 0xa9,
+  0xb0, 0xe2, 0x79, 0xec, 0x45, 0xdb, 0x9e, 0x0b, 0xe8, 0x31, 0xdf, 0xc1, 0x79, 0xcb, 0x71, 0xaa,
+  0x4f, 0x69, 0x5d, 0xe8, 0x7b, 0xc9, 0x55, 0x55, 0x66, 0x24, 0x04, 0xff, 0xc2, 0xb3, 0xf5, 0xe5,
+  0x12, 0x1d, 0xff, 0x03, 0x3e, 0x7d, 0x0f, 0xe8, 0xd7, 0xad, 0xeb, 0xf4, 0x7b, 0xf8, 0xdc, 0x79,
+  0xdb, 0xa3, 0x05, 0xef, 0x80, 0xdd, 0x79, 0x60, 0x8a, 0x37, 0xd5, 0x47, 0x83, 0x2b, 0xbe, 0xb9,
+  0x3f, 0x60, 0x1f, 0xf5, 0x07, 0x22, 0xd1, 0x3e, 0x00, 0x88, 0x6a, 0x8e, 0xc1, 0x1a, 0x1c, 0x7a,
+  0x06, 0x4d, 0xf6, 0x97, 0x5f, 0x9a, 0x23, 0x68, 0x19, 0x7b, 0x42, 0x16, 0xd1, 0xd0, 0xed, 0x59,
+  0x1f, 0xd0, 0xf1, 0x86, 0x13, 0x9c, 0x70, 0xbe, 0x46, 0xc9, 0x28, 0xc9, 0xfb, 0xda, 0xbb, 0xdc,
+  0x77, 0x6e, 0x36, 0x86, 0xd1, 0xc9, 0xb6, 0x65, 0x69, 0xfa, 0x4e, 0xa3, 0x4b, 0x0e, 0xec, 0x53,
+  0xbb, 0x81, 0x1b, 0x62, 0x45, 0xb7, 0x37, 0x5a, 0xb4, 0xde, 0x0e, 0xb0, 0x57, 0x7f, 0xa5, 0x07,
+  0x1b, 0x30, 0xdc, 0xf3, 0x50, 0xc8, 0xe1, 0x21, 0xfb, 0x9e, 0xf3, 0x42, 0x67, 0x39, 0x6c, 0x12,
+  0x5d, 0x2d, 0xd7, 0x87, 0x28, 0x73, 0xde, 0x80, 0xb2, 0x98, 0x49, 0xf0, 0xf6, 0x41, 0x3f, 0x83,
+  0x89, 0xb0, 0xc4, 0xac, 0x13, 0x18, 0x47, 0xd8, 0x5e, 0x0a, 0x5c, 0xf0, 0xc4, 0xaa, 0x10, 0xe0,
+  0x0d, 0xae, 0xa1, 0xc1, 0xac, 0x83, 0x42, 0x2e, 0x5a, 0x7a, 0x25, 0x90, 0x52, 0x68, 0x04, 0x18,
+  0x36, 0x33, 0x08, 0xaa, 0x83, 0x8d, 0xe1, 0x06, 0xfa, 0x7e, 0xbc, 0x43, 0xc2, 0xa9, 0xa5, 0xba,
+  0xbf, 0x0c, 0xe0, 0x22, 0x42, 0x71, 0xb1, 0x9c, 0xa5, 0x73, 0x9a, 0x53, 0xa1, 0x8b, 0xc9, 0xad,
+  0x16, 0xc4, 0x1e, 0x81, 0x60, 0xab, 0xfe, 0xdc, 0x29, 0x54, 0x82, 0x20, 0x52, 0x08, 0x67, 0x19,
+  0xa8, 0xb4, 0xe0, 0x94, 0x17, 0xcc, 0xc3, 0xce, 0x10, 0x42, 0x4d, 0x86, 0x7b, 0x80, 0xc1, 0x06,
+  0xf5, 0x37, 0xcc, 0x63, 0xf1, 0xb7, 0xeb, 0x03, 0x4a, 0xc7, 0x19, 0x00, 0xcb, 0x83, 0x25, 0x4b,
+  0x61, 0xd7, 0x80, 0xe8, 0xa0, 0xb1, 0x21, 0xb1, 0xf9, 0x83, 0x8e, 0x6f, 0xe6, 0x94, 0xc1, 0x7a,
+  0x0d, 0x7a, 0xd6, 0x60, 0xa9, 0x57, 0x08, 0x97, 0x94, 0x86, 0xbc, 0x69, 0xc3, 0x71, 0x08, 0x99,
+  0x86, 0x23, 0x51, 0x93, 0x01, 0x0a, 0xb1, 0x76, 0xc1, 0xc2, 0xbe, 0xa7, 0x41, 0xcb, 0x0c, 0xff,
+  0x40, 0xc7, 0x96, 0xc7, 0x35, 0xa3, 0x3b, 0x51, 0x20, 0x7a, 0x83, 0x9c, 0x3a, 0x66, 0x35, 0x0b,
+  0x77, 0xf9, 0xea, 0x98, 0x84, 0x73, 0x30, 0xfc, 0x51, 0xb2, 0xd3, 0x97, 0x63, 0x8b, 0x48, 0xed,
+  0xf1, 0xed, 0xad, 0xa1, 0x4b, 0x32, 0xef, 0xb9, 0x24, 0xe8, 0x05, 0xfb, 0x76, 0x56, 0xf7, 0x03,
+  0xe5, 0x65, 0x72, 0x83, 0x88, 0xeb, 0xb7, 0x13, 0x3c, 0x8a, 0xbc, 0x60, 0xc9, 0xb3, 0xc7, 0xd0,
+  0xcb, 0x98, 0xad, 0x5a, 0x64, 0xd6, 0x7d, 0x9e, 0x2a, 0xe1, 0xe7, 0xbd, 0xf1, 0x88, 0x3d, 0x14,
+  0xd8, 0x89, 0x7b, 0x6e, 0x0e, 0x11, 0x39, 0xa9, 0x38, 0xd2, 0x94, 0x06, 0xb6, 0x4e, 0x23, 0xc8,
+  0xfa, 0xa4, 0x0f, 0x15, 0x9d, 0xba, 0x7c, 0x53, 0x74, 0x30, 0x34, 0x74, 0x90, 0xfd, 0x99, 0x24,
+  0x73, 0xb0, 0xfb, 0xa8, 0x13, 0x68, 0x5c, 0x87, 0x67, 0xad, 0xec, 0x83, 0x07, 0xf4, 0xa3, 0x87,
+  0x04, 0xa2, 0x7e, 0x80, 0x06, 0x9f, 0x88, 0xc0, 0x39, 0x97, 0xf0, 0x8f, 0x34, 0xb0, 0x29, 0xdf,
+  0xa4, 0x4d, 0x0a, 0xc3, 0x6c, 0x47, 0x28, 0x4d, 0xb0, 0x5d, 0x2c, 0x75, 0x2d, 0xad, 0x05, 0x51,
+  0xc3, 0xa9, 0x3f, 0x8a, 0xed, 0x88, 0xd9, 0x00, 0x35, 0x12, 0x1d, 0x71, 0xac, 0xe7, 0xb9, 0x5a,
+  0xac, 0x0c, 0x7d, 0xab, 0xe4, 0x12, 0x01, 0x99, 0x00, 0x6a, 0x40, 0xff, 0xb7, 0x43, 0xb3, 0xcf,
+  0x80, 0x17, 0xa6, 0xcf, 0x1d, 0xd0, 0x5a, 0x87, 0xb7, 0x29, 0xcf, 0x56, 0x2a, 0x71, 0xeb, 0x35,
+  0xa7, 0x80, 0x43, 0x79, 0x89, 0x65, 0x6d, 0xc2, 0xec, 0x2e, 0xd0, 0x5b, 0xf3, 0x7a, 0xfd, 0xa8,
+  0x8f, 0x58, 0x37, 0x1a, 0x75, 0x9b, 0xf5, 0x59, 0x6b, 0xbc, 0x86, 0x8a, 0x47, 0x3a, 0x41, 0xbd,
+  0x2c, 0x45, 0xe4, 0x19, 0xa6, 0xfd, 0x27, 0x8a, 0x10, 0xff, 0x62, 0x8e, 0xb9, 0xc4, 0xfb, 0x38,
+  0xf4, 0x9f, 0x5f, 0x7e, 0x6d, 0xc9, 0xef, 0x5b, 0x9a, 0x40, 0x5e, 0x02, 0xb0, 0x6f, 0xc5, 0x43,
+  0x91, 0x38, 0xa7, 0x25, 0x49, 0x7d, 0x73, 0xc6, 0xf5, 0xb0, 0x95, 0x29, 0x3b, 0x65, 0xe2, 0x6c,
+  0x8c, 0x1d, 0x28, 0xe3, 0xeb, 0x02, 0x06, 0x58, 0xed, 0xdd, 0x2b, 0xa8, 0x2b, 0x52, 0x17, 0x16,
+  0x95, 0x63, 0x17, 0x98, 0x67, 0x54, 0x31, 0xb6, 0xea, 0x15, 0x69, 0x18, 0xf1, 0x24, 0x4f, 0x21,
+  0x69, 0xb8, 0x6b, 0x87, 0xbd, 0x18, 0x64, 0xdb, 0x9f, 0x33, 0xdd, 0xd8, 0xc6, 0x98, 0x6a, 0x75,
+  0xa9, 0x6a, 0x85, 0xd0, 0x32, 0x31, 0xf7, 0xb4, 0x8e, 0x84, 0xad, 0x55, 0xf8, 0xa5, 0xc9, 0x4a,
+  0x1c, 0x34, 0xca, 0xda, 0xfd, 0xae, 0xd5, 0xed, 0x27, 0x0d, 0xbb, 0xb7, 0x95, 0x1c, 0x74, 0xa9,
+  0xb7, 0x17, 0xbb, 0x6f, 0x4d, 0xed, 0x0f, 0x06, 0x9e, 0xbb, 0xc9, 0xf5, 0xb6, 0xc3, 0xfc, 0xdd,
+  0xf5, 0xb2, 0x95, 0x30, 0x97, 0x1c, 0xee, 0xef, 0xdf, 0x60, 0xe2, 0x1b, 0x40, 0x6c, 0x12, 0xed,
+  0x70, 0x23, 0x8c, 0xb6, 0x68, 0x19, 0x24, 0x45, 0x50, 0xc5, 0xa0, 0xd7, 0x86, 0x1a, 0xe4, 0x93,
+  0x2f, 0xe1, 0x82, 0x06, 0x38, 0xba, 0xd6, 0x2a, 0x1b, 0xf4, 0xb4, 0x05, 0x8c, 0x59, 0xdc, 0xdd,
+  0x3d, 0x88, 0xe6, 0x13, 0xbb, 0x18, 0xe4, 0x57, 0xdb, 0x68, 0xaa, 0xa4, 0x84, 0x39, 0x0a, 0x9f,
+  0x6b, 0xde, 0xe0, 0xbb, 0x89, 0x3b, 0x19, 0xe8, 0x91, 0xaa, 0x81, 0x09, 0xa3, 0x8c, 0x23, 0xf9,
+  0x0d, 0x75, 0xed, 0xcd, 0xfd, 0x38, 0x9c, 0xe1, 0xb3, 0xc0, 0x39, 0x4e, 0x54, 0x03, 0x6c, 0x6f,
+  0xb5, 0x44, 0xd7, 0xcb, 0xad, 0xb8, 0x32, 0x8d, 0xe9, 0xb7, 0x9b, 0xef, 0xe2, 0x81, 0x7b, 0x5c,
+  0xd8, 0x6f, 0xf5, 0x25, 0x78, 0x34, 0xc0, 0x6f, 0x34, 0xe1, 0x02, 0x14, 0xce, 0xed, 0xef, 0xd8,
+  0xc7, 0xba, 0xda, 0x1e, 0x04, 0x84, 0x8c, 0xbe, 0x17, 0x08, 0x42, 0x4b, 0x94, 0xf2, 0xb0, 0xbc,
+  0x10, 0x6b, 0x0e, 0x0d, 0xcb, 0xc0, 0x76, 0xdb, 0xfb, 0xa6, 0xe5, 0xb9, 0xd8, 0xbe, 0xe0, 0xe0,
+  0x96, 0xc4, 0xc2, 0x4e, 0xa3, 0x9d, 0x7b, 0x5c, 0x05, 0x34, 0x4b, 0x18, 0x84, 0x57, 0x21, 0xec,
+  0x54, 0x99, 0x12, 0xa9, 0x06, 0x32, 0x4e, 0x96, 0x82, 0xc6, 0x67, 0x98, 0x9c, 0x94, 0x6b, 0x80,
+  0x1a, 0x3a, 0x5b, 0x4f, 0xd7, 0x5a, 0x7c, 0x00, 0x92, 0x55, 0x65, 0x1b, 0xb1, 0x6d, 0x44, 0xb6,
+  0x30, 0xf0, 0x0e, 0x9d, 0x81, 0xe8, 0x6a, 0xcf, 0x84, 0x59, 0x8f, 0x66, 0xef, 0xea, 0x8d, 0x0e,
+  0x44, 0x80, 0xfe, 0x63, 0xd3, 0xd0, 0xe4, 0xe7, 0x7a, 0x2c, 0x9a, 0xe4, 0xb5, 0x60, 0xa0, 0xae,
+  0xf5, 0xfc, 0x58, 0x2f, 0xba, 0xe6, 0x7f, 0x59, 0xcc, 0x77, 0x46, 0xac, 0x7e, 0x10, 0xf3, 0x5e,
+  0x5f, 0x7e, 0xb6, 0x8d, 0x28, 0x39, 0x64, 0x9b, 0xa5, 0x4d, 0x1b, 0xa1, 0xaf, 0x2a, 0x0c, 0x0c,
+  0x0d, 0x56, 0xdb, 0xe4, 0x8d, 0x98, 0xeb, 0xc1, 0x51, 0x5f, 0x93, 0x31, 0xb0, 0x53, 0xaa, 0xed,
+  0x70, 0xcd, 0xcc, 0x4a, 0xd7, 0xad, 0xaf, 0xf3, 0x5b, 0xd6, 0xed, 0xdd, 0x09, 0x4a, 0x3b, 0xb8,
+  0x63, 0x03, 0xe5, 0x72, 0x02, 0xf5, 0x3b, 0x8d, 0x1e, 0xa8, 0xa7, 0xd1, 0x71, 0x1a, 0xb8, 0x8e,
+  0xa7, 0x36, 0x9f, 0xb4, 0x8c, 0xb2, 0xaa, 0xb7, 0x0d, 0xab, 0xbd, 0xad, 0x91, 0xa2, 0x75, 0x5c,
+  0xa0, 0x27, 0x76, 0xc2, 0x01, 0xd8, 0xec, 0x36, 0x89, 0x9e, 0x7e, 0xf7, 0x03, 0xfd, 0x3a, 0x0a,
+  0xf1, 0x4d, 0x73, 0xfd, 0x24, 0x13, 0x60, 0x72, 0xa1, 0x91, 0x90, 0x86, 0x95, 0xd6, 0x7b, 0x38,
+  0x4e, 0xa4, 0x35, 0xf1, 0x7a, 0xb3, 0x01, 0x4a, 0xed, 0x84, 0xfd, 0x00, 0xb8, 0x35, 0x3c, 0xfd,
+  0xc8, 0xbd, 0x37, 0x6f, 0xb7, 0x35, 0x85, 0x96, 0x21, 0x64, 0x75, 0x30, 0x02, 0x0c, 0x81, 0x81,
+  0xde, 0x4c, 0xcf, 0xa7, 0x87, 0xe6, 0xd1, 0xfe, 0x50, 0xff, 0xcf, 0xd6, 0xff, 0x01, 0x5c, 0x61,
+  0xee, 0x07, 0xea, 0x2a, 0x00, 0x00,
+};
+
+#endif
@@ -0,0 +1,222 @@
+/**
+* @file ConfigSchema.h
+* @brief Declaration of the configuration schema for Arduino project.
+*
+* This file contains the layout of the stored device configuration and the schema table
+* that describes every setting in it: its key, type, bounds, default and flags. Storage,
+* form parsing, validation, logging and the configuration page all walk this table, so a
+* new setting is one ConfigData field and one table row.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#ifndef CONFIG_SCHEMA_H
+#define CONFIG_SCHEMA_H
+
+#include "Arduino.h"
+#include <stddef.h>
+
+// Define constant strings for Wi-Fi network configuration.
+#define NETWORK_NAME "netName"  // Wi-Fi network name.
+#define NETWORK_PASS "netPass"  // Wi-Fi network password.
+
+// Define constant strings for MQTT configuration.
+#define MQTT_SERVER_ADDRESS "mqttSrvAdr"    // MQTT server address.
+#define MQTT_SERVER_PORT "mqttSrvPort"      // MQTT server port.
+#define MQTT_USERNAME "mqttUser"            // MQTT username.
+#define MQTT_PASS "mqttPass"                // MQTT password.
+#define MQTT_CLIENT_ID "mqttClient"         // MQTT client ID.
+#define MQTT_TOPIC "mqttTopic"              // MQTT topic.
+#define AUDIO_NOTIFICATIONS "audioNotif"    // Audio Notifications status.
+#define VISUAL_NOTIFICATIONS "visualNotif"  // Visual Notifications status.
+
+// Longest text value stored in preferences, including the terminator.
+#define PREFERENCES_VALUE_SIZE 128
+
+/**
+* @struct ConfigData
+* @brief Device configuration as stored in the configuration blob.
+*
+* New fields are only ever appended, so a blob of an older version is read as a prefix of
+* this layout and the missing fields keep their defaults. Text fields are zero-padded, which
+* lets two configurations be compared byte for byte.
+*/
+struct ConfigData {
+  char networkName[PREFERENCES_VALUE_SIZE];        // Wi-Fi network name.
+  char networkPass[PREFERENCES_VALUE_SIZE];        // Wi-Fi network password.
+  char mqttServerAddress[PREFERENCES_VALUE_SIZE];  // MQTT server address.
+  char mqttUsername[PREFERENCES_VALUE_SIZE];       // MQTT username.
+  char mqttPass[PREFERENCES_VALUE_SIZE];           // MQTT password.
+  char mqttClientId[PREFERENCES_VALUE_SIZE];       // MQTT client ID.
+  char mqttTopic[PREFERENCES_VALUE_SIZE];          // MQTT topic.
+  uint16_t mqttServerPort;                         // MQTT server port, 0 if not configured.
+  bool audioNotifications;                         // Audio notifications enabled.
+  bool visualNotifications;                        // Visual notifications enabled.
+};
+
+/**
+* @enum ConfigTypeEnum
+* @brief Enumeration of the setting types.
+*/
+enum ConfigTypeEnum : byte {
+  CONFIG_TEXT,     // Zero-padded text of PREFERENCES_VALUE_SIZE bytes, bounds limit its length.
+  CONFIG_NETWORK,  // Text chosen from the scanned Wi-Fi networks.
+  CONFIG_NUMBER,   // uint16_t, bounds limit its value.
+  CONFIG_SWITCH    // bool.
+};
+
+/**
+* @enum ConfigSectionEnum
+* @brief Enumeration of the configuration page sections, in page order.
+*/
+enum ConfigSectionEnum : byte {
+  CONFIG_SECTION_WIFI,           // Wi-Fi router configuration.
+  CONFIG_SECTION_MQTT_SERVER,    // MQTT server configuration.
+  CONFIG_SECTION_MQTT_CLIENT,    // MQTT client and topic configuration.
+  CONFIG_SECTION_NOTIFICATIONS,  // Audio and visual notifications.
+  CONFIG_SECTION_COUNT           // Number of sections.
+};
+
+/**
+* @brief Get the stored size of a setting type, 0 for types the schema does not support.
+*
+* Only uint16_t numbers, bool switches and texts of PREFERENCES_VALUE_SIZE bytes are supported.
+*
+* @return Size of the type in bytes.
+*/
+template <typename T>
+constexpr uint16_t getConfigValueSize() {
+  return 0;
+}
+
+template <>
+constexpr uint16_t getConfigValueSize<uint16_t>() {
+  return sizeof(uint16_t);
+}
+
+template <>
+constexpr uint16_t getConfigValueSize<bool>() {
+  return sizeof(bool);
+}
+
+template <>
+constexpr uint16_t getConfigValueSize<char[PREFERENCES_VALUE_SIZE]>() {
+  return PREFERENCES_VALUE_SIZE;
+}
+
+// Offset and size of a ConfigData member, the location columns of a schema row.
+#define CONFIG_VALUE(member) offsetof(ConfigData, member), getConfigValueSize<decltype(ConfigData::member)>()
+
+/**
+* @struct ConfigField
+* @brief Schema row of a single setting.
+*/
+struct ConfigField {
+  const char* key;            // Form field name, also the preferences key of the per-key layout.
+  const char* label;          // Label on the configuration page.
+  ConfigTypeEnum type;        // Value type.
+  ConfigSectionEnum section;  // Section of the configuration page.
+  uint16_t offset;            // Offset of the value in ConfigData.
+  uint16_t size;              // Size of the value in ConfigData, 0 for an unsupported member type.
+  uint16_t minimum;           // Shortest text or smallest number that is valid.
+  uint16_t maximum;           // Longest text or largest number that is valid.
+  uint16_t defaultValue;      // Default of numbers and switches, text defaults to empty.
+  bool isSecret;              // Never logged or echoed in clear text.
+  bool isLiveApplied;         // Reserved: could take effect without a restart, every save restarts for now.
+};
+
+// Settings in page order. Texts are stored in PREFERENCES_VALUE_SIZE bytes, so their maximum stays below it.
+static constexpr ConfigField configSchema[] = {
+  // key, label, type, section, offset and size, minimum, maximum, default, secret, live
+  { NETWORK_NAME, "Select SSID", CONFIG_NETWORK, CONFIG_SECTION_WIFI, CONFIG_VALUE(networkName), 1, 32, 0, false, false },
+  { NETWORK_PASS, "SSID Password", CONFIG_TEXT, CONFIG_SECTION_WIFI, CONFIG_VALUE(networkPass), 1, 63, 0, true, false },
+  { MQTT_SERVER_ADDRESS, "MQTT Server", CONFIG_TEXT, CONFIG_SECTION_MQTT_SERVER, CONFIG_VALUE(mqttServerAddress), 1, 127, 0, false, false },
+  { MQTT_SERVER_PORT, "MQTT Port", CONFIG_NUMBER, CONFIG_SECTION_MQTT_SERVER, CONFIG_VALUE(mqttServerPort), 1, 65535, 0, false, false },
+  { MQTT_USERNAME, "MQTT Username", CONFIG_TEXT, CONFIG_SECTION_MQTT_SERVER, CONFIG_VALUE(mqttUsername), 1, 127, 0, false, false },
+  { MQTT_PASS, "MQTT Password", CONFIG_TEXT, CONFIG_SECTION_MQTT_SERVER, CONFIG_VALUE(mqttPass), 1, 127, 0, true, false },
+  { MQTT_CLIENT_ID, "MQTT Client ID", CONFIG_TEXT, CONFIG_SECTION_MQTT_CLIENT, CONFIG_VALUE(mqttClientId), 1, 127, 0, false, false },
+  { MQTT_TOPIC, "MQTT Topic", CONFIG_TEXT, CONFIG_SECTION_MQTT_CLIENT, CONFIG_VALUE(mqttTopic), 1, 127, 0, false, false },
+  { AUDIO_NOTIFICATIONS, "Enable audio notifications", CONFIG_SWITCH, CONFIG_SECTION_NOTIFICATIONS, CONFIG_VALUE(audioNotifications), 0, 1, 1, false, true },
+  { VISUAL_NOTIFICATIONS, "Enable visual notifications", CONFIG_SWITCH, CONFIG_SECTION_NOTIFICATIONS, CONFIG_VALUE(visualNotifications), 0, 1, 1, false, true }
+};
+
+// Number of settings in the schema.
+#define CONFIG_FIELD_COUNT (sizeof(configSchema) / sizeof(configSchema[0]))
+
+/**
+* @brief Get the stored size of a setting type.
+*
+* @param type The setting type.
+* @return Size of the value in ConfigData, in bytes.
+*/
+static constexpr uint16_t getConfigTypeSize(ConfigTypeEnum type) {
+  return type == CONFIG_NUMBER ? sizeof(uint16_t) : (type == CONFIG_SWITCH ? sizeof(bool) : PREFERENCES_VALUE_SIZE);
+}
+
+/**
+* @brief Check the schema rows from an index on, at compile time.
+*
+* Rows must point at a member of ConfigData of their type and be ordered by section, and
+* text maximums must leave room for the terminator.
+*
+* @param index First row to check.
+* @return true if all rows from the index on are consistent.
+*/
+static constexpr bool isConfigSchemaValid(size_t index) {
+  return index >= CONFIG_FIELD_COUNT
+         || (configSchema[index].size == getConfigTypeSize(configSchema[index].type)
+             && configSchema[index].offset + configSchema[index].size <= sizeof(ConfigData)
+             && (configSchema[index].type > CONFIG_NETWORK || configSchema[index].maximum < PREFERENCES_VALUE_SIZE)
+             && configSchema[index].minimum <= configSchema[index].maximum
+             && (index == 0 || configSchema[index - 1].section <= configSchema[index].section)
+             && isConfigSchemaValid(index + 1));
+}
+
+/**
+* @brief Get the length of a key, at compile time.
+*
+* @param key The key.
+* @return Number of characters of the key.
+*/
+static constexpr size_t getConfigKeyLength(const char* key) {
+  return *key == '\0' ? 0 : 1 + getConfigKeyLength(key + 1);
+}
+
+/**
+* @brief Get the length of the longest form query from an index on, at compile time.
+*
+* Texts are counted with every byte percent-encoded, numbers with five digits and
+* switches with the "true" the page sends.
+*
+* @param index First row to count.
+* @return Length of the "key=value&" pairs of all rows from the index on.
+*/
+static constexpr size_t getConfigQueryLength(size_t index) {
+  return index >= CONFIG_FIELD_COUNT
+           ? 0
+           : getConfigKeyLength(configSchema[index].key) + 2
+               + (configSchema[index].type == CONFIG_NUMBER ? 5 : (configSchema[index].type == CONFIG_SWITCH ? 4 : configSchema[index].maximum * 3))
+               + getConfigQueryLength(index + 1);
+}
+
+static_assert(isConfigSchemaValid(0), "Configuration schema rows point at the wrong member, are out of bounds or out of section order.");
+
+#endif
@@ -0,0 +1,239 @@
+/**
+* @file EnergyMonitor.cpp
+* @brief Implementation of the energy accounting for Arduino project.
+*
+* This file contains the implementation of the state-time energy accounting. Each component
+* keeps its current state and the time it entered it. On every state change, and before
+* every report, the elapsed time is charged at the model current of the state. Charges are
+* kept in microampere-milliseconds, which does not overflow for thousands of years.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Arduino.h"
+#include "EnergyMonitor.h"
+#include "Metrics.h"
+#include "Helpers.h"
+#include "esp_timer.h"
+
+/**
+* @struct EnergyAccount
+* @brief Accounting state of a single component.
+*/
+struct EnergyAccount {
+  EnergyStateEnum state;  // Current state.
+  int64_t since;          // Time the current state was entered, in microseconds since boot.
+  uint64_t charge;        // Charge drawn so far, in microampere-milliseconds.
+};
+
+// Model current of every state in microamperes.
+static const uint32_t stateCurrents[ENERGY_STATE_COUNT] = {
+  ENERGY_CURRENT_CPU_80MHZ,
+  ENERGY_CURRENT_CPU_160MHZ,
+  ENERGY_CURRENT_CPU_240MHZ,
+  ENERGY_CURRENT_RADIO_OFF,
+  ENERGY_CURRENT_RADIO_CONNECTING,
+  ENERGY_CURRENT_RADIO_CONNECTED,
+  ENERGY_CURRENT_LED_OFF,
+  ENERGY_CURRENT_LED_ON,
+  ENERGY_CURRENT_BUZZER_OFF,
+  ENERGY_CURRENT_BUZZER_ON,
+  ENERGY_CURRENT_GNSS_ACQUISITION,
+  ENERGY_CURRENT_GNSS_TRACKING
+};
+
+// Component that owns every state.
+static const EnergyComponentEnum stateComponents[ENERGY_STATE_COUNT] = {
+  ENERGY_CPU,
+  ENERGY_CPU,
+  ENERGY_CPU,
+  ENERGY_RADIO,
+  ENERGY_RADIO,
+  ENERGY_RADIO,
+  ENERGY_LED,
+  ENERGY_LED,
+  ENERGY_BUZZER,
+  ENERGY_BUZZER,
+  ENERGY_GNSS,
+  ENERGY_GNSS
+};
+
+// Accounts of all components, changed from several tasks under the lock.
+static EnergyAccount accounts[ENERGY_COMPONENT_COUNT];
+static portMUX_TYPE accountLock = portMUX_INITIALIZER_UNLOCKED;
+
+// Start of the accounting in microseconds since boot, 0 until initEnergyMonitor() is called.
+static int64_t accountingStart = 0;
+
+// Published fixes since the start of the accounting.
+static MetricCounter fixCount("smaf_energy_fixes_total", "Published fixes counted for the charge-per-fix estimate.");
+
+// Total charge and fix count at the last report that saw new fixes, the start of the
+// interval the charge per fix is taken over. Only used by energyExport().
+static uint64_t intervalStartCharge = 0;
+static uint32_t intervalStartFixes = 0;
+
+// Energy metrics.
+static MetricGauge averageCurrentGauge("smaf_energy_average_current_ua", "Estimated average current since boot, equal to uAh per hour.");
+static MetricGauge chargeGauge("smaf_energy_charge_uah", "Estimated charge drawn since boot.");
+static MetricGauge chargePerFixGauge("smaf_energy_charge_per_fix_uah", "Estimated charge drawn per published fix since the previous report with fixes.");
+
+/**
+* @brief Charges the time since the last settlement of an account.
+*
+* @param account The account, must be locked by the caller.
+* @param now The current time in microseconds since boot.
+*/
+static void settleAccount(EnergyAccount& account, int64_t now) {
+  account.charge += (uint64_t)stateCurrents[account.state] * (uint64_t)(now - account.since) / 1000;
+  account.since = now;
+}
+
+/**
+* @brief Get the CPU state matching the current CPU frequency.
+*
+* @return The closest CPU state of the current model.
+*/
+static EnergyStateEnum cpuStateForFrequency() {
+  uint32_t frequency = getCpuFrequencyMhz();
+
+  if (frequency <= 80) {
+    return ENERGY_CPU_80MHZ;
+  }
+
+  return frequency <= 160 ? ENERGY_CPU_160MHZ : ENERGY_CPU_240MHZ;
+}
+
+/**
+* @brief Starts the accounting with every component in its boot state.
+*
+* The CPU state is taken from the current CPU frequency, the radio, LEDs and buzzer start
+* off, and the GNSS module starts in acquisition.
+*/
+void initEnergyMonitor() {
+  const EnergyStateEnum bootStates[ENERGY_COMPONENT_COUNT] = {
+    cpuStateForFrequency(),
+    ENERGY_RADIO_OFF,
+    ENERGY_LED_OFF,
+    ENERGY_BUZZER_OFF,
+    ENERGY_GNSS_ACQUISITION
+  };
+
+  int64_t now = esp_timer_get_time();
+
+  portENTER_CRITICAL(&accountLock);
+
+  for (uint8_t i = 0; i < ENERGY_COMPONENT_COUNT; ++i) {
+    accounts[i].state = bootStates[i];
+    accounts[i].since = now;
+    accounts[i].charge = 0;
+  }
+
+  accountingStart = now;
+
+  portEXIT_CRITICAL(&accountLock);
+}
+
+/**
+* @brief Moves a component into a new state.
+*
+* The time spent in the previous state is charged at its model current. Setting the state
+* a component is already in costs only a comparison, so callers do not need to track it.
+*
+* @param component The component.
+* @param state The new state, must belong to the component.
+*/
+void energySetState(EnergyComponentEnum component, EnergyStateEnum state) {
+  if (accountingStart == 0 || component >= ENERGY_COMPONENT_COUNT || state >= ENERGY_STATE_COUNT) {
+    return;
+  }
+
+  if (stateComponents[state] != component || accounts[component].state == state) {
+    return;
+  }
+
+  int64_t now = esp_timer_get_time();
+
+  portENTER_CRITICAL(&accountLock);
+  settleAccount(accounts[component], now);
+  accounts[component].state = state;
+  portEXIT_CRITICAL(&accountLock);
+}
+
+/**
+* @brief Counts a published fix for the charge-per-fix estimate.
+*/
+void energyRecordFix() {
+  fixCount.increment();
+}
+
+/**
+* @brief Updates the energy metrics and logs a report.
+*
+* Called by the scheduler once every ENERGY_EXPORT_INTERVAL. Does nothing before
+* initEnergyMonitor() has started the accounting.
+*/
+void energyExport() {
+  if (accountingStart == 0) {
+    return;
+  }
+
+  // Settle every account, so the totals include the time spent in the current states.
+  uint64_t charges[ENERGY_COMPONENT_COUNT];
+  uint64_t totalCharge = 0;
+  int64_t now = esp_timer_get_time();
+
+  portENTER_CRITICAL(&accountLock);
+
+  for (uint8_t i = 0; i < ENERGY_COMPONENT_COUNT; ++i) {
+    settleAccount(accounts[i], now);
+    charges[i] = accounts[i].charge;
+    totalCharge += charges[i];
+  }
+
+  portEXIT_CRITICAL(&accountLock);
+
+  // Convert microampere-milliseconds to microampere-hours.
+  const uint64_t millisecondsPerHour = 3600000ULL;
+  uint64_t elapsedMilliseconds = (uint64_t)(now - accountingStart) / 1000;
+  uint32_t chargeMicroampereHours = totalCharge / millisecondsPerHour;
+  uint32_t averageCurrent = elapsedMilliseconds == 0 ? 0 : totalCharge / elapsedMilliseconds;
+  uint32_t fixes = fixCount.value() - intervalStartFixes;
+
+  // Without new fixes the interval grows until the next one, the gauge keeps its value.
+  if (fixes != 0) {
+    chargePerFixGauge.set((totalCharge - intervalStartCharge) / ((uint64_t)fixes * millisecondsPerHour));
+    intervalStartCharge = totalCharge;
+    intervalStartFixes += fixes;
+  }
+
+  averageCurrentGauge.set(averageCurrent);
+  chargeGauge.set(chargeMicroampereHours);
+
+  debug(LOG, "Energy: %u.%03u mAh per hour, %u uAh per fix over %u new fixes.",
+        (unsigned int)(averageCurrent / 1000), (unsigned int)(averageCurrent % 1000), (unsigned int)chargePerFixGauge.value(), (unsigned int)fixes);
+  debug(LOG, "Energy by component: cpu %u, radio %u, led %u, buzzer %u, gnss %u uAh.",
+        (unsigned int)(charges[ENERGY_CPU] / millisecondsPerHour),
+        (unsigned int)(charges[ENERGY_RADIO] / millisecondsPerHour),
+        (unsigned int)(charges[ENERGY_LED] / millisecondsPerHour),
+        (unsigned int)(charges[ENERGY_BUZZER] / millisecondsPerHour),
+        (unsigned int)(charges[ENERGY_GNSS] / millisecondsPerHour));
+}
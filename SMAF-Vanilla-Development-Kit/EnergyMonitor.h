@@ -0,0 +1,148 @@
+/**
+* @file EnergyMonitor.h
+* @brief Declaration of the energy accounting for Arduino project.
+*
+* This file contains the declarations of the functions that estimate the charge drawn by
+* the device. Every power-relevant component (CPU, radio, LEDs, buzzer and GNSS module) is
+* always in exactly one state, and the time spent in each state is multiplied by the current
+* of that state from a configurable model. The totals are reported as average current
+* (mAh per hour) and as charge per published fix between reports, so firmware changes can be compared on
+* energy as well as on speed.
+*
+* @note The model currents are estimates for the SMAF development kit. Override any of
+*       them with a build flag, e.g. -DENERGY_CURRENT_RADIO_CONNECTED=30000, after
+*       measuring a specific board.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#ifndef ENERGY_MONITOR_H
+#define ENERGY_MONITOR_H
+
+#include "Arduino.h"
+
+// Interval between energy reports in milliseconds.
+#define ENERGY_EXPORT_INTERVAL 60000
+
+// Define the current model in microamperes per component state.
+#ifndef ENERGY_CURRENT_CPU_80MHZ
+#define ENERGY_CURRENT_CPU_80MHZ 22000  // CPU running at 80 MHz.
+#endif
+#ifndef ENERGY_CURRENT_CPU_160MHZ
+#define ENERGY_CURRENT_CPU_160MHZ 30000  // CPU running at 160 MHz.
+#endif
+#ifndef ENERGY_CURRENT_CPU_240MHZ
+#define ENERGY_CURRENT_CPU_240MHZ 40000  // CPU running at 240 MHz.
+#endif
+#ifndef ENERGY_CURRENT_RADIO_OFF
+#define ENERGY_CURRENT_RADIO_OFF 0  // Radio disabled.
+#endif
+#ifndef ENERGY_CURRENT_RADIO_CONNECTING
+#define ENERGY_CURRENT_RADIO_CONNECTING 95000  // Radio scanning and associating, receiver mostly on.
+#endif
+#ifndef ENERGY_CURRENT_RADIO_CONNECTED
+#define ENERGY_CURRENT_RADIO_CONNECTED 25000  // Radio associated with modem sleep, averaged over beacons and traffic.
+#endif
+#ifndef ENERGY_CURRENT_LED_OFF
+#define ENERGY_CURRENT_LED_OFF 1000  // NeoPixels idle, quiescent current of the drivers.
+#endif
+#ifndef ENERGY_CURRENT_LED_ON
+#define ENERGY_CURRENT_LED_ON 6000  // At least one NeoPixel lit at the configured brightness.
+#endif
+#ifndef ENERGY_CURRENT_BUZZER_OFF
+#define ENERGY_CURRENT_BUZZER_OFF 0  // Buzzer silent.
+#endif
+#ifndef ENERGY_CURRENT_BUZZER_ON
+#define ENERGY_CURRENT_BUZZER_ON 20000  // Buzzer playing a tone.
+#endif
+#ifndef ENERGY_CURRENT_GNSS_ACQUISITION
+#define ENERGY_CURRENT_GNSS_ACQUISITION 32000  // GNSS module searching for satellites.
+#endif
+#ifndef ENERGY_CURRENT_GNSS_TRACKING
+#define ENERGY_CURRENT_GNSS_TRACKING 26000  // GNSS module tracking with a valid fix.
+#endif
+
+/**
+* @enum EnergyComponentEnum
+* @brief Enumeration of the accounted components.
+*/
+enum EnergyComponentEnum : byte {
+  ENERGY_CPU,              // Processor, state taken from the CPU frequency at boot.
+  ENERGY_RADIO,            // Wi-Fi radio.
+  ENERGY_LED,              // NeoPixel LEDs.
+  ENERGY_BUZZER,           // Speaker.
+  ENERGY_GNSS,             // GNSS module.
+  ENERGY_COMPONENT_COUNT   // Number of accounted components.
+};
+
+/**
+* @enum EnergyStateEnum
+* @brief Enumeration of the component states of the current model.
+*/
+enum EnergyStateEnum : byte {
+  ENERGY_CPU_80MHZ,          // CPU running at 80 MHz.
+  ENERGY_CPU_160MHZ,         // CPU running at 160 MHz.
+  ENERGY_CPU_240MHZ,         // CPU running at 240 MHz.
+  ENERGY_RADIO_OFF,          // Radio disabled.
+  ENERGY_RADIO_CONNECTING,   // Radio scanning and associating.
+  ENERGY_RADIO_CONNECTED,    // Radio associated.
+  ENERGY_LED_OFF,            // All NeoPixels dark.
+  ENERGY_LED_ON,             // At least one NeoPixel lit.
+  ENERGY_BUZZER_OFF,         // Buzzer silent.
+  ENERGY_BUZZER_ON,          // Buzzer playing a tone.
+  ENERGY_GNSS_ACQUISITION,   // GNSS module searching for satellites.
+  ENERGY_GNSS_TRACKING,      // GNSS module tracking with a valid fix.
+  ENERGY_STATE_COUNT         // Number of states.
+};
+
+/**
+* @brief Starts the accounting with every component in its boot state.
+*
+* The CPU state is taken from the current CPU frequency, the radio, LEDs and buzzer start
+* off, and the GNSS module starts in acquisition.
+*/
+void initEnergyMonitor();
+
+/**
+* @brief Moves a component into a new state.
+*
+* The time spent in the previous state is charged at its model current. Setting the state
+* a component is already in costs only a comparison, so callers do not need to track it.
+*
+* @param component The component.
+* @param state The new state, must belong to the component.
+*/
+void energySetState(EnergyComponentEnum component, EnergyStateEnum state);
+
+/**
+* @brief Counts a published fix for the charge-per-fix estimate.
+*/
+void energyRecordFix();
+
+/**
+* @brief Updates the energy metrics and logs a report.
+*
+* Called by the scheduler once every ENERGY_EXPORT_INTERVAL. Does nothing before
+* initEnergyMonitor() has started the accounting.
+*/
+void energyExport();
+
+#endif
@@ -0,0 +1,169 @@
+/**
+* @file EventBus.h
+* @brief Declaration of the typed internal event bus for Arduino project.
+*
+* This file contains the building blocks of a statically typed publish/subscribe bus.
+* Every event is a plain struct, and every subscriber owns an EventMailbox for each event
+* type it wants, which is a PipelineQueue plus an overrun flag. The list of
+* mailboxes an event type is delivered to is an EventRoute specialization, so the fan-out
+* is resolved by the compiler. An event type without a route compiles to nothing, and a
+* producer never waits for a subscriber: a full mailbox drops the event and counts it.
+*
+* @note Posting is safe from interrupts. Each mailbox has a single consuming task.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#ifndef EVENT_BUS_H
+#define EVENT_BUS_H
+
+#include "Arduino.h"
+#include "PipelineQueue.h"
+#include <atomic>
+
+template <typename Event, size_t Capacity>
+class EventMailbox {
+public:
+  /**
+  * @brief Constructs an empty mailbox without an owner.
+  *
+  * @param droppedName Metric name of the counter of events dropped because the mailbox was full.
+  * @param droppedHelp Metric description of the same counter.
+  */
+  EventMailbox(const char* droppedName, const char* droppedHelp)
+    : _events(droppedName, droppedHelp),
+      _isOverrun(false) {
+  }
+
+  /**
+  * @brief Makes the calling task the owner that is woken by posted events.
+  *
+  * Events posted before an owner attaches are kept, they are only not signalled.
+  */
+  void attach() {
+    _events.attachConsumer();
+  }
+
+  /**
+  * @brief Queues an event and wakes the owner.
+  *
+  * Never blocks and can be called from any task or interrupt.
+  *
+  * @param event The event to queue.
+  * @return true if the event was queued, false if the mailbox was full and it was dropped.
+  */
+  bool post(const Event& event) {
+    bool isQueued = _events.push(event);
+
+    if (!isQueued) {
+      _isOverrun.store(true, std::memory_order_release);
+    }
+
+    return isQueued;
+  }
+
+  /**
+  * @brief Takes the oldest queued event without waiting.
+  *
+  * @param event Destination for the event.
+  * @return true if an event was taken, false if the mailbox is empty.
+  */
+  bool receive(Event& event) {
+    return _events.pop(event, 0);
+  }
+
+  /**
+  * @brief Check and clear whether events were dropped since the last call.
+  *
+  * A subscriber that keeps state derived from the events should rebuild it when this returns true.
+  *
+  * @return true if at least one event was dropped.
+  */
+  bool takeOverrun() {
+    return _isOverrun.exchange(false, std::memory_order_acq_rel);
+  }
+
+private:
+  PipelineQueue<Event, Capacity> _events;  // Queued events, woken owner and dropped counter.
+  std::atomic<bool> _isOverrun;            // Set when an event was dropped.
+};
+
+/**
+* @brief Sleeps until an event is posted to any mailbox of the calling task.
+*
+* Wake-ups are shared by all mailboxes of a task, so the caller checks each of them again
+* after this returns.
+*
+* @param timeout Longest time to wait in milliseconds.
+* @return true if the task was woken by a post, false if the timeout expired.
+*/
+inline bool waitForEvents(uint32_t timeout) {
+  return ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout)) != 0;
+}
+
+/**
+* @brief Ends the fan-out of deliverEvent().
+*/
+template <typename Event>
+inline void deliverEvent(const Event& event) {
+  (void)event;
+}
+
+/**
+* @brief Posts an event to every listed mailbox, in order.
+*
+* @param event The event to deliver.
+* @param mailbox The first mailbox.
+* @param others The remaining mailboxes.
+*/
+template <typename Event, typename Mailbox, typename... Mailboxes>
+inline void deliverEvent(const Event& event, Mailbox& mailbox, Mailboxes&... others) {
+  mailbox.post(event);
+  deliverEvent(event, others...);
+}
+
+/**
+* @brief Subscribers of an event type.
+*
+* The primary template has no subscribers. Subscribing to an event type means specializing
+* this template next to the event declaration, with deliver() calling deliverEvent() on
+* the subscribed mailboxes, so every producer sees the same route.
+*/
+template <typename Event>
+struct EventRoute {
+  static void deliver(const Event& event) {
+    (void)event;
+  }
+};
+
+/**
+* @brief Publishes an event to all its subscribers.
+*
+* Never blocks and can be called from any task or interrupt.
+*
+* @param event The event to publish.
+*/
+template <typename Event>
+inline void publishEvent(const Event& event) {
+  EventRoute<Event>::deliver(event);
+}
+
+#endif
@@ -0,0 +1,101 @@
+/**
+* @file Events.h
+* @brief Declaration of the events of the internal event bus for Arduino project.
+*
+* This file contains the event types passed between subsystems over the event bus, the
+* mailboxes that subscribe to them and the routes that connect the two. Keeping all routes
+* in one place means every producer delivers an event type to the same subscribers, and a
+* new feature subscribes by adding its mailbox to a route instead of a call in the producer.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include "Arduino.h"
+#include "EventBus.h"
+#include "StatusChannel.h"
+
+// Define event mailbox parameters.
+#define EVENT_ALARM_CAPACITY 4  // Alarm changes waiting for the health report, must be a power of two.
+
+/**
+* @struct FixEvent
+* @brief Published by the acquisition stage for every GNSS solution.
+*/
+struct FixEvent {
+  uint32_t time;        // Time of the solution in milliseconds since boot.
+  uint8_t satellites;   // Satellites used in the solution.
+  bool positionValid;   // true if the solution holds a valid position.
+};
+
+/**
+* @enum LinkEnum
+* @brief Enumeration of the links reported by connectivity events.
+*/
+enum LinkEnum : byte {
+  LINK_WIFI,  // Station connection to the Wi-Fi network.
+  LINK_MQTT   // Session with the MQTT broker.
+};
+
+/**
+* @struct ConnectivityEvent
+* @brief Published when a link comes up or goes down.
+*/
+struct ConnectivityEvent {
+  LinkEnum link;   // The link that changed.
+  bool connected;  // true if the link came up.
+};
+
+/**
+* @struct AlarmEvent
+* @brief Published by the health monitor when the set of active alarms changes.
+*/
+struct AlarmEvent {
+  uint8_t alarms;   // Active HealthAlarmEnum flags.
+  uint8_t raised;   // Flags raised by this change.
+  uint8_t cleared;  // Flags cleared by this change.
+};
+
+// Status events, consumed by the status indicator thread.
+extern EventMailbox<StatusEvent, STATUS_EVENT_CAPACITY> statusMailbox;
+
+// Alarm changes, consumed by the health report in the loop task.
+extern EventMailbox<AlarmEvent, EVENT_ALARM_CAPACITY> healthAlarmMailbox;
+
+template <>
+struct EventRoute<StatusEvent> {
+  static void deliver(const StatusEvent& event) {
+    deliverEvent(event, statusMailbox);
+  }
+};
+
+template <>
+struct EventRoute<AlarmEvent> {
+  static void deliver(const AlarmEvent& event) {
+    deliverEvent(event, healthAlarmMailbox);
+  }
+};
+
+// FixEvent and ConnectivityEvent have no subscribers yet, publishing them costs nothing.
+
+#endif
@@ -0,0 +1,196 @@
+/**
+* @file FixedString.h
+* @brief Declaration of the fixed-capacity string for Arduino project.
+*
+* This file contains a string type that keeps its characters in an array of a capacity
+* fixed at compile time. Appending never allocates heap memory; text that does not fit
+* is truncated and the string remembers it. It replaces Arduino String wherever text is
+* built in steady-state operation, so weeks of uptime cannot fragment the heap.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#ifndef FIXED_STRING_H
+#define FIXED_STRING_H
+
+#include "Arduino.h"
+#include <stdarg.h>
+
+template <size_t Capacity>
+class FixedString {
+  static_assert(Capacity >= 2 && Capacity <= UINT16_MAX, "FixedString capacity must be between 2 and 65535.");
+
+public:
+  /**
+  * @brief Constructs an empty string.
+  */
+  FixedString()
+    : _length(0), _isTruncated(false) {
+    _buffer[0] = '\0';
+  }
+
+  /**
+  * @brief Constructs a string holding a copy of a C-style string.
+  *
+  * @param text The text to copy, truncated if it does not fit.
+  */
+  FixedString(const char* text)
+    : FixedString() {
+    append(text);
+  }
+
+  /**
+  * @brief Empties the string and clears the truncation flag.
+  */
+  void clear() {
+    _length = 0;
+    _isTruncated = false;
+    _buffer[0] = '\0';
+  }
+
+  /**
+  * @brief Appends a C-style string.
+  *
+  * @param text The text to append.
+  * @return true if the whole text fit, false if it was truncated.
+  */
+  bool append(const char* text) {
+    while (*text != '\0') {
+      if (!append(*text++)) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  /**
+  * @brief Appends a single character.
+  *
+  * @param character The character to append.
+  * @return true if the character fit, false if the string is full.
+  */
+  bool append(char character) {
+    if ((size_t)_length + 1 >= Capacity) {
+      _isTruncated = true;
+      return false;
+    }
+
+    _buffer[_length++] = character;
+    _buffer[_length] = '\0';
+    return true;
+  }
+
+  /**
+  * @brief Appends formatted text, like printf().
+  *
+  * Integer conversions never allocate. Avoid floating point conversions, newlib allocates
+  * conversion buffers for them; use appendDecimal() instead.
+  *
+  * @param format The format string.
+  * @return true if the whole text fit, false if it was truncated.
+  */
+  bool appendf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(_buffer + _length, Capacity - _length, format, args);
+    va_end(args);
+
+    if (length < 0) {
+      _buffer[_length] = '\0';
+      _isTruncated = true;
+      return false;
+    }
+
+    if ((size_t)_length + length >= Capacity) {
+      _length = Capacity - 1;
+      _isTruncated = true;
+      return false;
+    }
+
+    _length += length;
+    return true;
+  }
+
+  /**
+  * @brief Appends a fixed-point value as a decimal number, without floating point.
+  *
+  * The value is rounded half away from zero, e.g. appendDecimal(123456789, 7, 6) appends
+  * "12.345679".
+  *
+  * @param value The value, scaled by 10^scale.
+  * @param scale Number of decimal digits in the value, up to 9.
+  * @param decimals Number of decimal digits to print, up to scale.
+  * @return true if the whole number fit, false if it was truncated.
+  */
+  bool appendDecimal(int32_t value, uint8_t scale, uint8_t decimals) {
+    uint32_t divisor = 1;
+
+    for (uint8_t i = decimals; i < scale; ++i) {
+      divisor *= 10;
+    }
+
+    uint32_t magnitude = value < 0 ? 0U - (uint32_t)value : (uint32_t)value;
+    uint32_t rounded = magnitude / divisor + (magnitude % divisor >= (divisor + 1) / 2 && divisor > 1 ? 1 : 0);
+
+    uint32_t unit = 1;
+
+    for (uint8_t i = 0; i < decimals; ++i) {
+      unit *= 10;
+    }
+
+    const char* sign = value < 0 && rounded != 0 ? "-" : "";
+
+    if (decimals == 0) {
+      return appendf("%s%u", sign, (unsigned int)rounded);
+    }
+
+    return appendf("%s%u.%0*u", sign, (unsigned int)(rounded / unit), decimals, (unsigned int)(rounded % unit));
+  }
+
+  const char* c_str() const {
+    return _buffer;
+  }
+
+  size_t length() const {
+    return _length;
+  }
+
+  /**
+  * @brief Check if any append did not fit since construction or the last clear().
+  *
+  * @return true if text was lost.
+  */
+  bool isTruncated() const {
+    return _isTruncated;
+  }
+
+  static constexpr size_t capacity() {
+    return Capacity;
+  }
+
+private:
+  uint16_t _length;
+  bool _isTruncated;
+  char _buffer[Capacity];
+};
+
+#endif
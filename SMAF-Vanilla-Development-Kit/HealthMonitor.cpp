@@ -0,0 +1,327 @@
+/**
+* @file HealthMonitor.cpp
+* @brief Implementation of the heap, stack and CPU-load health monitor for Arduino project.
+*
+* This file contains the implementation of a low-priority sampler that periodically
+* measures heap, stack and CPU usage. Summary figures go into the metrics registry, the
+* full per-task sample is kept for the health report, and alarms are logged whenever a
+* threshold is crossed in either direction.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Arduino.h"
+#include "HealthMonitor.h"
+#include "Metrics.h"
+#include "Helpers.h"
+#include "Events.h"
+#include "esp_heap_caps.h"
+
+/**
+* @struct TaskHealth
+* @brief Health figures of a single task.
+*/
+struct TaskHealth {
+  char name[configMAX_TASK_NAME_LEN];  // Task name.
+  uint32_t stackHeadroom;              // Stack never used since the task started, in bytes.
+  uint8_t cpuShare;                    // Share of the total CPU time in the last interval, in percent.
+};
+
+/**
+* @struct HealthSample
+* @brief Result of a single health sample.
+*/
+struct HealthSample {
+  uint32_t freeHeap;                     // Free heap in bytes.
+  uint32_t minimumFreeHeap;              // Lowest free heap since boot in bytes.
+  uint32_t largestFreeBlock;             // Largest allocatable block in bytes.
+  uint8_t fragmentation;                 // Free heap not usable as one block, in percent.
+  uint8_t cpuLoad;                       // Time not spent in the idle tasks, in percent.
+  uint8_t alarms;                        // Active HealthAlarmEnum flags.
+  uint8_t taskCount;                     // Number of valid task entries.
+  TaskHealth tasks[HEALTH_MAX_TASKS];    // Per-task figures.
+};
+
+// Last sample, written by the sampler thread and copied by readers under the lock.
+static HealthSample lastSample;
+static portMUX_TYPE sampleLock = portMUX_INITIALIZER_UNLOCKED;
+
+// Handle of the sampler thread, null until initHealthMonitor() is called.
+static TaskHandle_t healthThreadHandle = NULL;
+
+// Statically allocated stack and control block of the sampler thread.
+static StackType_t healthThreadStack[HEALTH_THREAD_STACK_SIZE];
+static StaticTask_t healthThreadBuffer;
+
+// Health metrics.
+static MetricGauge largestFreeBlockGauge("smaf_heap_largest_block_bytes", "Largest allocatable heap block.");
+static MetricGauge fragmentationGauge("smaf_heap_fragmentation_percent", "Free heap not usable as one block.");
+static MetricGauge cpuLoadGauge("smaf_cpu_load_percent", "CPU time not spent in the idle tasks.");
+static MetricGauge stackHeadroomGauge("smaf_stack_min_headroom_bytes", "Smallest unused stack of any task.");
+static MetricGauge alarmGauge("smaf_health_alarms", "Active health alarm flags.");
+static MetricCounter alarmCount("smaf_health_alarms_total", "Health alarms raised.");
+
+/**
+* @brief Measures the heap and fills the heap figures of a sample.
+*
+* @param sample Destination sample.
+*/
+static void sampleHeap(HealthSample& sample) {
+  sample.freeHeap = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+  sample.minimumFreeHeap = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+  sample.largestFreeBlock = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+  sample.fragmentation = sample.freeHeap == 0 ? 0 : 100 - (uint8_t)((uint64_t)sample.largestFreeBlock * 100 / sample.freeHeap);
+}
+
+/**
+* @brief Measures every task and fills the task figures of a sample.
+*
+* CPU shares are computed from the run-time counter increase since the previous sample.
+* They are 0 in the first sample and when the run-time statistics are not compiled in.
+*
+* @param sample Destination sample.
+* @return Name of the task with the least unused stack, or nullptr if there are no tasks.
+*/
+static const char* sampleTasks(HealthSample& sample) {
+  static TaskStatus_t taskStatus[HEALTH_MAX_TASKS];
+
+  uint32_t totalRunTime = 0;
+  UBaseType_t taskCount = uxTaskGetSystemState(taskStatus, HEALTH_MAX_TASKS, &totalRunTime);
+
+#if configGENERATE_RUN_TIME_STATS
+  static TaskHandle_t previousHandles[HEALTH_MAX_TASKS];
+  static uint32_t previousRunTimes[HEALTH_MAX_TASKS];
+  static uint32_t previousTotalRunTime = 0;
+
+  // The run-time counter of every core advances with the total, so shares add up to the core count.
+  uint64_t interval = (uint64_t)(totalRunTime - previousTotalRunTime) * portNUM_PROCESSORS;
+  uint32_t idleTime = 0;
+#endif
+
+  const char* tightestTask = nullptr;
+  uint32_t tightestHeadroom = UINT32_MAX;
+
+  for (UBaseType_t i = 0; i < taskCount; ++i) {
+    TaskHealth& task = sample.tasks[i];
+    strlcpy(task.name, taskStatus[i].pcTaskName, sizeof(task.name));
+
+    // ESP-IDF measures stack in bytes.
+    task.stackHeadroom = taskStatus[i].usStackHighWaterMark;
+    task.cpuShare = 0;
+
+#if configGENERATE_RUN_TIME_STATS
+    // Tasks are matched by handle, new tasks get a share from the next sample on.
+    for (UBaseType_t j = 0; j < HEALTH_MAX_TASKS; ++j) {
+      if (previousHandles[j] == taskStatus[i].xHandle && previousTotalRunTime != 0 && interval != 0) {
+        uint32_t taskTime = taskStatus[i].ulRunTimeCounter - previousRunTimes[j];
+        task.cpuShare = (uint8_t)min((uint64_t)100, (uint64_t)taskTime * 100 / interval);
+
+        if (strncmp(task.name, "IDLE", 4) == 0) {
+          idleTime += taskTime;
+        }
+
+        break;
+      }
+    }
+#endif
+
+    if (task.stackHeadroom < tightestHeadroom) {
+      tightestHeadroom = task.stackHeadroom;
+      tightestTask = task.name;
+    }
+  }
+
+  sample.cpuLoad = 0;
+
+#if configGENERATE_RUN_TIME_STATS
+  if (previousTotalRunTime != 0 && interval != 0) {
+    sample.cpuLoad = 100 - (uint8_t)min((uint64_t)100, (uint64_t)idleTime * 100 / interval);
+  }
+
+  for (UBaseType_t i = 0; i < HEALTH_MAX_TASKS; ++i) {
+    previousHandles[i] = i < taskCount ? taskStatus[i].xHandle : NULL;
+    previousRunTimes[i] = i < taskCount ? taskStatus[i].ulRunTimeCounter : 0;
+  }
+
+  previousTotalRunTime = totalRunTime;
+#endif
+
+  sample.taskCount = taskCount;
+  stackHeadroomGauge.set(tightestTask == nullptr ? 0 : tightestHeadroom);
+
+  return tightestTask;
+}
+
+/**
+* @brief Logs and publishes alarms that were raised or cleared since the previous sample.
+*
+* @param sample The new sample.
+* @param previousAlarms Alarm flags of the previous sample.
+* @param tightestTask Name of the task with the least unused stack.
+*/
+static void reportAlarmChanges(const HealthSample& sample, uint8_t previousAlarms, const char* tightestTask) {
+  uint8_t raised = sample.alarms & ~previousAlarms;
+  uint8_t cleared = previousAlarms & ~sample.alarms;
+
+  if (raised & HEALTH_ALARM_LOW_HEAP) {
+    debug(ERR, "Health alarm: free heap %u bytes is below %u bytes.", (unsigned int)sample.freeHeap, HEALTH_MIN_FREE_HEAP);
+  }
+
+  if (raised & HEALTH_ALARM_FRAGMENTATION) {
+    debug(ERR, "Health alarm: heap fragmentation %u%% is above %u%%, largest block %u bytes.", sample.fragmentation, HEALTH_MAX_FRAGMENTATION, (unsigned int)sample.largestFreeBlock);
+  }
+
+  if (raised & HEALTH_ALARM_LOW_STACK) {
+    debug(ERR, "Health alarm: task '%s' has less than %u bytes of unused stack.", tightestTask, HEALTH_MIN_STACK_HEADROOM);
+  }
+
+  if (cleared != 0) {
+    debug(SCS, "Health alarms cleared, flags 0x%02x.", cleared);
+  }
+
+  for (uint8_t flag = 1; flag != 0; flag <<= 1) {
+    if (raised & flag) {
+      alarmCount.increment();
+    }
+  }
+
+  if (raised != 0 || cleared != 0) {
+    AlarmEvent event = { sample.alarms, raised, cleared };
+    publishEvent(event);
+  }
+}
+
+/**
+* @brief Thread function for sampling device health.
+*
+* @param pvParameters Pointer to task parameters (not used in this function).
+*/
+static void HealthMonitorThread(void* pvParameters) {
+  static HealthSample sample;
+  TickType_t lastWakeTime = xTaskGetTickCount();
+
+  for (;;) {
+    sampleHeap(sample);
+    const char* tightestTask = sampleTasks(sample);
+
+    sample.alarms = HEALTH_ALARM_NONE;
+
+    if (sample.freeHeap < HEALTH_MIN_FREE_HEAP) {
+      sample.alarms |= HEALTH_ALARM_LOW_HEAP;
+    }
+
+    if (sample.fragmentation > HEALTH_MAX_FRAGMENTATION) {
+      sample.alarms |= HEALTH_ALARM_FRAGMENTATION;
+    }
+
+    if (tightestTask != nullptr && stackHeadroomGauge.value() < HEALTH_MIN_STACK_HEADROOM) {
+      sample.alarms |= HEALTH_ALARM_LOW_STACK;
+    }
+
+    reportAlarmChanges(sample, lastSample.alarms, tightestTask);
+
+    largestFreeBlockGauge.set(sample.largestFreeBlock);
+    fragmentationGauge.set(sample.fragmentation);
+    cpuLoadGauge.set(sample.cpuLoad);
+    alarmGauge.set(sample.alarms);
+
+    portENTER_CRITICAL(&sampleLock);
+    lastSample = sample;
+    portEXIT_CRITICAL(&sampleLock);
+
+    vTaskDelayUntil(&lastWakeTime, pdMS_TO_TICKS(HEALTH_SAMPLE_INTERVAL));
+  }
+}
+
+/**
+* @brief Starts the health monitor thread.
+*
+* The first sample is taken right away, later samples every HEALTH_SAMPLE_INTERVAL.
+*/
+void initHealthMonitor() {
+  if (healthThreadHandle != NULL) {
+    return;
+  }
+
+  healthThreadHandle = xTaskCreateStaticPinnedToCore(
+    HealthMonitorThread,       // Function to implement the task.
+    "HealthThread",            // Name of the task.
+    HEALTH_THREAD_STACK_SIZE,  // Stack size in words.
+    NULL,                      // Task input parameter.
+    HEALTH_THREAD_PRIORITY,    // Priority of the task.
+    healthThreadStack,         // Stack buffer.
+    &healthThreadBuffer,       // Task control block.
+    tskNO_AFFINITY             // Run on whichever core is idle.
+  );
+}
+
+/**
+* @brief Get the alarms raised by the last sample.
+*
+* @return Bitwise OR of HealthAlarmEnum flags.
+*/
+uint8_t getHealthAlarms() {
+  return (uint8_t)alarmGauge.value();
+}
+
+/**
+* @brief Format the last sample as a JSON health report.
+*
+* The report holds heap figures, total CPU load, active alarms, and one
+* [name, stack headroom in bytes, CPU share in percent] entry per task.
+*
+* @param buffer Destination buffer.
+* @param size Size of the destination buffer.
+* @return Number of characters written, excluding the terminator.
+*/
+size_t formatHealthJson(char* buffer, size_t size) {
+  if (size < 4) {
+    return 0;
+  }
+
+  // One copy is shared, reports are formatted from the loop task only.
+  static HealthSample sample;
+
+  portENTER_CRITICAL(&sampleLock);
+  sample = lastSample;
+  portEXIT_CRITICAL(&sampleLock);
+
+  size_t length = 0;
+
+  if (!appendJson(buffer, size - 1, length, "{\"heap\":{\"free\":%u,\"min\":%u,\"largest\":%u,\"frag\":%u},\"cpu\":%u,\"alarms\":%u,\"tasks\":[",
+                  (unsigned int)sample.freeHeap, (unsigned int)sample.minimumFreeHeap, (unsigned int)sample.largestFreeBlock,
+                  sample.fragmentation, sample.cpuLoad, sample.alarms)) {
+    return 0;
+  }
+
+  for (uint8_t i = 0; i < sample.taskCount; ++i) {
+    // Keep room for the closing brackets of the array and the object.
+    if (!appendJson(buffer, size - 1, length, "%s[\"%s\",%u,%u]", i == 0 ? "" : ",", sample.tasks[i].name, (unsigned int)sample.tasks[i].stackHeadroom, sample.tasks[i].cpuShare)) {
+      break;
+    }
+  }
+
+  buffer[length++] = ']';
+  buffer[length++] = '}';
+  buffer[length] = '\0';
+
+  return length;
+}
@@ -0,0 +1,86 @@
+/**
+* @file HealthMonitor.h
+* @brief Declaration of the heap, stack and CPU-load health monitor for Arduino project.
+*
+* This file contains the declarations of the functions of a low-priority sampler that
+* periodically measures free heap, the largest free block, heap fragmentation, per-task
+* stack high-water marks and per-task CPU share from the FreeRTOS run-time statistics.
+* Alarms are raised when a threshold is crossed, so that memory exhaustion is reported
+* while the device is still running rather than after a watchdog reset.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#ifndef HEALTH_MONITOR_H
+#define HEALTH_MONITOR_H
+
+#include "Arduino.h"
+
+// Define health monitor parameters.
+#define HEALTH_SAMPLE_INTERVAL 5000    // Interval between samples in milliseconds.
+#define HEALTH_REPORT_INTERVAL 60000   // Interval between published health reports in milliseconds.
+#define HEALTH_MAX_TASKS 32            // Maximum number of tasks tracked per sample.
+#define HEALTH_THREAD_STACK_SIZE 3072  // Stack size of the sampler thread.
+#define HEALTH_THREAD_PRIORITY 1       // Lowest priority above the idle task.
+
+// Define health alarm thresholds.
+#define HEALTH_MIN_FREE_HEAP 24576      // Free heap below this many bytes raises an alarm.
+#define HEALTH_MAX_FRAGMENTATION 60     // Fragmentation above this percentage raises an alarm.
+#define HEALTH_MIN_STACK_HEADROOM 512   // Unused stack below this many bytes in any task raises an alarm.
+
+/**
+* @enum HealthAlarmEnum
+* @brief Bit flags of the active health alarms.
+*/
+enum HealthAlarmEnum : byte {
+  HEALTH_ALARM_NONE = 0,                // No alarm active.
+  HEALTH_ALARM_LOW_HEAP = 1 << 0,       // Free heap below HEALTH_MIN_FREE_HEAP.
+  HEALTH_ALARM_FRAGMENTATION = 1 << 1,  // Fragmentation above HEALTH_MAX_FRAGMENTATION.
+  HEALTH_ALARM_LOW_STACK = 1 << 2       // A task has less than HEALTH_MIN_STACK_HEADROOM unused stack.
+};
+
+/**
+* @brief Starts the health monitor thread.
+*
+* The first sample is taken right away, later samples every HEALTH_SAMPLE_INTERVAL.
+*/
+void initHealthMonitor();
+
+/**
+* @brief Get the alarms raised by the last sample.
+*
+* @return Bitwise OR of HealthAlarmEnum flags.
+*/
+uint8_t getHealthAlarms();
+
+/**
+* @brief Format the last sample as a JSON health report.
+*
+* The report holds heap figures, total CPU load, active alarms, and one
+* [name, stack headroom in bytes, CPU share in percent] entry per task.
+*
+* @param buffer Destination buffer.
+* @param size Size of the destination buffer.
+* @return Number of characters written, excluding the terminator.
+*/
+size_t formatHealthJson(char* buffer, size_t size);
+
+#endif
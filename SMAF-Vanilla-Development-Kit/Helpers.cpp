@@ -29,52 +29,6 @@
 #include "Helpers.h"
 #include "esp_task_wdt.h"
 
-// Define the variable for message type.
-MessageTypeEnum messageType = LOG;
-
-/**
-* @brief Debugging function to print messages with different types.
-*
-* This function prints debug messages to the Serial monitor with a specified message type.
-*
-* @param messageType The type of the message (LOG, ERR, SCS, CMD).
-* @param format The format string for the message.
-* @param ... Additional arguments to be formatted.
-*/
-void debug(MessageTypeEnum messageType, const char *format, ...) {
-  // Set up an empty string to store the message type as a string
-  String messageTypeStr;
-
-  // Switch statement to determine the message type string based on the input byte
-  switch (messageType) {
-    case LOG:
-      messageTypeStr = "LOG";  // For LOG, set the message type string to "LOG".
-      break;
-
-    case ERR:
-      messageTypeStr = "ERROR";  // For ERR, set the message type string to "ERROR".
-      break;
-
-    case SCS:
-      messageTypeStr = "OK";  // For SCS, set the message type string to "OK".
-      break;
-
-    case CMD:
-      messageTypeStr = "CMD";  // For CMD, set the message type string to "CMD".
-      break;
-  }
-
-  // Format the variable arguments directly.
-  va_list args;
-  va_start(args, format);
-  char buffer[256];  // Adjust the buffer size according to your needs.
-  vsnprintf(buffer, sizeof(buffer), format, args);
-  va_end(args);
-
-  // Print the formatted debug message to the Serial monitor.
-  Serial.printf("CORE-%02d | %5s | %s\n\r", xPortGetCoreID(), messageTypeStr.c_str(), buffer);
-}
-
 /**
 * @brief Initializes the ESP32 Watchdog Timer with specified timeout and panic behavior.
 *
@@ -113,61 +67,81 @@ void initWatchdog(uint32_t timeout, bool panic) {
 }
 
 /**
-* @brief Resets the ESP32 Watchdog Timer.
-*
-* This function resets the ESP32 Watchdog Timer, preventing it from triggering a
-* reset due to a timeout. It is typically used to indicate that the program is
-* still executing as expected and to avoid unintended system resets.
-*
-* @note It is recommended to reset the Watchdog Timer periodically within the
-*       program to prevent it from timing out and triggering a system reset.
+* @brief Check if a C-style string is empty.
+* 
+* @param str Pointer to the C-style string to check.
+* 
+* @return true if the string is empty (either a null pointer or the first character is '\0'), false otherwise.
 */
-void resetWatchdog() {
-  // Reset WDT.
-  esp_task_wdt_reset();
-
-  // Log the status in the terminal.
-  debug(LOG, "Watchdog reset.");
+bool isEmpty(const char* str) {
+  return str == nullptr || str[0] == '\0';
 }
 
 /**
-* @brief Suspends the ESP32 Watchdog Timer.
+* @brief Releases an I2C bus that a peripheral holds low.
 *
-* This function disables the ESP32 Watchdog Timer, temporarily suspending its monitoring
-* of the program execution. It is useful in scenarios where certain operations or tasks
-* may take longer than the Watchdog Timer's timeout duration and need to be exempt from
-* triggering a watchdog reset.
+* A peripheral that was reset in the middle of a transfer can keep SDA low while it waits
+* for clock pulses. This function clocks SCL until SDA is released and then generates a
+* stop condition. The I2C driver must be stopped before calling it.
 *
-* @note It is important to resume the Watchdog Timer using resumeWatchdog() after
-*       completing the critical operations to avoid unintended system resets.
+* @param sdaPin The pin connected to SDA.
+* @param sclPin The pin connected to SCL.
+* @return true if SDA is released, false if it is still held low.
 */
-void suspendWatchdog() {
-  // Disable WDT.
-  esp_task_wdt_delete(NULL);
+bool clearI2cBus(uint8_t sdaPin, uint8_t sclPin) {
+  pinMode(sdaPin, INPUT_PULLUP);
+  pinMode(sclPin, OUTPUT_OPEN_DRAIN);
+  digitalWrite(sclPin, HIGH);
+
+  // Nine clock pulses shift out any byte a peripheral is still sending.
+  for (uint8_t i = 0; i < 9 && digitalRead(sdaPin) == LOW; ++i) {
+    digitalWrite(sclPin, LOW);
+    delayMicroseconds(5);
+    digitalWrite(sclPin, HIGH);
+    delayMicroseconds(5);
+  }
 
-  // Log the status in the terminal.
-  debug(LOG, "Watchdog suspended.");
-}
+  // Generate a stop condition, SDA rising while SCL is high.
+  pinMode(sdaPin, OUTPUT_OPEN_DRAIN);
+  digitalWrite(sdaPin, LOW);
+  delayMicroseconds(5);
+  digitalWrite(sdaPin, HIGH);
+  delayMicroseconds(5);
 
-/**
-* @brief Check if a C-style string is empty.
-* 
-* @param str Pointer to the C-style string to check.
-* 
-* @return true if the string is empty (either a null pointer or the first character is '\0'), false otherwise.
-*/
-bool isEmpty(const char* str) {
-  return str == nullptr || str[0] == '\0';
+  pinMode(sdaPin, INPUT_PULLUP);
+  pinMode(sclPin, INPUT_PULLUP);
+
+  return digitalRead(sdaPin) == HIGH;
 }
 
 /**
-* @brief Encloses the given string within double quotes.
+* @brief Appends formatted text to a JSON buffer.
 *
-* This function takes a string `data` and returns it enclosed within double quotes.
+* The text is either appended whole or not at all, and one character is always kept
+* free for a closing bracket or brace.
 *
-* @param data The string to be enclosed within double quotes.
-* @return A String containing the input `data` enclosed within double quotes.
+* @param buffer Destination buffer.
+* @param size Size of the destination buffer.
+* @param length Current length of the buffer contents, updated on success.
+* @param format The format string for the text.
+* @param ... Additional arguments to be formatted.
+* @return true if the text was appended.
 */
-String quotation(String data) {
-  return "\"" + data + "\"";
-}
\ No newline at end of file
+bool appendJson(char* buffer, size_t size, size_t& length, const char* format, ...) {
+  if (length + 2 > size) {
+    return false;
+  }
+
+  va_list args;
+  va_start(args, format);
+  int written = vsnprintf(buffer + length, size - length - 1, format, args);
+  va_end(args);
+
+  if (written < 0 || length + written >= size - 1) {
+    buffer[length] = '\0';
+    return false;
+  }
+
+  length += written;
+  return true;
+}
@@ -31,34 +31,14 @@
 #include "Arduino.h"
 #include "esp_task_wdt.h"
 #include "esp_system.h"
+#include "Logger.h"
 
 // Define a macro for comparing version numbers
 #define VERSION_CHECK(major, minor, patch) ((major)*10000 + (minor)*100 + (patch))
 
-/**
-* @enum messageTypeEnum
-* @brief Enumeration for message types used in the project.
-*
-* This enumeration defines different message types for logging purposes.
-*/
-enum MessageTypeEnum : byte {
-  LOG,  // Info type. INFO message type displayed.
-  ERR,  // Error type. ERROR message type displayed.
-  SCS,  // Success type. OK message type displayed.
-  CMD   // Command type. CMD message type displayed.
-};
-
-extern MessageTypeEnum messageType;  // Declare the variable.
-
-/**
-* @brief Debugging function to print messages with different types.
-*
-* This function prints debug messages to the Serial monitor with a specified message type.
-*
-* @param messageType The type of the message (CLR, ERR, SCS, CMD).
-* @param message The message to be printed.
-*/
-void debug(MessageTypeEnum messageType, const char *format, ...);
+// Define constants for ESP32 core numbers.
+#define ESP32_CORE_PRIMARY 0    // Numeric value representing the primary core, runs Wi-Fi and TCP/IP.
+#define ESP32_CORE_SECONDARY 1  // Numeric value representing the secondary core, runs the Arduino loop task.
 
 /**
 * @brief Initializes the ESP32 Watchdog Timer with specified timeout and panic behavior.
@@ -74,31 +54,6 @@ void debug(MessageTypeEnum messageType, const char *format, ...);
 */
 void initWatchdog(uint32_t timeout, bool panic);
 
-/**
-* @brief Resets the ESP32 Watchdog Timer.
-*
-* This function resets the ESP32 Watchdog Timer, preventing it from triggering a
-* reset due to a timeout. It is typically used to indicate that the program is
-* still executing as expected and to avoid unintended system resets.
-*
-* @note It is recommended to reset the Watchdog Timer periodically within the
-*       program to prevent it from timing out and triggering a system reset.
-*/
-void resetWatchdog();
-
-/**
-* @brief Suspends the ESP32 Watchdog Timer.
-*
-* This function disables the ESP32 Watchdog Timer, temporarily suspending its monitoring
-* of the program execution. It is useful in scenarios where certain operations or tasks
-* may take longer than the Watchdog Timer's timeout duration and need to be exempt from
-* triggering a watchdog reset.
-*
-* @note It is important to resume the Watchdog Timer using resumeWatchdog() after
-*       completing the critical operations to avoid unintended system resets.
-*/
-void suspendWatchdog();
-
 /**
 * @brief Check if a C-style string is empty.
 * 
@@ -109,13 +64,31 @@ void suspendWatchdog();
 bool isEmpty(const char* str);
 
 /**
-* @brief Encloses the given string within double quotes.
+* @brief Releases an I2C bus that a peripheral holds low.
+*
+* A peripheral that was reset in the middle of a transfer can keep SDA low while it waits
+* for clock pulses. This function clocks SCL until SDA is released and then generates a
+* stop condition. The I2C driver must be stopped before calling it.
+*
+* @param sdaPin The pin connected to SDA.
+* @param sclPin The pin connected to SCL.
+* @return true if SDA is released, false if it is still held low.
+*/
+bool clearI2cBus(uint8_t sdaPin, uint8_t sclPin);
+
+/**
+* @brief Appends formatted text to a JSON buffer.
 *
-* This function takes a string `data` and returns it enclosed within double quotes.
+* The text is either appended whole or not at all, and one character is always kept
+* free for a closing bracket or brace.
 *
-* @param data The string to be enclosed within double quotes.
-* @return A String containing the input `data` enclosed within double quotes.
+* @param buffer Destination buffer.
+* @param size Size of the destination buffer.
+* @param length Current length of the buffer contents, updated on success.
+* @param format The format string for the text.
+* @param ... Additional arguments to be formatted.
+* @return true if the text was appended.
 */
-String quotation(String data);
+bool appendJson(char* buffer, size_t size, size_t& length, const char* format, ...) __attribute__((format(printf, 4, 5)));
 
 #endif
\ No newline at end of file
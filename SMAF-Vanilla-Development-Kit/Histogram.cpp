@@ -0,0 +1,182 @@
+/**
+* @file Histogram.cpp
+* @brief Implementation of the log-linear histogram for Arduino project.
+*
+* This file contains the implementation of a fixed-bucket histogram used to aggregate
+* durations and latencies on the device. Every power of two is split into a few linear
+* sub-buckets, so the relative error stays bounded over the whole 32-bit range while
+* the memory footprint stays constant. Recording a value is a single atomic increment,
+* which makes the histogram safe to update from several tasks and cores.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Arduino.h"
+#include "Histogram.h"
+
+/**
+* @brief Constructs an empty histogram.
+*/
+LogLinearHistogram::LogLinearHistogram()
+  : _max(0) {
+  for (uint16_t i = 0; i < HISTOGRAM_BUCKET_COUNT; ++i) {
+    _buckets[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+/**
+* @brief Records a value.
+*
+* This function increments the bucket that holds the value with a single relaxed atomic
+* operation. It never blocks and can be called from any task or interrupt.
+*
+* @param value The value to record, for example a duration in cycles or microseconds.
+*/
+void LogLinearHistogram::record(uint32_t value) {
+  _buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+
+  // Raise the maximum only when needed, most values never touch it.
+  uint32_t currentMax = _max.load(std::memory_order_relaxed);
+
+  while (value > currentMax && !_max.compare_exchange_weak(currentMax, value, std::memory_order_relaxed)) {
+  }
+}
+
+/**
+* @brief Copies the current counts into a snapshot.
+*
+* @param snapshot Destination for the copied counts.
+* @param reset If true, the counts are cleared while copying, which starts a new window.
+*/
+void LogLinearHistogram::snapshot(HistogramSnapshot& snapshot, bool reset) {
+  snapshot.count = 0;
+
+  for (uint16_t i = 0; i < HISTOGRAM_BUCKET_COUNT; ++i) {
+    snapshot.buckets[i] = reset ? _buckets[i].exchange(0, std::memory_order_relaxed) : _buckets[i].load(std::memory_order_relaxed);
+    snapshot.count += snapshot.buckets[i];
+  }
+
+  snapshot.max = reset ? _max.exchange(0, std::memory_order_relaxed) : _max.load(std::memory_order_relaxed);
+}
+
+/**
+* @brief Get the bucket index that holds a value.
+*
+* Values below HISTOGRAM_SUB_BUCKETS get their own bucket. Larger values are grouped by
+* their most significant bit, and each group is split linearly by the next bits.
+*
+* @param value The value to look up.
+* @return The bucket index, from 0 to HISTOGRAM_BUCKET_COUNT - 1.
+*/
+uint16_t LogLinearHistogram::bucketIndex(uint32_t value) {
+  if (value < HISTOGRAM_SUB_BUCKETS) {
+    return value;
+  }
+
+  uint8_t mostSignificantBit = 31 - __builtin_clz(value);
+  uint8_t subBucket = (value >> (mostSignificantBit - HISTOGRAM_SUB_BUCKET_BITS)) & (HISTOGRAM_SUB_BUCKETS - 1);
+
+  return (mostSignificantBit - HISTOGRAM_SUB_BUCKET_BITS + 1) * HISTOGRAM_SUB_BUCKETS + subBucket;
+}
+
+/**
+* @brief Get the smallest value that falls into a bucket.
+*
+* @param index The bucket index.
+* @return The inclusive lower bound of the bucket.
+*/
+uint32_t LogLinearHistogram::bucketLowerBound(uint16_t index) {
+  if (index < HISTOGRAM_SUB_BUCKETS) {
+    return index;
+  }
+
+  uint8_t group = index / HISTOGRAM_SUB_BUCKETS;
+  uint8_t subBucket = index % HISTOGRAM_SUB_BUCKETS;
+
+  return (uint32_t)(HISTOGRAM_SUB_BUCKETS + subBucket) << (group - 1);
+}
+
+/**
+* @brief Get the largest value that falls into a bucket.
+*
+* @param index The bucket index.
+* @return The inclusive upper bound of the bucket.
+*/
+uint32_t LogLinearHistogram::bucketUpperBound(uint16_t index) {
+  if (index >= HISTOGRAM_BUCKET_COUNT - 1) {
+    return UINT32_MAX;
+  }
+
+  return bucketLowerBound(index + 1) - 1;
+}
+
+/**
+* @brief Estimate a percentile from the bucket counts.
+*
+* @param percentile The percentile to estimate, from 0 to 100.
+* @return Upper bound of the bucket holding the percentile, capped at the recorded maximum.
+*         Returns 0 if the snapshot is empty.
+*/
+uint32_t HistogramSnapshot::percentile(float percentile) const {
+  if (count == 0) {
+    return 0;
+  }
+
+  // Rank of the requested value, rounded up so that p100 lands on the last value.
+  uint32_t rank = (uint32_t)((percentile / 100.0f) * count + 0.999f);
+  rank = constrain(rank, (uint32_t)1, count);
+
+  uint32_t cumulative = 0;
+
+  for (uint16_t i = 0; i < HISTOGRAM_BUCKET_COUNT; ++i) {
+    cumulative += buckets[i];
+
+    if (cumulative >= rank) {
+      uint32_t upperBound = LogLinearHistogram::bucketUpperBound(i);
+      return upperBound < max ? upperBound : max;
+    }
+  }
+
+  return max;
+}
+
+/**
+* @brief Estimate the mean from the bucket counts.
+*
+* @return Mean of the bucket midpoints weighted by their counts, or 0 if the snapshot is empty.
+*/
+uint32_t HistogramSnapshot::mean() const {
+  if (count == 0) {
+    return 0;
+  }
+
+  uint64_t sum = 0;
+
+  for (uint16_t i = 0; i < HISTOGRAM_BUCKET_COUNT; ++i) {
+    if (buckets[i] != 0) {
+      uint64_t lower = LogLinearHistogram::bucketLowerBound(i);
+      uint64_t upper = LogLinearHistogram::bucketUpperBound(i);
+      sum += ((lower + upper) / 2) * buckets[i];
+    }
+  }
+
+  return (uint32_t)(sum / count);
+}
@@ -0,0 +1,123 @@
+/**
+* @file Histogram.h
+* @brief Declaration of the log-linear histogram for Arduino project.
+*
+* This file contains the declaration of a fixed-bucket histogram used to aggregate
+* durations and latencies on the device. Every power of two is split into a few linear
+* sub-buckets, so the relative error stays bounded over the whole 32-bit range while
+* the memory footprint stays constant. Recording a value is a single atomic increment,
+* which makes the histogram safe to update from several tasks and cores.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include "Arduino.h"
+#include <atomic>
+
+// Define histogram bucket layout.
+#define HISTOGRAM_SUB_BUCKET_BITS 2                                // Linear sub-buckets per power of two, as bits.
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BUCKET_BITS)     // Linear sub-buckets per power of two.
+#define HISTOGRAM_BUCKET_COUNT ((32 - HISTOGRAM_SUB_BUCKET_BITS + 1) * HISTOGRAM_SUB_BUCKETS)  // Buckets covering 0 to UINT32_MAX.
+
+/**
+* @struct HistogramSnapshot
+* @brief Plain copy of histogram counts used for reporting.
+*/
+struct HistogramSnapshot {
+  uint32_t buckets[HISTOGRAM_BUCKET_COUNT];  // Number of values per bucket.
+  uint32_t count;                            // Total number of values.
+  uint32_t max;                              // Largest recorded value.
+
+  /**
+  * @brief Estimate a percentile from the bucket counts.
+  *
+  * @param percentile The percentile to estimate, from 0 to 100.
+  * @return Upper bound of the bucket holding the percentile, capped at the recorded maximum.
+  *         Returns 0 if the snapshot is empty.
+  */
+  uint32_t percentile(float percentile) const;
+
+  /**
+  * @brief Estimate the mean from the bucket counts.
+  *
+  * @return Mean of the bucket midpoints weighted by their counts, or 0 if the snapshot is empty.
+  */
+  uint32_t mean() const;
+};
+
+class LogLinearHistogram {
+public:
+  /**
+  * @brief Constructs an empty histogram.
+  */
+  LogLinearHistogram();
+
+  /**
+  * @brief Records a value.
+  *
+  * This function increments the bucket that holds the value with a single relaxed atomic
+  * operation. It never blocks and can be called from any task or interrupt.
+  *
+  * @param value The value to record, for example a duration in cycles or microseconds.
+  */
+  void record(uint32_t value);
+
+  /**
+  * @brief Copies the current counts into a snapshot.
+  *
+  * @param snapshot Destination for the copied counts.
+  * @param reset If true, the counts are cleared while copying, which starts a new window.
+  */
+  void snapshot(HistogramSnapshot& snapshot, bool reset);
+
+  /**
+  * @brief Get the bucket index that holds a value.
+  *
+  * @param value The value to look up.
+  * @return The bucket index, from 0 to HISTOGRAM_BUCKET_COUNT - 1.
+  */
+  static uint16_t bucketIndex(uint32_t value);
+
+  /**
+  * @brief Get the smallest value that falls into a bucket.
+  *
+  * @param index The bucket index.
+  * @return The inclusive lower bound of the bucket.
+  */
+  static uint32_t bucketLowerBound(uint16_t index);
+
+  /**
+  * @brief Get the largest value that falls into a bucket.
+  *
+  * @param index The bucket index.
+  * @return The inclusive upper bound of the bucket.
+  */
+  static uint32_t bucketUpperBound(uint16_t index);
+
+private:
+  std::atomic<uint32_t> _buckets[HISTOGRAM_BUCKET_COUNT];
+  std::atomic<uint32_t> _max;
+};
+
+#endif
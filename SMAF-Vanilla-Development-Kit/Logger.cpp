@@ -0,0 +1,347 @@
+/**
+* @file Logger.cpp
+* @brief Implementation of the asynchronous logger for Arduino project.
+*
+* This file contains the implementation of the logging functions used in the Arduino project.
+* Messages are formatted into fixed-size records and stored in a lock-free ring buffer.
+* A low-priority thread drains the buffer to the Serial monitor, so the caller never
+* waits for the UART. When the buffer is full, messages are dropped and counted instead
+* of blocking the caller.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Arduino.h"
+#include "Logger.h"
+#include "RingBuffer.h"
+#include <atomic>
+
+// Define the variable for message type.
+MessageTypeEnum messageType = LOG;
+
+/**
+* @struct LogRecord
+* @brief Fixed-size log record stored in the ring buffer.
+*/
+struct LogRecord {
+  MessageTypeEnum type;  // Message type.
+  uint8_t core;          // Core that produced the message.
+#if LOG_BINARY_MODE
+  uint8_t length;                            // Length of the encoded arguments.
+  uint32_t formatId;                         // Compile-time ID of the format string.
+  uint32_t timestamp;                        // Milliseconds since boot.
+  uint8_t payload[LOG_RECORD_PAYLOAD_SIZE];  // Encoded arguments.
+#else
+  char text[LOG_RECORD_TEXT_SIZE];  // Formatted message.
+#endif
+};
+
+// Ring buffer shared by all producers and the logger thread.
+static RingBuffer<LogRecord, LOG_RING_CAPACITY> logBuffer;
+
+// Number of messages dropped because the ring buffer was full.
+static std::atomic<uint32_t> droppedLogCount(0);
+
+// Handle of the logger thread, null until initLogger() is called.
+static TaskHandle_t loggerThreadHandle = NULL;
+
+// Stack and control block of the logger thread, allocated statically to stay off the heap.
+static StackType_t loggerThreadStack[LOG_THREAD_STACK_SIZE];
+static StaticTask_t loggerThreadBuffer;
+
+/**
+* @brief Get the display name of a message type.
+*
+* @param messageType The type of the message (LOG, ERR, SCS, CMD).
+* @return Constant string displayed in the Serial monitor.
+*/
+static const char *messageTypeName(MessageTypeEnum messageType) {
+  switch (messageType) {
+    case ERR:
+      return "ERROR";
+    case SCS:
+      return "OK";
+    case CMD:
+      return "CMD";
+    default:
+      return "LOG";
+  }
+}
+
+#if LOG_BINARY_MODE
+/**
+* @brief Writes a single binary log frame to the Serial monitor.
+*
+* Frame layout: sync byte, payload length, type and core, format ID, timestamp, payload,
+* and an XOR checksum over everything after the sync byte. Multi-byte fields are little-endian.
+*
+* @param record The record to write.
+*/
+static void printLogFrame(const LogRecord &record) {
+  uint8_t frame[LOG_RECORD_PAYLOAD_SIZE + 12];
+  size_t length = 0;
+
+  frame[length++] = LOG_FRAME_SYNC;
+  frame[length++] = record.length;
+  frame[length++] = (uint8_t)((record.type << 4) | (record.core & 0x0F));
+  memcpy(frame + length, &record.formatId, sizeof(record.formatId));
+  length += sizeof(record.formatId);
+  memcpy(frame + length, &record.timestamp, sizeof(record.timestamp));
+  length += sizeof(record.timestamp);
+  memcpy(frame + length, record.payload, record.length);
+  length += record.length;
+
+  // Checksum lets the host decoder resynchronize after corrupted or interleaved output.
+  uint8_t checksum = 0;
+
+  for (size_t i = 1; i < length; ++i) {
+    checksum ^= frame[i];
+  }
+
+  frame[length++] = checksum;
+  Serial.write(frame, length);
+}
+
+/**
+* @brief Writes the dropped message report as a binary log frame.
+*
+* @param dropCount Number of messages dropped since the last report.
+*/
+static void printDropReport(uint32_t dropCount) {
+  LogRecord record;
+  record.type = ERR;
+  record.core = xPortGetCoreID();
+  record.formatId = LOG_FORMAT_ID("Logger dropped %u messages, ring buffer full.");
+  record.timestamp = millis();
+  record.length = sizeof(dropCount);
+  memcpy(record.payload, &dropCount, sizeof(dropCount));
+  printLogFrame(record);
+}
+#else
+/**
+* @brief Prints a single log line to the Serial monitor.
+*
+* The line is assembled on the stack and written in one call, so printing does not
+* allocate memory.
+*
+* @param core The core that produced the message.
+* @param messageType The type of the message (LOG, ERR, SCS, CMD).
+* @param text The formatted message.
+*/
+static void printLogLine(uint8_t core, MessageTypeEnum messageType, const char *text) {
+  char line[LOG_RECORD_TEXT_SIZE + 24];
+
+  int length = snprintf(line, sizeof(line), "CORE-%02d | %5s | %s\n\r", core, messageTypeName(messageType), text);
+
+  if (length > 0) {
+    Serial.write(reinterpret_cast<const uint8_t *>(line), min((size_t)length, sizeof(line) - 1));
+  }
+}
+
+/**
+* @brief Prints the dropped message report as a log line.
+*
+* @param dropCount Number of messages dropped since the last report.
+*/
+static void printDropReport(uint32_t dropCount) {
+  char text[LOG_RECORD_TEXT_SIZE];
+  snprintf(text, sizeof(text), "Logger dropped %u messages, ring buffer full.", (unsigned int)dropCount);
+  printLogLine(xPortGetCoreID(), ERR, text);
+}
+#endif
+
+/**
+* @brief Prints all pending records and reports dropped messages.
+*
+* @return true if at least one record was printed.
+*/
+static bool drainLogBuffer() {
+  // Shared by the logger thread and flushLogger() callers.
+  static std::atomic<uint32_t> reportedDropCount(0);
+  LogRecord record;
+  bool printed = false;
+
+  while (logBuffer.pop(record)) {
+#if LOG_BINARY_MODE
+    printLogFrame(record);
+#else
+    printLogLine(record.core, record.type, record.text);
+#endif
+    printed = true;
+  }
+
+  // Report messages lost since the last report.
+  // Each drop is reported once, by whichever caller moves the reported count past it.
+  uint32_t dropCount = droppedLogCount.load(std::memory_order_relaxed);
+  uint32_t reported = reportedDropCount.load(std::memory_order_relaxed);
+
+  while ((int32_t)(dropCount - reported) > 0 && !reportedDropCount.compare_exchange_weak(reported, dropCount, std::memory_order_relaxed)) {
+  }
+
+  if ((int32_t)(dropCount - reported) > 0) {
+    printDropReport(dropCount - reported);
+  }
+
+  return printed;
+}
+
+/**
+* @brief Thread function for draining the log ring buffer.
+*
+* The thread sleeps until a producer wakes it, then prints every pending record.
+*
+* @param pvParameters Pointer to task parameters (not used in this function).
+*/
+static void LoggerThread(void *pvParameters) {
+  for (;;) {
+    // Sleep until a new record is committed. The timeout catches wake-ups lost before start.
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+    drainLogBuffer();
+  }
+}
+
+/**
+* @brief Wakes the logger thread after a record has been committed.
+*/
+static void wakeLoggerThread() {
+  if (loggerThreadHandle == NULL) {
+    return;
+  }
+
+  if (xPortInIsrContext()) {
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+    vTaskNotifyGiveFromISR(loggerThreadHandle, &higherPriorityTaskWoken);
+    portYIELD_FROM_ISR(higherPriorityTaskWoken);
+  } else {
+    xTaskNotifyGive(loggerThreadHandle);
+  }
+}
+
+#if LOG_BINARY_MODE
+/**
+* @brief Stores an encoded message into a ring buffer record.
+*
+* This function copies the encoded arguments into a free ring buffer record and wakes the
+* logger thread. It never blocks. If no record is free, the message is dropped and counted.
+* Use debug() instead of calling this function directly.
+*
+* @param messageType The type of the message (LOG, ERR, SCS, CMD).
+* @param formatId The compile-time ID of the format string.
+* @param payload The encoded arguments.
+* @param length The length of the encoded arguments in bytes.
+*/
+void logWriteBinary(MessageTypeEnum messageType, uint32_t formatId, const uint8_t *payload, size_t length) {
+  LogRecord *record = logBuffer.claim();
+
+  if (record == nullptr) {
+    droppedLogCount.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  record->type = messageType;
+  record->core = xPortGetCoreID();
+  record->formatId = formatId;
+  record->timestamp = millis();
+  record->length = min(length, sizeof(record->payload));
+  memcpy(record->payload, payload, record->length);
+
+  logBuffer.commit(record);
+  wakeLoggerThread();
+}
+#else
+/**
+* @brief Formats a message into a ring buffer record.
+*
+* This function formats the message directly into a free ring buffer record and wakes the
+* logger thread. It never blocks. If no record is free, the message is dropped and counted.
+* Formatting is not safe in interrupts, so messages from an interrupt are dropped and
+* counted as well; only binary mode logs from interrupts. Use debug() instead of calling
+* this function directly.
+*
+* @param messageType The type of the message (LOG, ERR, SCS, CMD).
+* @param format The format string for the message.
+* @param ... Additional arguments to be formatted.
+*/
+void logWrite(MessageTypeEnum messageType, const char *format, ...) {
+  LogRecord *record = xPortInIsrContext() ? nullptr : logBuffer.claim();
+
+  if (record == nullptr) {
+    droppedLogCount.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  record->type = messageType;
+  record->core = xPortGetCoreID();
+
+  // Format the variable arguments directly into the record.
+  va_list args;
+  va_start(args, format);
+  vsnprintf(record->text, sizeof(record->text), format, args);
+  va_end(args);
+
+  logBuffer.commit(record);
+  wakeLoggerThread();
+}
+#endif
+
+/**
+* @brief Starts the logger thread.
+*
+* This function creates the low-priority thread that drains the ring buffer to the Serial
+* monitor. Messages logged before this call are kept in the buffer and printed once the
+* thread starts. Serial must be initialized before calling this function.
+*/
+void initLogger() {
+  if (loggerThreadHandle != NULL) {
+    return;
+  }
+
+  loggerThreadHandle = xTaskCreateStaticPinnedToCore(
+    LoggerThread,           // Function to implement the task.
+    "LoggerThread",         // Name of the task.
+    LOG_THREAD_STACK_SIZE,  // Stack size in words.
+    NULL,                   // Task input parameter.
+    LOG_THREAD_PRIORITY,    // Priority of the task.
+    loggerThreadStack,      // Stack buffer.
+    &loggerThreadBuffer,    // Task control block.
+    tskNO_AFFINITY          // Run on whichever core is idle.
+  );
+}
+
+/**
+* @brief Prints all pending messages from the calling thread.
+*
+* This function drains the ring buffer synchronously. It is intended for use right before
+* a deliberate restart, so that the last messages are not lost.
+*/
+void flushLogger() {
+  drainLogBuffer();
+  Serial.flush();
+}
+
+/**
+* @brief Get the number of messages dropped because the ring buffer was full.
+*
+* @return Total number of dropped messages since boot.
+*/
+uint32_t getDroppedLogCount() {
+  return droppedLogCount.load(std::memory_order_relaxed);
+}
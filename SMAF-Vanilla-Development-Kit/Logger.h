@@ -0,0 +1,319 @@
+/**
+* @file Logger.h
+* @brief Declaration of the asynchronous logger for Arduino project.
+*
+* This file contains the declarations of the logging functions used in the Arduino project.
+* Messages are formatted into fixed-size records and stored in a lock-free ring buffer.
+* A low-priority thread drains the buffer to the Serial monitor, so the caller never
+* waits for the UART. When the buffer is full, messages are dropped and counted instead
+* of blocking the caller.
+*
+* @note Message types below LOG_LEVEL_THRESHOLD are removed at compile time, together
+*       with their format strings and argument evaluation.
+*
+* @note With LOG_BINARY_MODE enabled, records hold a compile-time format string ID and
+*       the raw arguments instead of formatted text. Format strings are not stored in the
+*       firmware at all. Use tools/smaf_log_decoder.py on the host to rebuild the text.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include "Arduino.h"
+#include <type_traits>
+
+// Minimum message severity compiled into the firmware (0 = LOG, 1 = CMD, 2 = SCS, 3 = ERR).
+// Override with a build flag, e.g. -DLOG_LEVEL_THRESHOLD=2 keeps only OK and ERROR messages.
+#ifndef LOG_LEVEL_THRESHOLD
+#define LOG_LEVEL_THRESHOLD 0
+#endif
+
+// Store format string IDs and raw arguments instead of text (0 = text, 1 = binary).
+#ifndef LOG_BINARY_MODE
+#define LOG_BINARY_MODE 0
+#endif
+
+// Define logger buffer dimensions.
+#define LOG_RING_CAPACITY 32        // Number of records in the ring buffer. Must be a power of two.
+#define LOG_RECORD_TEXT_SIZE 120    // Maximum formatted message length per record, including terminator.
+#define LOG_RECORD_PAYLOAD_SIZE 48  // Maximum encoded argument length per binary record.
+
+// Define binary log frame markers.
+#define LOG_FRAME_SYNC 0xA5  // First byte of every binary log frame.
+
+// Define logger thread parameters.
+#define LOG_THREAD_STACK_SIZE 3072  // Stack size of the drain thread.
+#define LOG_THREAD_PRIORITY 1       // Lowest priority above the idle task.
+
+/**
+* @enum messageTypeEnum
+* @brief Enumeration for message types used in the project.
+*
+* This enumeration defines different message types for logging purposes.
+*/
+enum MessageTypeEnum : byte {
+  LOG,  // Info type. INFO message type displayed.
+  ERR,  // Error type. ERROR message type displayed.
+  SCS,  // Success type. OK message type displayed.
+  CMD   // Command type. CMD message type displayed.
+};
+
+extern MessageTypeEnum messageType;  // Declare the variable.
+
+/**
+* @brief Get the severity of a message type.
+*
+* @param messageType The type of the message (LOG, ERR, SCS, CMD).
+* @return Severity used for compile-time filtering. Higher is more important.
+*/
+constexpr uint8_t messageSeverity(MessageTypeEnum messageType) {
+  return messageType == ERR ? 3 : (messageType == SCS ? 2 : (messageType == CMD ? 1 : 0));
+}
+
+/**
+* @brief Check if a message type is compiled into the firmware.
+*
+* @param messageType The type of the message (LOG, ERR, SCS, CMD).
+* @return true if the severity of the message type reaches LOG_LEVEL_THRESHOLD.
+*/
+constexpr bool isMessageTypeEnabled(MessageTypeEnum messageType) {
+  return messageSeverity(messageType) >= LOG_LEVEL_THRESHOLD;
+}
+
+/**
+* @brief Computes the 32-bit FNV-1a hash of a format string.
+*
+* The hash identifies a format string in binary log records. The host decoder computes
+* the same hash over the format strings found in the sources.
+*
+* @param format The format string.
+* @param hash The running hash value.
+* @return The hash of the format string.
+*/
+constexpr uint32_t logFormatId(const char *format, uint32_t hash = 2166136261UL) {
+  return *format == '\0' ? hash : logFormatId(format + 1, (hash ^ (uint8_t)*format) * 16777619UL);
+}
+
+// Format string ID, forced to be evaluated at compile time.
+#define LOG_FORMAT_ID(format) (std::integral_constant<uint32_t, logFormatId(format)>::value)
+
+#if LOG_BINARY_MODE
+/**
+* @brief Stores an encoded message into a ring buffer record.
+*
+* This function copies the encoded arguments into a free ring buffer record and wakes the
+* logger thread. It never blocks. If no record is free, the message is dropped and counted.
+* Use debug() instead of calling this function directly.
+*
+* @param messageType The type of the message (LOG, ERR, SCS, CMD).
+* @param formatId The compile-time ID of the format string.
+* @param payload The encoded arguments.
+* @param length The length of the encoded arguments in bytes.
+*/
+void logWriteBinary(MessageTypeEnum messageType, uint32_t formatId, const uint8_t *payload, size_t length);
+#else
+/**
+* @brief Formats a message into a ring buffer record.
+*
+* This function formats the message directly into a free ring buffer record and wakes the
+* logger thread. It never blocks. If no record is free, the message is dropped and counted.
+* Formatting is not safe in interrupts, so messages from an interrupt are dropped and
+* counted as well; only binary mode logs from interrupts. Use debug() instead of calling
+* this function directly.
+*
+* @param messageType The type of the message (LOG, ERR, SCS, CMD).
+* @param format The format string for the message.
+* @param ... Additional arguments to be formatted.
+*/
+void logWrite(MessageTypeEnum messageType, const char *format, ...);
+#endif
+
+/**
+* @brief Encodes printf arguments into a compact little-endian byte stream.
+*
+* Integers up to 32 bits and pointers take 4 bytes, 64-bit integers and floating point
+* values take 8 bytes, and strings are copied with their terminator. The host decoder
+* walks the format string and consumes the same number of bytes per conversion.
+*/
+class LogArgumentEncoder {
+public:
+  LogArgumentEncoder(uint8_t *buffer, size_t capacity)
+    : _buffer(buffer), _capacity(capacity), _length(0) {}
+
+  template <typename T>
+  typename std::enable_if<(std::is_integral<T>::value || std::is_enum<T>::value) && sizeof(T) <= 4>::type
+  encode(T value) {
+    uint32_t word = std::is_signed<T>::value ? (uint32_t)(int32_t)value : (uint32_t)value;
+    writeBytes(&word, sizeof(word));
+  }
+
+  template <typename T>
+  typename std::enable_if<std::is_integral<T>::value && (sizeof(T) > 4)>::type
+  encode(T value) {
+    uint64_t word = (uint64_t)value;
+    writeBytes(&word, sizeof(word));
+  }
+
+  template <typename T>
+  typename std::enable_if<std::is_floating_point<T>::value>::type
+  encode(T value) {
+    double number = value;
+    writeBytes(&number, sizeof(number));
+  }
+
+  void encode(const char *value) {
+    if (value == nullptr) {
+      value = "(null)";
+    }
+
+    // Copy as much of the string as fits, always keeping the terminator.
+    size_t length = strnlen(value, LOG_RECORD_PAYLOAD_SIZE);
+    size_t available = _capacity > _length ? _capacity - _length : 0;
+
+    if (available == 0) {
+      return;
+    }
+
+    if (length >= available) {
+      length = available - 1;
+    }
+
+    memcpy(_buffer + _length, value, length);
+    _buffer[_length + length] = '\0';
+    _length += length + 1;
+  }
+
+  void encode(char *value) {
+    encode(static_cast<const char *>(value));
+  }
+
+  void encode(const void *value) {
+    uint32_t word = (uint32_t)(uintptr_t)value;
+    writeBytes(&word, sizeof(word));
+  }
+
+  void encodeAll() {}
+
+  template <typename First, typename... Rest>
+  void encodeAll(First first, Rest... rest) {
+    encode(first);
+    encodeAll(rest...);
+  }
+
+  size_t length() const {
+    return _length;
+  }
+
+private:
+  uint8_t *_buffer;
+  size_t _capacity;
+  size_t _length;
+
+  void writeBytes(const void *data, size_t size) {
+    if (_length + size > _capacity) {
+      _length = _capacity;  // Mark the payload as truncated, no further arguments fit.
+      return;
+    }
+
+    memcpy(_buffer + _length, data, size);
+    _length += size;
+  }
+};
+
+/**
+* @brief Compile-time dispatcher for debug messages.
+*
+* The enabled specialization forwards to logWrite() or logWriteBinary(). The disabled
+* specialization has an empty body, so filtered messages leave no code or format strings
+* in the firmware.
+*/
+template <bool Enabled>
+struct LogDispatch {
+#if LOG_BINARY_MODE
+  template <typename... Args>
+  static inline void writeBinary(MessageTypeEnum messageType, uint32_t formatId, Args... args) {
+    uint8_t payload[LOG_RECORD_PAYLOAD_SIZE];
+    LogArgumentEncoder encoder(payload, sizeof(payload));
+    encoder.encodeAll(args...);
+    logWriteBinary(messageType, formatId, payload, encoder.length());
+  }
+#else
+  template <typename... Args>
+  static inline void write(MessageTypeEnum messageType, const char *format, Args... args) {
+    logWrite(messageType, format, args...);
+  }
+#endif
+};
+
+template <>
+struct LogDispatch<false> {
+  template <typename... Args>
+  static inline void write(MessageTypeEnum, const char *, Args...) {}
+
+  template <typename... Args>
+  static inline void writeBinary(MessageTypeEnum, uint32_t, Args...) {}
+};
+
+/**
+* @brief Debugging function to print messages with different types.
+*
+* This function queues debug messages for the Serial monitor with a specified message type.
+* The message type must be a constant so that filtering can happen at compile time, and
+* the format must be a string literal so that its ID can be computed at compile time.
+* In text mode, call it from tasks only: messages from interrupts are dropped and counted.
+*
+* @param messageType The type of the message (LOG, ERR, SCS, CMD).
+* @param format The format string for the message.
+* @param ... Additional arguments to be formatted.
+*/
+#if LOG_BINARY_MODE
+#define debug(messageType, format, ...) LogDispatch<isMessageTypeEnabled(messageType)>::writeBinary(messageType, LOG_FORMAT_ID(format), ##__VA_ARGS__)
+#else
+#define debug(messageType, ...) LogDispatch<isMessageTypeEnabled(messageType)>::write(messageType, __VA_ARGS__)
+#endif
+
+/**
+* @brief Starts the logger thread.
+*
+* This function creates the low-priority thread that drains the ring buffer to the Serial
+* monitor. Messages logged before this call are kept in the buffer and printed once the
+* thread starts. Serial must be initialized before calling this function.
+*/
+void initLogger();
+
+/**
+* @brief Prints all pending messages from the calling thread.
+*
+* This function drains the ring buffer synchronously. It is intended for use right before
+* a deliberate restart, so that the last messages are not lost.
+*/
+void flushLogger();
+
+/**
+* @brief Get the number of messages dropped because the ring buffer was full.
+*
+* @return Total number of dropped messages since boot.
+*/
+uint32_t getDroppedLogCount();
+
+#endif
@@ -0,0 +1,351 @@
+/**
+* @file Metrics.cpp
+* @brief Implementation of the metrics registry and exporter for Arduino project.
+*
+* This file contains the implementation of the lock-free metrics registry and of the
+* exporter that serves it. Registration links a metric into a singly linked list with a
+* compare-and-swap, so metrics defined in any source file register themselves during static
+* initialization. The exporter walks the list from the loop task only, and never blocks it.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Arduino.h"
+#include "Metrics.h"
+#include "Helpers.h"
+#include <stdarg.h>
+
+// Head of the registry. Constant-initialized, so it is valid before any metric constructor runs.
+static std::atomic<Metric*> metricRegistryHead(nullptr);
+
+// System metrics, refreshed right before every export.
+static MetricGauge uptimeGauge("smaf_uptime_seconds", "Time since boot.");
+static MetricGauge freeHeapGauge("smaf_heap_free_bytes", "Free heap memory.");
+static MetricGauge minimumFreeHeapGauge("smaf_heap_min_free_bytes", "Lowest free heap memory since boot.");
+static MetricGauge droppedLogGauge("smaf_log_dropped_messages", "Debug messages dropped because the log buffer was full.");
+
+// Snapshot shared by all histograms, metrics are exported from the loop task only.
+static HistogramSnapshot exportSnapshot;
+
+/**
+* @brief Small output buffer that batches formatted text into few stream writes.
+*/
+class MetricsWriter {
+public:
+  MetricsWriter(Print& output)
+    : _output(output), _length(0) {}
+
+  ~MetricsWriter() {
+    flush();
+  }
+
+  void printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+    va_list args;
+
+    for (uint8_t attempt = 0; attempt < 2; ++attempt) {
+      va_start(args, format);
+      int length = vsnprintf(_buffer + _length, sizeof(_buffer) - _length, format, args);
+      va_end(args);
+
+      if (length < 0) {
+        return;
+      }
+
+      if (_length + length < sizeof(_buffer)) {
+        _length += length;
+        return;
+      }
+
+      // The line did not fit. Send what is buffered and retry once with an empty buffer.
+      if (_length == 0) {
+        _length = sizeof(_buffer) - 1;  // Longer than the whole buffer, keep it truncated.
+        return;
+      }
+
+      flush();
+    }
+  }
+
+  void flush() {
+    if (_length > 0) {
+      _output.write(reinterpret_cast<const uint8_t*>(_buffer), _length);
+      _length = 0;
+    }
+  }
+
+private:
+  Print& _output;
+  char _buffer[256];
+  size_t _length;
+};
+
+/**
+* @brief Updates the system metrics that are sampled rather than counted.
+*/
+static void refreshSystemMetrics() {
+  uptimeGauge.set(millis() / 1000);
+  freeHeapGauge.set(ESP.getFreeHeap());
+  minimumFreeHeapGauge.set(ESP.getMinFreeHeap());
+  droppedLogGauge.set(getDroppedLogCount());
+}
+
+/**
+* @brief Registers the metric.
+*
+* The metric is pushed onto the registry list with a compare-and-swap, so registration
+* needs no lock and is safe during static initialization.
+*
+* @param name Metric name in Prometheus style, e.g. "smaf_mqtt_publish_total".
+* @param help One-line description shown in the scrape output.
+* @param type Type of the metric.
+*/
+Metric::Metric(const char* name, const char* help, MetricTypeEnum type)
+  : _name(name), _help(help), _type(type), _next(nullptr) {
+  Metric* head = metricRegistryHead.load(std::memory_order_relaxed);
+
+  do {
+    _next = head;
+  } while (!metricRegistryHead.compare_exchange_weak(head, this, std::memory_order_release, std::memory_order_relaxed));
+}
+
+/**
+* @brief Get the first registered metric.
+*
+* @return The most recently registered metric, or nullptr if none are registered.
+*/
+Metric* Metric::first() {
+  return metricRegistryHead.load(std::memory_order_acquire);
+}
+
+/**
+* @brief Constructor for MetricsExporter class.
+*
+* @param serverPort The port of the Prometheus scrape endpoint.
+*/
+MetricsExporter::MetricsExporter(uint16_t serverPort)
+  : _server(serverPort, 1) {
+  _request[0] = '\0';
+}
+
+/**
+* @brief Start the scrape endpoint.
+*
+* @note Call this method once the network interface is up.
+*/
+void MetricsExporter::begin() {
+  if (_started) {
+    return;
+  }
+
+  _server.begin();
+  _started = true;
+
+  debug(SCS, "Metrics endpoint listening on port %d.", METRICS_SERVER_PORT);
+}
+
+/**
+* @brief Serve a pending scrape request, if any.
+*
+* This method never waits for a client. A client that connects is given
+* METRICS_REQUEST_TIMEOUT to send its request before it is dropped.
+*/
+void MetricsExporter::handleClient() {
+  if (!_started) {
+    return;
+  }
+
+  // Accept a new client only when the previous one is done.
+  if (!_client) {
+    _client = _server.accept();
+
+    if (!_client) {
+      return;
+    }
+
+    _requestLength = 0;
+    _terminatorMatch = 0;
+    _clientDeadline = millis() + METRICS_REQUEST_TIMEOUT;
+  }
+
+  if (readRequest()) {
+    sendResponse();
+  } else if ((int32_t)(millis() - _clientDeadline) >= 0) {
+    debug(ERR, "Metrics client timed out before completing its request.");
+    _client.stop();
+  }
+}
+
+/**
+* @brief Reads the pending request bytes of the current client.
+*
+* @return true once the end of the request headers has been received.
+*/
+bool MetricsExporter::readRequest() {
+  static const char terminator[] = "\r\n\r\n";
+
+  while (_client.available() > 0) {
+    char c = (char)_client.read();
+
+    // Keep the start of the request line, the rest of the headers is not needed.
+    if (_requestLength < sizeof(_request) - 1) {
+      _request[_requestLength++] = c;
+      _request[_requestLength] = '\0';
+    }
+
+    // Track the blank line that ends the headers, restarting the match on a mismatch.
+    if (c == terminator[_terminatorMatch]) {
+      _terminatorMatch++;
+    } else {
+      _terminatorMatch = (c == '\r') ? 1 : 0;
+    }
+
+    if (_terminatorMatch == sizeof(terminator) - 1) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+* @brief Sends the response for the received request and closes the connection.
+*/
+void MetricsExporter::sendResponse() {
+  if (strncmp(_request, "GET /metrics ", 13) == 0 || strncmp(_request, "GET / ", 6) == 0) {
+    _client.print("HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nConnection: close\r\n\r\n");
+    writePrometheus(_client);
+  } else {
+    _client.print("HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+  }
+
+  _client.flush();
+  _client.stop();
+}
+
+/**
+* @brief Format all metrics as a compact JSON object for the MQTT stats topic.
+*
+* Counters and gauges are written as numbers, histograms as [count, p50, p99, max].
+* The "smaf_" prefix is dropped from names to keep the message short. Metrics that do
+* not fit into the buffer are left out.
+*
+* @param buffer Destination buffer.
+* @param size Size of the destination buffer.
+* @return Number of characters written, excluding the terminator.
+*/
+size_t MetricsExporter::formatJson(char* buffer, size_t size) {
+  if (size < 3) {
+    return 0;
+  }
+
+  refreshSystemMetrics();
+
+  size_t length = 0;
+  buffer[length++] = '{';
+  buffer[length] = '\0';
+
+  const char* separator = "";
+
+  for (Metric* metric = Metric::first(); metric != nullptr; metric = metric->next()) {
+    const char* name = metric->name();
+
+    if (strncmp(name, "smaf_", 5) == 0) {
+      name += 5;
+    }
+
+    bool appended = false;
+
+    switch (metric->type()) {
+      case METRIC_COUNTER:
+        appended = appendJson(buffer, size, length, "%s\"%s\":%u", separator, name, (unsigned int)static_cast<MetricCounter*>(metric)->value());
+        break;
+      case METRIC_GAUGE:
+        appended = appendJson(buffer, size, length, "%s\"%s\":%d", separator, name, (int)static_cast<MetricGauge*>(metric)->value());
+        break;
+      case METRIC_HISTOGRAM:
+        static_cast<MetricHistogram*>(metric)->snapshot(exportSnapshot);
+        appended = appendJson(buffer, size, length, "%s\"%s\":[%u,%u,%u,%u]", separator, name,
+                              (unsigned int)exportSnapshot.count,
+                              (unsigned int)exportSnapshot.percentile(50),
+                              (unsigned int)exportSnapshot.percentile(99),
+                              (unsigned int)exportSnapshot.max);
+        break;
+    }
+
+    if (appended) {
+      separator = ",";
+    }
+  }
+
+  buffer[length++] = '}';
+  buffer[length] = '\0';
+
+  return length;
+}
+
+/**
+* @brief Write all metrics in Prometheus text exposition format.
+*
+* Histograms are written with one cumulative bucket per power of two, up to the first
+* boundary that holds every value. The bucket set only grows between scrapes, which keeps
+* the series stable for rate queries. The sum is estimated from the bucket midpoints.
+*
+* @param output Destination stream, e.g. a WiFiClient.
+*/
+void MetricsExporter::writePrometheus(Print& output) {
+  refreshSystemMetrics();
+
+  MetricsWriter writer(output);
+
+  for (Metric* metric = Metric::first(); metric != nullptr; metric = metric->next()) {
+    const char* name = metric->name();
+
+    switch (metric->type()) {
+      case METRIC_COUNTER:
+        writer.printf("# HELP %s %s\n# TYPE %s counter\n", name, metric->help(), name);
+        writer.printf("%s %u\n", name, (unsigned int)static_cast<MetricCounter*>(metric)->value());
+        break;
+      case METRIC_GAUGE:
+        writer.printf("# HELP %s %s\n# TYPE %s gauge\n", name, metric->help(), name);
+        writer.printf("%s %d\n", name, (int)static_cast<MetricGauge*>(metric)->value());
+        break;
+      case METRIC_HISTOGRAM: {
+        static_cast<MetricHistogram*>(metric)->snapshot(exportSnapshot);
+        writer.printf("# HELP %s %s\n# TYPE %s histogram\n", name, metric->help(), name);
+
+        uint32_t cumulative = 0;
+
+        for (uint16_t i = 0; i < HISTOGRAM_BUCKET_COUNT - 1 && cumulative < exportSnapshot.count; ++i) {
+          cumulative += exportSnapshot.buckets[i];
+
+          if (i % HISTOGRAM_SUB_BUCKETS == HISTOGRAM_SUB_BUCKETS - 1) {
+            writer.printf("%s_bucket{le=\"%u\"} %u\n", name, (unsigned int)LogLinearHistogram::bucketUpperBound(i), (unsigned int)cumulative);
+          }
+        }
+
+        writer.printf("%s_bucket{le=\"+Inf\"} %u\n", name, (unsigned int)exportSnapshot.count);
+        writer.printf("%s_sum %llu\n", name, (unsigned long long)exportSnapshot.mean() * exportSnapshot.count);
+        writer.printf("%s_count %u\n", name, (unsigned int)exportSnapshot.count);
+        break;
+      }
+    }
+  }
+}
@@ -0,0 +1,253 @@
+/**
+* @file Metrics.h
+* @brief Declaration of the metrics registry and exporter for Arduino project.
+*
+* This file contains the declarations of the counters, gauges and histograms that any
+* subsystem can register, and of the exporter that serves them. Metrics are global objects
+* that link themselves into a lock-free registry when they are constructed. Hot-path
+* updates are single atomic operations. The exporter serves the registry in Prometheus
+* text format over HTTP and formats a compact JSON message for a periodic MQTT stats topic.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "Arduino.h"
+#include "WiFi.h"
+#include "WiFiServer.h"
+#include "Histogram.h"
+#include <atomic>
+
+// Define metrics exporter parameters.
+#define METRICS_SERVER_PORT 9100         // Port of the Prometheus scrape endpoint.
+#define METRICS_PUBLISH_INTERVAL 60000   // Interval between MQTT stats messages in milliseconds.
+#define METRICS_REQUEST_TIMEOUT 1000     // Time a scrape client has to send its request in milliseconds.
+
+/**
+* @enum MetricTypeEnum
+* @brief Enumeration of the supported metric types.
+*/
+enum MetricTypeEnum : byte {
+  METRIC_COUNTER,   // Monotonic counter.
+  METRIC_GAUGE,     // Value that can go up and down.
+  METRIC_HISTOGRAM  // Distribution of observed values.
+};
+
+/**
+* @brief Common part of every registered metric.
+*
+* Metrics are linked into the registry by their constructor and are never removed, so
+* they must have static storage duration.
+*/
+class Metric {
+public:
+  /**
+  * @brief Get the first registered metric.
+  *
+  * @return The most recently registered metric, or nullptr if none are registered.
+  */
+  static Metric* first();
+
+  /**
+  * @brief Get the next registered metric.
+  *
+  * @return The next metric in the registry, or nullptr at the end.
+  */
+  Metric* next() const {
+    return _next;
+  }
+
+  const char* name() const {
+    return _name;
+  }
+
+  const char* help() const {
+    return _help;
+  }
+
+  MetricTypeEnum type() const {
+    return _type;
+  }
+
+protected:
+  /**
+  * @brief Registers the metric.
+  *
+  * @param name Metric name in Prometheus style, e.g. "smaf_mqtt_publish_total".
+  * @param help One-line description shown in the scrape output.
+  * @param type Type of the metric.
+  */
+  Metric(const char* name, const char* help, MetricTypeEnum type);
+
+private:
+  const char* _name;
+  const char* _help;
+  MetricTypeEnum _type;
+  Metric* _next;
+};
+
+class MetricCounter : public Metric {
+public:
+  MetricCounter(const char* name, const char* help)
+    : Metric(name, help, METRIC_COUNTER), _value(0) {}
+
+  /**
+  * @brief Adds to the counter with a single atomic operation.
+  *
+  * @param amount Amount to add.
+  */
+  void increment(uint32_t amount = 1) {
+    _value.fetch_add(amount, std::memory_order_relaxed);
+  }
+
+  uint32_t value() const {
+    return _value.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<uint32_t> _value;
+};
+
+class MetricGauge : public Metric {
+public:
+  MetricGauge(const char* name, const char* help)
+    : Metric(name, help, METRIC_GAUGE), _value(0) {}
+
+  /**
+  * @brief Sets the gauge with a single atomic operation.
+  *
+  * @param value The new value.
+  */
+  void set(int32_t value) {
+    _value.store(value, std::memory_order_relaxed);
+  }
+
+  /**
+  * @brief Adds to the gauge with a single atomic operation.
+  *
+  * @param amount Amount to add, may be negative.
+  */
+  void add(int32_t amount) {
+    _value.fetch_add(amount, std::memory_order_relaxed);
+  }
+
+  int32_t value() const {
+    return _value.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<int32_t> _value;
+};
+
+class MetricHistogram : public Metric {
+public:
+  MetricHistogram(const char* name, const char* help)
+    : Metric(name, help, METRIC_HISTOGRAM) {}
+
+  /**
+  * @brief Records a value with a single atomic bucket increment.
+  *
+  * @param value The observed value, in the unit named by the metric.
+  */
+  void observe(uint32_t value) {
+    _histogram.record(value);
+  }
+
+  /**
+  * @brief Copies the cumulative counts into a snapshot.
+  *
+  * @param snapshot Destination for the copied counts.
+  */
+  void snapshot(HistogramSnapshot& snapshot) {
+    _histogram.snapshot(snapshot, false);
+  }
+
+private:
+  LogLinearHistogram _histogram;
+};
+
+class MetricsExporter {
+public:
+  /**
+  * @brief Constructor for MetricsExporter class.
+  *
+  * @param serverPort The port of the Prometheus scrape endpoint.
+  */
+  MetricsExporter(uint16_t serverPort);
+
+  /**
+  * @brief Start the scrape endpoint.
+  *
+  * @note Call this method once the network interface is up.
+  */
+  void begin();
+
+  /**
+  * @brief Serve a pending scrape request, if any.
+  *
+  * This method never waits for a client. A client that connects is given
+  * METRICS_REQUEST_TIMEOUT to send its request before it is dropped.
+  */
+  void handleClient();
+
+  /**
+  * @brief Format all metrics as a compact JSON object for the MQTT stats topic.
+  *
+  * Counters and gauges are written as numbers, histograms as [count, p50, p99, max].
+  *
+  * @param buffer Destination buffer.
+  * @param size Size of the destination buffer.
+  * @return Number of characters written, excluding the terminator.
+  */
+  size_t formatJson(char* buffer, size_t size);
+
+  /**
+  * @brief Write all metrics in Prometheus text exposition format.
+  *
+  * @param output Destination stream, e.g. a WiFiClient.
+  */
+  void writePrometheus(Print& output);
+
+private:
+  WiFiServer _server;
+  WiFiClient _client;
+  char _request[32];                  // Start of the request line, enough to match the path.
+  uint8_t _requestLength = 0;         // Number of request line characters stored.
+  uint8_t _terminatorMatch = 0;       // Number of matched characters of the blank line ending the headers.
+  uint32_t _clientDeadline = 0;       // Time by which the current client must finish its request.
+  bool _started = false;              // Whether the scrape endpoint is listening.
+
+  /**
+  * @brief Reads the pending request bytes of the current client.
+  *
+  * @return true once the end of the request headers has been received.
+  */
+  bool readRequest();
+
+  /**
+  * @brief Sends the response for the received request and closes the connection.
+  */
+  void sendResponse();
+};
+
+#endif
@@ -0,0 +1,137 @@
+/**
+* @file Pipeline.h
+* @brief Declaration of the position pipeline stages for Arduino project.
+*
+* This file contains the records and queues that connect the acquisition, encode and
+* transport stages of the position pipeline. The acquisition stage reads PVT solutions
+* from the GNSS module, the encode stage formats them into MQTT payloads, and the loop
+* task publishes the payloads. Every stage runs in its own task with its own core and
+* priority, so a slow broker no longer delays the next GNSS epoch. The stages exchange
+* fixed-size records through bounded lock-free queues, and a record that does not fit
+* is dropped and counted instead of blocking the producer.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "Arduino.h"
+#include "PipelineQueue.h"
+#include "FixedString.h"
+#include "Seqlock.h"
+#include "PublishLatency.h"
+#include "Helpers.h"
+
+// Core and priority of every pipeline stage. Override with build flags.
+// The loop task runs the transport stage on the secondary core at priority 1, the Wi-Fi and
+// TCP/IP tasks run on the primary core. Acquisition shares the secondary core with
+// transport but preempts it, so a blocking publish never delays reading an epoch. Encode
+// runs on the primary core, which is idle between network events.
+#ifndef PIPELINE_ACQUISITION_CORE
+#define PIPELINE_ACQUISITION_CORE ESP32_CORE_SECONDARY
+#endif
+
+#ifndef PIPELINE_ACQUISITION_PRIORITY
+#define PIPELINE_ACQUISITION_PRIORITY 3
+#endif
+
+#ifndef PIPELINE_ENCODE_CORE
+#define PIPELINE_ENCODE_CORE ESP32_CORE_PRIMARY
+#endif
+
+#ifndef PIPELINE_ENCODE_PRIORITY
+#define PIPELINE_ENCODE_PRIORITY 2
+#endif
+
+// GNSS navigation rate in solutions per second. Override with a build flag, e.g. 10 for benchmarks.
+#ifndef PIPELINE_NAVIGATION_RATE
+#define PIPELINE_NAVIGATION_RATE 1
+#endif
+
+// Define pipeline parameters.
+#define PIPELINE_ACQUISITION_STACK_SIZE 4096  // Stack size of the acquisition thread.
+#define PIPELINE_ENCODE_STACK_SIZE 4096       // Stack size of the encode thread.
+#define PIPELINE_QUEUE_CAPACITY 8             // Records per queue, must be a power of two.
+#define PIPELINE_PAYLOAD_SIZE 512             // Largest encoded MQTT payload including the terminator.
+#define PIPELINE_POLL_INTERVAL 10             // Time between GNSS polls while no solution is waiting, in milliseconds.
+#define PIPELINE_ENVIRONMENT_INTERVAL 2000    // Time between SHT4x readings, in milliseconds.
+#define PIPELINE_ENVIRONMENT_MAX_AGE 10000    // Oldest SHT4x reading added to a payload, in milliseconds.
+
+// MQTT payload formatted in place in the transport queue.
+typedef FixedString<PIPELINE_PAYLOAD_SIZE> PipelinePayload;
+
+/**
+* @struct PositionRecord
+* @brief PVT solution handed from the acquisition stage to the encode stage.
+*
+* Fields are ordered from the widest to the narrowest type, so the record has no padding
+* holes and is copied as a few whole words.
+*/
+struct PositionRecord {
+  uint64_t epoch;               // GNSS epoch in microseconds since 1970, or 0 if unknown.
+  int64_t time;                 // System time at read completion, in seconds since 1970.
+  LatencyRecord latency;        // Latency stamps of the record.
+  int32_t latitude;             // Latitude in degrees * 1E-7.
+  int32_t longitude;            // Longitude in degrees * 1E-7.
+  int32_t altitude;             // Altitude above mean sea level in millimeters.
+  int32_t speed;                // Ground speed in millimeters per second.
+  int32_t heading;              // Heading of motion in degrees * 1E-5.
+  uint8_t satellites;           // Satellites used in the solution.
+  bool positionValid;           // true if the solution has a position fix.
+};
+
+/**
+* @struct EncodedRecord
+* @brief MQTT payload handed from the encode stage to the transport stage.
+*
+* Records without a position fix carry no payload, they only update the device status.
+*/
+struct EncodedRecord {
+  LatencyRecord latency;    // Latency stamps of the record.
+  uint8_t satellites;       // Satellites used in the solution.
+  bool positionValid;       // true if the solution has a position fix.
+  PipelinePayload payload;  // JSON payload, empty if not encoded.
+};
+
+/**
+* @struct LatestSample
+* @brief Most recent GNSS solution and environment reading, shared through a seqlock.
+*
+* Written by the acquisition stage only. Any task can read a consistent copy at any time.
+*/
+struct LatestSample {
+  uint64_t epoch;            // GNSS epoch of the solution in microseconds since 1970, or 0 if unknown.
+  uint32_t fixTime;          // Time since boot when the solution was read, in milliseconds. 0 before the first.
+  uint32_t environmentTime;  // Time since boot of the environment reading, in milliseconds. 0 before the first.
+  int32_t latitude;          // Latitude in degrees * 1E-7.
+  int32_t longitude;         // Longitude in degrees * 1E-7.
+  int32_t altitude;          // Altitude above mean sea level in millimeters.
+  int32_t speed;             // Ground speed in millimeters per second.
+  int32_t heading;           // Heading of motion in degrees * 1E-5.
+  int32_t temperature;       // Temperature in degrees Celsius * 1E-2.
+  int32_t humidity;          // Relative humidity in percent * 1E-2.
+  uint8_t satellites;        // Satellites used in the solution.
+  bool positionValid;        // true if the solution has a position fix.
+  bool environmentValid;     // true once the SHT4x module has been read.
+};
+
+#endif
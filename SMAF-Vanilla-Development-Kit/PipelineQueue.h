@@ -0,0 +1,152 @@
+/**
+* @file PipelineQueue.h
+* @brief Declaration and implementation of the bounded queue that wakes its consumer.
+*
+* This file contains the queue used between the position pipeline stages and by the
+* mailboxes of the event bus. It is a lock-free ring buffer with a single consuming task,
+* which is woken by a task notification for every record. Producers never block: a
+* record that does not fit is dropped and counted.
+*
+* @note Producing is safe from interrupts. The implementation lives in this header
+* because the queue is a class template.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#ifndef PIPELINE_QUEUE_H
+#define PIPELINE_QUEUE_H
+
+#include "Arduino.h"
+#include "RingBuffer.h"
+#include "Metrics.h"
+#include <atomic>
+
+template <typename T, size_t Capacity>
+class PipelineQueue {
+public:
+  /**
+  * @brief Constructs an empty queue.
+  *
+  * Records queued before a consumer attaches are kept, they are only not signalled.
+  *
+  * @param droppedName Name of the counter of records dropped because the queue was full.
+  * @param droppedHelp One-line description of the counter.
+  */
+  PipelineQueue(const char* droppedName, const char* droppedHelp)
+    : _consumer(nullptr),
+      _dropped(droppedName, droppedHelp) {}
+
+  /**
+  * @brief Registers the calling task as the consumer woken by new records.
+  */
+  void attachConsumer() {
+    _consumer.store(xTaskGetCurrentTaskHandle(), std::memory_order_release);
+  }
+
+  /**
+  * @brief Claims a free record for writing in place.
+  *
+  * A full queue counts the record as dropped, the caller must not retry.
+  *
+  * @return Pointer to the claimed record, or nullptr if the queue is full.
+  */
+  T* claim() {
+    T* record = _buffer.claim();
+
+    if (record == nullptr) {
+      _dropped.increment();
+    }
+
+    return record;
+  }
+
+  /**
+  * @brief Hands a record previously returned by claim() to the consumer.
+  *
+  * @param record Pointer returned by claim().
+  */
+  void commit(T* record) {
+    _buffer.commit(record);
+
+    TaskHandle_t consumer = _consumer.load(std::memory_order_acquire);
+
+    if (consumer == nullptr) {
+      return;
+    }
+
+    if (xPortInIsrContext()) {
+      BaseType_t higherPriorityTaskWoken = pdFALSE;
+      vTaskNotifyGiveFromISR(consumer, &higherPriorityTaskWoken);
+      portYIELD_FROM_ISR(higherPriorityTaskWoken);
+    } else {
+      xTaskNotifyGive(consumer);
+    }
+  }
+
+  /**
+  * @brief Copies a record into the queue.
+  *
+  * Never blocks and can be called from any task or interrupt.
+  *
+  * @param record The record to store.
+  * @return true if the record was stored, false if the queue is full and it was dropped.
+  */
+  bool push(const T& record) {
+    T* data = claim();
+
+    if (data == nullptr) {
+      return false;
+    }
+
+    *data = record;
+    commit(data);
+    return true;
+  }
+
+  /**
+  * @brief Removes the oldest record, waiting for one if the queue is empty.
+  *
+  * Must only be called from the task registered with attachConsumer().
+  *
+  * @param record Destination for the removed record.
+  * @param timeout Time to wait for a record in milliseconds, 0 to return immediately.
+  * @return true if a record was removed, false if none arrived within the timeout.
+  */
+  bool pop(T& record, uint32_t timeout) {
+    if (_buffer.pop(record)) {
+      return true;
+    }
+
+    // A record committed after the check above leaves a notification, so none is missed.
+    if (timeout == 0 || ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout)) == 0) {
+      return false;
+    }
+
+    return _buffer.pop(record);
+  }
+
+private:
+  RingBuffer<T, Capacity> _buffer;      // Queued records.
+  std::atomic<TaskHandle_t> _consumer;  // Task woken by commits, null until attachConsumer().
+  MetricCounter _dropped;               // Records dropped because the queue was full.
+};
+
+#endif
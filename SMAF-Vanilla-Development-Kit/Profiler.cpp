@@ -0,0 +1,355 @@
+/**
+* @file Profiler.cpp
+* @brief Implementation of the sampling profiler for Arduino project.
+*
+* This file contains the implementation of the statistical profiler used in the Arduino project.
+* A hardware timer interrupt samples the interrupted program counter and task handle into a
+* RAM buffer. When the buffer is full, a low-priority thread folds identical samples together
+* and dumps them to the Serial monitor, and optionally hands them out in chunks for an MQTT
+* topic. On the host, tools/smaf_profile_to_flamegraph.py resolves the addresses against the
+* ELF file and produces folded stacks for a flame graph.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Arduino.h"
+#include "Profiler.h"
+#include "Helpers.h"
+
+#if PROFILER_ENABLED
+#include <atomic>
+
+// Offset of the program counter in the Xtensa exception frame (XT_STK_PC), in words.
+#define PROFILER_FRAME_PC_INDEX 1
+
+// Notification bits sent to the dump thread.
+#define PROFILER_NOTIFY_BUFFER_FULL (1 << 0)  // The interrupt filled the sample buffer.
+#define PROFILER_NOTIFY_PUBLISHED (1 << 1)    // All chunks have been handed out.
+
+/**
+* @enum ProfilerStateEnum
+* @brief Enumeration of the profiler buffer states.
+*/
+enum ProfilerStateEnum : byte {
+  PROFILER_SAMPLING,   // The timer interrupt is filling the buffer.
+  PROFILER_DUMPING,    // The buffer is full and being folded and dumped.
+  PROFILER_PUBLISHING  // The folded profile is waiting for chunk consumers.
+};
+
+/**
+* @struct ProfileSample
+* @brief One sample, or one folded entry after the buffer has been dumped.
+*/
+struct ProfileSample {
+  uint32_t pc;        // Interrupted program counter, 0 if not available.
+  TaskHandle_t task;  // Interrupted task.
+  uint32_t count;     // Number of identical samples.
+};
+
+// Sample buffer, folded in place after each collection.
+static ProfileSample samples[PROFILER_SAMPLE_COUNT];
+
+// Number of samples collected, or number of folded entries after folding.
+static volatile uint32_t sampleCount = 0;
+
+// Current buffer state, shared between the interrupt, the dump thread and chunk consumers.
+static std::atomic<uint8_t> profilerState(PROFILER_SAMPLING);
+
+// Index of the next folded entry handed out by profilerNextChunk().
+static uint32_t publishCursor = 0;
+
+// Handle of the dump thread.
+static TaskHandle_t profilerThreadHandle = NULL;
+
+// The dump thread never ends, keep its stack and control block out of the heap.
+static StackType_t profilerThreadStack[PROFILER_THREAD_STACK_SIZE];
+static StaticTask_t profilerThreadBuffer;
+
+// Core sampled by the timer interrupt.
+static uint8_t profiledCore = 0;
+
+/**
+* @brief Timer interrupt that records the interrupted program counter and task.
+*
+* On interrupt entry, FreeRTOS saves the exception frame of the interrupted task on its
+* stack and stores the frame address as the first field of the task control block.
+*/
+static void IRAM_ATTR profilerSampleInterrupt() {
+  if (profilerState.load(std::memory_order_relaxed) != PROFILER_SAMPLING) {
+    return;
+  }
+
+  uint32_t index = sampleCount;
+
+  if (index >= PROFILER_SAMPLE_COUNT) {
+    return;
+  }
+
+  TaskHandle_t task = xTaskGetCurrentTaskHandle();
+  uint32_t pc = 0;
+
+#if CONFIG_IDF_TARGET_ARCH_XTENSA
+  const uint32_t* frame = *reinterpret_cast<uint32_t* const*>(task);
+  pc = frame[PROFILER_FRAME_PC_INDEX];
+#endif
+
+  samples[index].pc = pc;
+  samples[index].task = task;
+  samples[index].count = 1;
+  sampleCount = index + 1;
+
+  // Hand the full buffer over to the dump thread.
+  if (index + 1 == PROFILER_SAMPLE_COUNT) {
+    profilerState.store(PROFILER_DUMPING, std::memory_order_release);
+
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+    xTaskNotifyFromISR(profilerThreadHandle, PROFILER_NOTIFY_BUFFER_FULL, eSetBits, &higherPriorityTaskWoken);
+    portYIELD_FROM_ISR(higherPriorityTaskWoken);
+  }
+}
+
+/**
+* @brief Orders samples by task and program counter.
+*/
+static int compareSamples(const void* a, const void* b) {
+  const ProfileSample* first = static_cast<const ProfileSample*>(a);
+  const ProfileSample* second = static_cast<const ProfileSample*>(b);
+
+  if (first->task != second->task) {
+    return (uintptr_t)first->task < (uintptr_t)second->task ? -1 : 1;
+  }
+
+  if (first->pc != second->pc) {
+    return first->pc < second->pc ? -1 : 1;
+  }
+
+  return 0;
+}
+
+/**
+* @brief Sorts the sample buffer and merges identical samples in place.
+*
+* @return The number of folded entries at the start of the buffer.
+*/
+static uint32_t foldSamples() {
+  uint32_t count = sampleCount;
+
+  if (count == 0) {
+    return 0;
+  }
+
+  qsort(samples, count, sizeof(ProfileSample), compareSamples);
+
+  uint32_t entries = 0;
+
+  for (uint32_t i = 1; i < count; ++i) {
+    if (samples[i].task == samples[entries].task && samples[i].pc == samples[entries].pc) {
+      samples[entries].count += samples[i].count;
+    } else {
+      samples[++entries] = samples[i];
+    }
+  }
+
+  return entries + 1;
+}
+
+/**
+* @brief Get the name of a sampled task.
+*
+* Task handles are only dereferenced if the task still exists, since a task may have been
+* deleted between sampling and dumping.
+*
+* @param task The sampled task handle.
+* @return The task name, or "deleted" if the task no longer exists.
+*/
+static const char* sampledTaskName(TaskHandle_t task) {
+#if configUSE_TRACE_FACILITY
+  static TaskStatus_t taskList[24];
+  static UBaseType_t taskCount = 0;
+  static uint32_t lastRefresh = 0;
+
+  // Refresh the task list once per dump, not once per entry.
+  if (taskCount == 0 || millis() - lastRefresh > 1000) {
+    taskCount = uxTaskGetSystemState(taskList, sizeof(taskList) / sizeof(taskList[0]), NULL);
+    lastRefresh = millis();
+  }
+
+  for (UBaseType_t i = 0; i < taskCount; ++i) {
+    if (taskList[i].xHandle == task) {
+      return taskList[i].pcTaskName;
+    }
+  }
+
+  return "deleted";
+#else
+  return task != NULL ? pcTaskGetName(task) : "deleted";
+#endif
+}
+
+/**
+* @brief Formats one folded entry as a line of text.
+*
+* @param buffer Destination buffer.
+* @param size Size of the destination buffer.
+* @param entry The folded entry.
+* @return Number of characters written, or 0 if the line does not fit.
+*/
+static size_t formatEntry(char* buffer, size_t size, const ProfileSample& entry) {
+  int length = snprintf(buffer, size, "%s;0x%08x %u\n", sampledTaskName(entry.task), (unsigned int)entry.pc, (unsigned int)entry.count);
+  return (length > 0 && (size_t)length < size) ? length : 0;
+}
+
+/**
+* @brief Writes the folded profile to the Serial monitor.
+*
+* @param entries Number of folded entries.
+*/
+static void dumpToSerial(uint32_t entries) {
+  char line[64];
+  int length = snprintf(line, sizeof(line), "PROF-BEGIN core=%u rate=%u samples=%u\n", profiledCore, PROFILER_SAMPLE_RATE, PROFILER_SAMPLE_COUNT);
+  Serial.write(reinterpret_cast<const uint8_t*>(line), length);
+
+  for (uint32_t i = 0; i < entries; ++i) {
+    memcpy(line, "PROF ", 5);
+    size_t entryLength = formatEntry(line + 5, sizeof(line) - 5, samples[i]);
+
+    if (entryLength > 0) {
+      Serial.write(reinterpret_cast<const uint8_t*>(line), entryLength + 5);
+    }
+  }
+
+  Serial.write(reinterpret_cast<const uint8_t*>("PROF-END\n"), 9);
+}
+
+/**
+* @brief Thread function for folding and dumping full sample buffers.
+*
+* @param pvParameters Pointer to task parameters (not used in this function).
+*/
+static void ProfilerThread(void* pvParameters) {
+  uint32_t notification = 0;
+
+  for (;;) {
+    // Wait for the interrupt to fill the buffer. Late publish notifications are discarded.
+    xTaskNotifyWait(0, UINT32_MAX, &notification, portMAX_DELAY);
+
+    if ((notification & PROFILER_NOTIFY_BUFFER_FULL) == 0) {
+      continue;
+    }
+
+    uint32_t entries = foldSamples();
+    dumpToSerial(entries);
+
+    // Offer the folded profile to chunk consumers.
+    sampleCount = entries;
+    publishCursor = 0;
+    profilerState.store(PROFILER_PUBLISHING, std::memory_order_release);
+    xTaskNotifyWait(0, PROFILER_NOTIFY_PUBLISHED, &notification, pdMS_TO_TICKS(PROFILER_PUBLISH_TIMEOUT));
+
+    // Start the next collection.
+    sampleCount = 0;
+    profilerState.store(PROFILER_SAMPLING, std::memory_order_release);
+  }
+}
+
+/**
+* @brief Starts the sampling profiler.
+*
+* This function creates the dump thread and starts the sampling timer on the calling core.
+* Only the core that calls this function is sampled.
+*/
+void initProfiler() {
+  if (profilerThreadHandle != NULL) {
+    return;
+  }
+
+  profiledCore = xPortGetCoreID();
+
+  profilerThreadHandle = xTaskCreateStaticPinnedToCore(
+    ProfilerThread,              // Function to implement the task.
+    "ProfilerThread",            // Name of the task.
+    PROFILER_THREAD_STACK_SIZE,  // Stack size in words.
+    NULL,                        // Task input parameter.
+    PROFILER_THREAD_PRIORITY,    // Priority of the task.
+    profilerThreadStack,         // Stack buffer.
+    &profilerThreadBuffer,       // Task control block.
+    tskNO_AFFINITY               // Run on whichever core is idle.
+  );
+
+// Check if the ESP32 core version is 3.0.0 or lower.
+// ESP32 Core changed the hardware timer API in version 3.0.0 or higher.
+#if (VERSION_CHECK(ESP_ARDUINO_VERSION_MAJOR, ESP_ARDUINO_VERSION_MINOR, ESP_ARDUINO_VERSION_PATCH) < VERSION_CHECK(3, 0, 0))
+  // ESP32 Arduino Core < 3.0
+  // Tick at 1 MHz from the 80 MHz APB clock.
+  hw_timer_t* timer = timerBegin(PROFILER_TIMER_NUMBER, 80, true);
+  timerAttachInterrupt(timer, &profilerSampleInterrupt, true);
+  timerAlarmWrite(timer, 1000000 / PROFILER_SAMPLE_RATE, true);
+  timerAlarmEnable(timer);
+#else
+  // ESP32 Arduino Core >= 3.0
+  hw_timer_t* timer = timerBegin(1000000);
+  timerAttachInterrupt(timer, &profilerSampleInterrupt);
+  timerAlarm(timer, 1000000 / PROFILER_SAMPLE_RATE, true, 0);
+#endif
+
+  // Log the status in the terminal.
+  debug(LOG, "Sampling profiler started on core %d at %d Hz.", profiledCore, PROFILER_SAMPLE_RATE);
+}
+
+/**
+* @brief Formats the next chunk of the folded profile for transmission.
+*
+* After each dump, the folded profile can be retrieved in chunks, for example to publish
+* it over MQTT from the task that owns the client. Sampling restarts when all chunks have
+* been retrieved or after PROFILER_PUBLISH_TIMEOUT.
+*
+* @param buffer Destination for the chunk text, one "task;0xpc count" line per entry.
+* @param size Size of the destination buffer.
+* @return true if a chunk was written, false if no profile is waiting.
+*/
+bool profilerNextChunk(char* buffer, size_t size) {
+  if (profilerState.load(std::memory_order_acquire) != PROFILER_PUBLISHING || size == 0) {
+    return false;
+  }
+
+  size_t length = 0;
+  buffer[0] = '\0';
+
+  while (publishCursor < sampleCount) {
+    size_t entryLength = formatEntry(buffer + length, size - length, samples[publishCursor]);
+
+    if (entryLength == 0) {
+      break;
+    }
+
+    length += entryLength;
+    publishCursor++;
+  }
+
+  // Let the dump thread restart sampling once everything has been handed out.
+  if (publishCursor >= sampleCount) {
+    profilerState.store(PROFILER_DUMPING, std::memory_order_release);
+    xTaskNotify(profilerThreadHandle, PROFILER_NOTIFY_PUBLISHED, eSetBits);
+  }
+
+  return length > 0;
+}
+#endif
@@ -0,0 +1,83 @@
+/**
+* @file Profiler.h
+* @brief Declaration of the sampling profiler for Arduino project.
+*
+* This file contains the declarations of the statistical profiler used in the Arduino project.
+* A hardware timer interrupt samples the interrupted program counter and task handle into a
+* RAM buffer. When the buffer is full, a low-priority thread folds identical samples together
+* and dumps them to the Serial monitor, and optionally hands them out in chunks for an MQTT
+* topic. On the host, tools/smaf_profile_to_flamegraph.py resolves the addresses against the
+* ELF file and produces folded stacks for a flame graph.
+*
+* @note The interrupted program counter is read from the exception frame that FreeRTOS saves
+*       on the task stack, which is only available on Xtensa targets. Other targets record
+*       the task only.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "Arduino.h"
+
+// Enable the sampling profiler (0 = disabled, 1 = enabled). Override with a build flag.
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 0
+#endif
+
+// Define profiler parameters.
+#define PROFILER_SAMPLE_RATE 997         // Samples per second. Prime, to avoid aliasing with the 1 kHz tick.
+#define PROFILER_SAMPLE_COUNT 2048       // Samples collected before each dump.
+#define PROFILER_TIMER_NUMBER 3          // Hardware timer used on ESP32 Arduino Core < 3.0.
+#define PROFILER_THREAD_STACK_SIZE 3072  // Stack size of the dump thread.
+#define PROFILER_THREAD_PRIORITY 1       // Lowest priority above the idle task.
+#define PROFILER_PUBLISH_TIMEOUT 60000   // Time to wait for chunk consumers before sampling again, in milliseconds.
+
+#if PROFILER_ENABLED
+/**
+* @brief Starts the sampling profiler.
+*
+* This function creates the dump thread and starts the sampling timer on the calling core.
+* Only the core that calls this function is sampled.
+*/
+void initProfiler();
+
+/**
+* @brief Formats the next chunk of the folded profile for transmission.
+*
+* After each dump, the folded profile can be retrieved in chunks, for example to publish
+* it over MQTT from the task that owns the client. Sampling restarts when all chunks have
+* been retrieved or after PROFILER_PUBLISH_TIMEOUT.
+*
+* @param buffer Destination for the chunk text, one "task;0xpc count" line per entry.
+* @param size Size of the destination buffer.
+* @return true if a chunk was written, false if no profile is waiting.
+*/
+bool profilerNextChunk(char* buffer, size_t size);
+#else
+static inline void initProfiler() {}
+static inline bool profilerNextChunk(char*, size_t) {
+  return false;
+}
+#endif
+
+#endif
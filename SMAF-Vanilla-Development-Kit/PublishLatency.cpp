@@ -0,0 +1,262 @@
+/**
+* @file PublishLatency.cpp
+* @brief Implementation of the end-to-end publish latency tracker for Arduino project.
+*
+* This file contains the implementation of the functions that follow each position record
+* from the GNSS epoch to the broker acknowledgement. Stage latencies are recorded into
+* histograms of the metrics registry, so they are served by the Prometheus endpoint and
+* included in the MQTT stats message without any extra export code.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Arduino.h"
+#include "PublishLatency.h"
+#include "Metrics.h"
+#include "Logger.h"
+#include <sys/time.h>
+
+// One histogram of latencies in microseconds per stage.
+static MetricHistogram stageHistograms[LATENCY_STAGE_COUNT] = {
+  { "smaf_latency_epoch_to_read_us", "GNSS epoch to read completion, in microseconds." },
+  { "smaf_latency_read_to_encode_us", "Read completion to encoded payload, in microseconds." },
+  { "smaf_latency_encode_to_write_us", "Encoded payload to socket write completion, in microseconds." },
+  { "smaf_latency_write_to_ack_us", "Socket write completion to broker echo, in microseconds." },
+  { "smaf_latency_epoch_to_ack_us", "GNSS epoch to broker echo, in microseconds." }
+};
+
+// Acknowledgement metrics.
+static MetricCounter acknowledgedCount("smaf_latency_acks_total", "Published records echoed back by the broker.");
+static MetricCounter lostCount("smaf_latency_ack_timeouts_total", "Published records not echoed back within the timeout.");
+
+// Records waiting for their broker echo.
+static LatencyRecord pendingRecords[LATENCY_PENDING_COUNT];
+
+// Next trace ID to hand out.
+static uint32_t nextTraceId = 1;
+
+/**
+* @brief Get the age of a GNSS epoch against the system time.
+*
+* @param epochMicroseconds GNSS epoch as Unix time in microseconds, or 0 if unknown.
+* @return Age of the epoch in microseconds, or 0 if it cannot be measured.
+*/
+static uint32_t measureEpochAge(uint64_t epochMicroseconds) {
+  if (epochMicroseconds == 0) {
+    return 0;
+  }
+
+  struct timeval now;
+  gettimeofday(&now, NULL);
+
+  if (now.tv_sec < LATENCY_MIN_SYNCED_TIME) {
+    return 0;
+  }
+
+  uint64_t nowMicroseconds = (uint64_t)now.tv_sec * 1000000ULL + now.tv_usec;
+
+  // An epoch in the future or far in the past means one of the clocks is off.
+  if (nowMicroseconds <= epochMicroseconds || nowMicroseconds - epochMicroseconds > LATENCY_MAX_EPOCH_AGE) {
+    return 0;
+  }
+
+  return (uint32_t)(nowMicroseconds - epochMicroseconds);
+}
+
+/**
+* @brief Counts and frees pending records that were not echoed within the timeout.
+*
+* @param now The current time in microseconds since boot.
+*/
+static void expirePendingRecords(uint32_t now) {
+  for (uint8_t i = 0; i < LATENCY_PENDING_COUNT; ++i) {
+    if (pendingRecords[i].traceId != 0 && now - pendingRecords[i].writeTime > LATENCY_ACK_TIMEOUT * 1000UL) {
+      pendingRecords[i].traceId = 0;
+      lostCount.increment();
+    }
+  }
+}
+
+#if LATENCY_TRACE_ID_ENABLED
+/**
+* @brief Finds the trace ID in an echoed payload.
+*
+* @param payload Pointer to the payload data received from the broker.
+* @param length Length of the payload data.
+* @return The trace ID, or 0 if the payload carries none.
+*/
+static uint32_t parseTraceId(const byte* payload, unsigned int length) {
+  static const char key[] = "\"trace\":";
+  const size_t keyLength = sizeof(key) - 1;
+
+  for (unsigned int i = 0; i + keyLength < length; ++i) {
+    if (memcmp(payload + i, key, keyLength) != 0) {
+      continue;
+    }
+
+    uint32_t traceId = 0;
+
+    for (unsigned int j = i + keyLength; j < length && isdigit(payload[j]); ++j) {
+      traceId = traceId * 10 + (payload[j] - '0');
+    }
+
+    return traceId;
+  }
+
+  return 0;
+}
+#endif
+
+/**
+* @brief Starts a new record when a GNSS solution has been read.
+*
+* The age of the GNSS epoch is measured against the NTP-synchronized system time. It is
+* skipped while the system time is not synchronized or the GNSS time is not valid.
+* Must always be called from the same task, which hands out the trace IDs.
+*
+* @param record The record to start.
+* @param epochMicroseconds GNSS epoch as Unix time in microseconds, or 0 if unknown.
+*/
+void latencyBeginRecord(LatencyRecord& record, uint64_t epochMicroseconds) {
+  record.traceId = nextTraceId++;
+
+  if (nextTraceId == 0) {
+    nextTraceId = 1;
+  }
+
+  record.readTime = micros();
+  record.encodeTime = record.readTime;
+  record.writeTime = record.readTime;
+  record.epochAge = measureEpochAge(epochMicroseconds);
+
+  if (record.epochAge != 0) {
+    stageHistograms[LATENCY_EPOCH_TO_READ].observe(record.epochAge);
+  }
+}
+
+/**
+* @brief Stamps a record when its payload has been encoded.
+*
+* @param record The record to stamp.
+*/
+void latencyMarkEncoded(LatencyRecord& record) {
+  if (record.traceId == 0) {
+    return;
+  }
+
+  record.encodeTime = micros();
+  stageHistograms[LATENCY_READ_TO_ENCODE].observe(record.encodeTime - record.readTime);
+}
+
+/**
+* @brief Stamps a record when its payload has been written to the socket.
+*
+* Published records wait for their broker echo. Records that were not published are dropped.
+*
+* @param record The record to stamp.
+* @param published true if the MQTT client accepted the payload.
+*/
+void latencyMarkWritten(LatencyRecord& record, bool published) {
+  if (record.traceId == 0) {
+    return;
+  }
+
+  record.writeTime = micros();
+
+  if (published) {
+    stageHistograms[LATENCY_ENCODE_TO_WRITE].observe(record.writeTime - record.encodeTime);
+    expirePendingRecords(record.writeTime);
+
+    // Take a free slot, or replace the oldest record if all are waiting.
+    uint32_t now = record.writeTime;
+    uint8_t slot = 0;
+
+    for (uint8_t i = 0; i < LATENCY_PENDING_COUNT; ++i) {
+      if (pendingRecords[i].traceId == 0) {
+        slot = i;
+        break;
+      }
+
+      if (now - pendingRecords[i].writeTime > now - pendingRecords[slot].writeTime) {
+        slot = i;
+      }
+    }
+
+    if (pendingRecords[slot].traceId != 0) {
+      lostCount.increment();
+    }
+
+    pendingRecords[slot] = record;
+  }
+
+  record.traceId = 0;
+}
+
+/**
+* @brief Completes a record when the broker echoes a payload back.
+*
+* @param payload Pointer to the payload data received from the broker.
+* @param length Length of the payload data.
+* @return true if the payload completed a pending record, false for any other message.
+*/
+bool latencyAcknowledge(const byte* payload, unsigned int length) {
+  uint32_t now = micros();
+  LatencyRecord* record = nullptr;
+
+#if LATENCY_TRACE_ID_ENABLED
+  uint32_t traceId = parseTraceId(payload, length);
+
+  if (traceId == 0) {
+    return false;
+  }
+
+  for (uint8_t i = 0; i < LATENCY_PENDING_COUNT; ++i) {
+    if (pendingRecords[i].traceId == traceId) {
+      record = &pendingRecords[i];
+      break;
+    }
+  }
+#else
+  // Without trace IDs, echoes arrive in publish order, so match the oldest pending record.
+  for (uint8_t i = 0; i < LATENCY_PENDING_COUNT; ++i) {
+    if (pendingRecords[i].traceId != 0 && (record == nullptr || now - pendingRecords[i].writeTime > now - record->writeTime)) {
+      record = &pendingRecords[i];
+    }
+  }
+#endif
+
+  if (record == nullptr) {
+    return false;
+  }
+
+  uint32_t writeToAck = now - record->writeTime;
+  stageHistograms[LATENCY_WRITE_TO_ACK].observe(writeToAck);
+
+  if (record->epochAge != 0) {
+    stageHistograms[LATENCY_EPOCH_TO_ACK].observe(record->epochAge + (now - record->readTime));
+  }
+
+  acknowledgedCount.increment();
+  debug(LOG, "Record %u acknowledged by broker after %u us.", (unsigned int)record->traceId, (unsigned int)writeToAck);
+
+  record->traceId = 0;
+  return true;
+}
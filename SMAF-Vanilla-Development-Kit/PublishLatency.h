@@ -0,0 +1,119 @@
+/**
+* @file PublishLatency.h
+* @brief Declaration of the end-to-end publish latency tracker for Arduino project.
+*
+* This file contains the declarations of the functions that follow each position record
+* from the GNSS epoch to the broker acknowledgement. Every record is stamped when it is
+* read from the GNSS module, encoded, written to the socket and echoed back by the broker
+* on the subscribed topic. The time between stamps is recorded into per-stage histograms
+* of the metrics registry, so percentiles are available with constant memory.
+*
+* @note Every record carries its own stamps, so the pipeline stages can begin, encode and
+*       write records in different tasks. latencyMarkWritten() and latencyAcknowledge()
+*       must be called from the loop task, which also runs the MQTT callback.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#ifndef PUBLISH_LATENCY_H
+#define PUBLISH_LATENCY_H
+
+#include "Arduino.h"
+
+// Add a trace ID and the GNSS epoch to every payload (0 = disabled, 1 = enabled).
+// The backend can subtract the epoch from its ingest time to measure its own latency.
+// Without the trace ID, a broker echo is matched to the oldest unacknowledged record.
+// Disabled by default, so existing backends keep the payload schema. Opt in with a build
+// flag, e.g. -DLATENCY_TRACE_ID_ENABLED=1.
+#ifndef LATENCY_TRACE_ID_ENABLED
+#define LATENCY_TRACE_ID_ENABLED 0
+#endif
+
+// Define latency tracker parameters.
+#define LATENCY_PENDING_COUNT 4             // Records awaiting a broker echo at the same time.
+#define LATENCY_ACK_TIMEOUT 10000           // Time after which a record without echo is counted as lost, in milliseconds.
+#define LATENCY_MAX_EPOCH_AGE 60000000ULL   // Largest believable GNSS epoch age in microseconds, older means the clocks disagree.
+#define LATENCY_MIN_SYNCED_TIME 1700000000  // System time below this Unix time means NTP has not synchronized yet.
+
+/**
+* @enum LatencyStageEnum
+* @brief Enumeration of the measured latency stages.
+*/
+enum LatencyStageEnum : byte {
+  LATENCY_EPOCH_TO_READ,    // GNSS epoch to read completion, requires NTP time.
+  LATENCY_READ_TO_ENCODE,   // Read completion to encoded payload.
+  LATENCY_ENCODE_TO_WRITE,  // Encoded payload to socket write completion.
+  LATENCY_WRITE_TO_ACK,     // Socket write completion to broker echo.
+  LATENCY_EPOCH_TO_ACK,     // GNSS epoch to broker echo, requires NTP time.
+  LATENCY_STAGE_COUNT       // Number of measured stages.
+};
+
+/**
+* @struct LatencyRecord
+* @brief Stamps of a single record, in microseconds since boot.
+*/
+struct LatencyRecord {
+  uint32_t traceId;     // Trace ID carried in the payload, 0 marks a free slot.
+  uint32_t readTime;    // Read completion.
+  uint32_t encodeTime;  // Encode completion.
+  uint32_t writeTime;   // Socket write completion.
+  uint32_t epochAge;    // Age of the GNSS epoch at read completion, 0 if unknown.
+};
+
+/**
+* @brief Starts a new record when a GNSS solution has been read.
+*
+* The age of the GNSS epoch is measured against the NTP-synchronized system time. It is
+* skipped while the system time is not synchronized or the GNSS time is not valid.
+* Must always be called from the same task, which hands out the trace IDs.
+*
+* @param record The record to start.
+* @param epochMicroseconds GNSS epoch as Unix time in microseconds, or 0 if unknown.
+*/
+void latencyBeginRecord(LatencyRecord& record, uint64_t epochMicroseconds);
+
+/**
+* @brief Stamps a record when its payload has been encoded.
+*
+* @param record The record to stamp.
+*/
+void latencyMarkEncoded(LatencyRecord& record);
+
+/**
+* @brief Stamps a record when its payload has been written to the socket.
+*
+* Published records wait for their broker echo. Records that were not published are dropped.
+*
+* @param record The record to stamp.
+* @param published true if the MQTT client accepted the payload.
+*/
+void latencyMarkWritten(LatencyRecord& record, bool published);
+
+/**
+* @brief Completes a record when the broker echoes a payload back.
+*
+* @param payload Pointer to the payload data received from the broker.
+* @param length Length of the payload data.
+* @return true if the payload completed a pending record, false for any other message.
+*/
+bool latencyAcknowledge(const byte* payload, unsigned int length);
+
+#endif
@@ -0,0 +1,214 @@
+/**
+* @file RecoveryLadder.cpp
+* @brief Implementation of the connectivity recovery ladder for Arduino project.
+*
+* This file contains the implementation of the functions that recover the device from a fault
+* without a full reset. While the pipeline stops reporting progress, the ladder escalates
+* through steps of growing cost: reconnect the MQTT client, restart the Wi-Fi driver,
+* re-initialize the I2C peripherals and, only when all of them failed, reboot the device.
+* Every step waits for its own timeout before the next one is taken, and every step counts
+* how often it was taken and how often it was the one that brought the device back.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Arduino.h"
+#include "RecoveryLadder.h"
+#include "Metrics.h"
+#include "ResetLog.h"
+#include "Helpers.h"
+
+// Time every step gets before the next one is taken, in milliseconds.
+static const uint32_t stepTimeouts[RECOVERY_STEP_COUNT] = {
+  RECOVERY_FAULT_TIMEOUT,
+  RECOVERY_MQTT_TIMEOUT,
+  RECOVERY_WIFI_TIMEOUT,
+  RECOVERY_I2C_TIMEOUT,
+  0
+};
+
+// Name of every step, used in the terminal.
+static const char* const stepNames[RECOVERY_STEP_COUNT] = {
+  "Idle",
+  "MQTT reconnect",
+  "Wi-Fi restart",
+  "I2C re-initialization",
+  "Reboot"
+};
+
+// Steps taken, per step. Reboots are counted by the reset log of the next boot.
+static MetricCounter takenCounts[RECOVERY_REBOOT] = {
+  { "smaf_recovery_faults_total", "Faults detected by the recovery ladder." },
+  { "smaf_recovery_mqtt_reconnects_total", "MQTT reconnect steps taken." },
+  { "smaf_recovery_wifi_restarts_total", "Wi-Fi restart steps taken." },
+  { "smaf_recovery_i2c_reinits_total", "I2C re-initialization steps taken." }
+};
+
+// Faults ended, per last step taken.
+static MetricCounter recoveredCounts[RECOVERY_REBOOT] = {
+  { "smaf_recovery_self_healed_total", "Faults that ended before any step was taken." },
+  { "smaf_recovery_mqtt_reconnect_successes_total", "Faults ended by an MQTT reconnect." },
+  { "smaf_recovery_wifi_restart_successes_total", "Faults ended by a Wi-Fi restart." },
+  { "smaf_recovery_i2c_reinit_successes_total", "Faults ended by an I2C re-initialization." }
+};
+
+// Recovery metrics.
+static MetricHistogram recoveryDuration("smaf_recovery_duration_ms", "Time from the last progress before a fault to the first progress after it, in milliseconds.");
+static MetricGauge stepGauge("smaf_recovery_step", "Recovery step taken last, 0 when there is no fault.");
+
+// Ladder state, only used from the loop task.
+static RecoveryAction stepActions[RECOVERY_STEP_COUNT];
+static RecoveryLinkCheck linkCheck = nullptr;
+static bool isHeldForLink = false;  // Waiting at the Wi-Fi restart step for the link to come back.
+static RecoveryStepEnum currentStep = RECOVERY_IDLE;
+static bool faultDetected = false;  // Progress stopped for longer than RECOVERY_FAULT_TIMEOUT.
+static bool ladderStarted = false;  // The timers run from the first call.
+static uint32_t lastProgressTime = 0;
+static uint32_t stepTime = 0;       // Time the current step completed.
+
+/**
+* @brief Reboots the device after naming the ladder as the cause in the reset log.
+*/
+static void rebootDevice() {
+  resetLogSetOffender("RecoveryLadder");
+  flushLogger();
+  esp_restart();
+}
+
+/**
+* @brief Sets the action of a recovery step.
+*
+* Steps without an action are still waited for, so the ladder timing does not change.
+* The reboot step has a built-in action and cannot be changed.
+*
+* @param step The recovery step.
+* @param action Function that carries out the step.
+*/
+void recoverySetAction(RecoveryStepEnum step, RecoveryAction action) {
+  if (step > RECOVERY_IDLE && step < RECOVERY_REBOOT) {
+    stepActions[step] = action;
+  }
+}
+
+/**
+* @brief Sets the check that holds the ladder at the Wi-Fi restart step while the link is down.
+*
+* A device out of network range cannot make progress, so the steps after the Wi-Fi restart
+* are only taken once the link is up and progress still does not return.
+*
+* @param check Function returning true while the link is up, or nullptr to never hold.
+*/
+void recoverySetLinkCheck(RecoveryLinkCheck check) {
+  linkCheck = check;
+}
+
+/**
+* @brief Reports that the pipeline made progress.
+*
+* This ends a running recovery and counts the step that was taken last as successful.
+*/
+void recoveryReportProgress() {
+  uint32_t now = millis();
+
+  if (faultDetected) {
+    recoveredCounts[currentStep].increment();
+    recoveryDuration.observe(now - lastProgressTime);
+    debug(SCS, "Device recovered after %u ms, last step '%s'.", (unsigned int)(now - lastProgressTime), stepNames[currentStep]);
+
+    faultDetected = false;
+    isHeldForLink = false;
+    currentStep = RECOVERY_IDLE;
+    stepGauge.set(RECOVERY_IDLE);
+  }
+
+  ladderStarted = true;
+  lastProgressTime = now;
+  stepTime = now;
+}
+
+/**
+* @brief Takes the next recovery step when the current one has timed out.
+*
+* This function must be called at least once a second, by the scheduler while the device is
+* connected and on every loop iteration that ends early because it is not.
+*/
+void recoveryUpdate() {
+  uint32_t now = millis();
+
+  if (!ladderStarted) {
+    ladderStarted = true;
+    lastProgressTime = now;
+    stepTime = now;
+    return;
+  }
+
+  // Without a link nothing after the Wi-Fi restart can help. The step timeout runs from the
+  // moment the link is back, so the pipeline gets a full step to resume before escalating.
+  if (currentStep == RECOVERY_WIFI_RESTART && linkCheck != nullptr && !linkCheck()) {
+    if (!isHeldForLink) {
+      isHeldForLink = true;
+      debug(LOG, "Network link is down, recovery waits at step '%s'.", stepNames[currentStep]);
+    }
+
+    stepTime = now;
+    return;
+  }
+
+  isHeldForLink = false;
+
+  if (now - stepTime < stepTimeouts[currentStep]) {
+    return;
+  }
+
+  if (!faultDetected) {
+    faultDetected = true;
+    takenCounts[RECOVERY_IDLE].increment();
+  } else if (currentStep == RECOVERY_REBOOT) {
+    return;
+  }
+
+  // Escalate to the next step.
+  currentStep = (RecoveryStepEnum)(currentStep + 1);
+  stepGauge.set(currentStep);
+  debug(ERR, "No progress for %u ms, taking recovery step '%s'.", (unsigned int)(now - lastProgressTime), stepNames[currentStep]);
+
+  if (currentStep == RECOVERY_REBOOT) {
+    rebootDevice();
+  }
+
+  takenCounts[currentStep].increment();
+
+  if (stepActions[currentStep] != nullptr) {
+    stepActions[currentStep]();
+  }
+
+  // Actions can block, the step timeout starts when the action is done.
+  stepTime = millis();
+}
+
+/**
+* @brief Get the recovery step that was taken last.
+*
+* @return The current step, or RECOVERY_IDLE if there is no fault.
+*/
+RecoveryStepEnum getRecoveryStep() {
+  return currentStep;
+}
@@ -0,0 +1,110 @@
+/**
+* @file RecoveryLadder.h
+* @brief Declaration of the connectivity recovery ladder for Arduino project.
+*
+* This file contains the declarations of the functions that recover the device from a fault
+* without a full reset. While the pipeline stops reporting progress, the ladder escalates
+* through steps of growing cost: reconnect the MQTT client, restart the Wi-Fi driver,
+* re-initialize the I2C peripherals and, only when all of them failed, reboot the device.
+* Every step waits for its own timeout before the next one is taken, and every step counts
+* how often it was taken and how often it was the one that brought the device back.
+*
+* @note All functions must be called from the loop task. The step actions run in the loop
+*       task as well.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#ifndef RECOVERY_LADDER_H
+#define RECOVERY_LADDER_H
+
+#include "Arduino.h"
+
+// Define recovery ladder parameters, in milliseconds.
+// A step timeout is the time the step gets to bring progress back before the next step is taken.
+#define RECOVERY_FAULT_TIMEOUT 20000   // Time without progress before the first step is taken.
+#define RECOVERY_MQTT_TIMEOUT 15000    // Timeout of the MQTT reconnect step.
+#define RECOVERY_WIFI_TIMEOUT 30000    // Timeout of the Wi-Fi restart step, covers several association attempts.
+#define RECOVERY_I2C_TIMEOUT 10000     // Timeout of the I2C re-initialization step.
+
+/**
+* @enum RecoveryStepEnum
+* @brief Enumeration of the recovery steps, in the order they are taken.
+*/
+enum RecoveryStepEnum : byte {
+  RECOVERY_IDLE,            // No fault, nothing to recover.
+  RECOVERY_MQTT_RECONNECT,  // Drop and reconnect the MQTT session.
+  RECOVERY_WIFI_RESTART,    // Restart the Wi-Fi driver and associate again.
+  RECOVERY_I2C_REINIT,      // Clear the I2C bus and re-initialize its peripherals.
+  RECOVERY_REBOOT,          // Reboot the device.
+  RECOVERY_STEP_COUNT       // Number of recovery steps.
+};
+
+// Action that carries out a recovery step.
+typedef void (*RecoveryAction)();
+
+// Check whether the network link is up.
+typedef bool (*RecoveryLinkCheck)();
+
+/**
+* @brief Sets the action of a recovery step.
+*
+* Steps without an action are still waited for, so the ladder timing does not change.
+* The reboot step has a built-in action and cannot be changed.
+*
+* @param step The recovery step.
+* @param action Function that carries out the step.
+*/
+void recoverySetAction(RecoveryStepEnum step, RecoveryAction action);
+
+/**
+* @brief Sets the check that holds the ladder at the Wi-Fi restart step while the link is down.
+*
+* A device out of network range cannot make progress, so the steps after the Wi-Fi restart
+* are only taken once the link is up and progress still does not return.
+*
+* @param check Function returning true while the link is up, or nullptr to never hold.
+*/
+void recoverySetLinkCheck(RecoveryLinkCheck check);
+
+/**
+* @brief Reports that the pipeline made progress.
+*
+* This ends a running recovery and counts the step that was taken last as successful.
+*/
+void recoveryReportProgress();
+
+/**
+* @brief Takes the next recovery step when the current one has timed out.
+*
+* This function must be called at least once a second, by the scheduler while the device is
+* connected and on every loop iteration that ends early because it is not.
+*/
+void recoveryUpdate();
+
+/**
+* @brief Get the recovery step that was taken last.
+*
+* @return The current step, or RECOVERY_IDLE if there is no fault.
+*/
+RecoveryStepEnum getRecoveryStep();
+
+#endif
@@ -0,0 +1,327 @@
+/**
+* @file ResetLog.cpp
+* @brief Implementation of the persistent reset log for Arduino project.
+*
+* This file contains the implementation of the reset log. The breadcrumb lives in RTC
+* memory that is not initialized at boot, so it still holds the values of the previous
+* boot after a software, panic or watchdog reset. The rolling history is stored as a single
+* blob in its own Preferences namespace and is written once per boot.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Arduino.h"
+#include "ResetLog.h"
+#include "Trace.h"
+#include "Helpers.h"
+#include "Preferences.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+
+// Crash summaries are only available when core dumps are stored in flash in ELF format.
+#if CONFIG_ESP_COREDUMP_ENABLE_TO_FLASH && CONFIG_ESP_COREDUMP_DATA_FORMAT_ELF
+#include "esp_core_dump.h"
+#define RESET_LOG_CORE_DUMP 1
+#else
+#define RESET_LOG_CORE_DUMP 0
+#endif
+
+/**
+* @struct ResetRecord
+* @brief Summary of a single reset.
+*/
+struct ResetRecord {
+  uint32_t boot;                                  // Boot number that ended with this reset.
+  uint32_t uptime;                                // Seconds the device ran before the reset.
+  uint32_t pc;                                    // Program counter of the crash, 0 if unknown.
+  uint32_t backtrace[RESET_LOG_BACKTRACE_DEPTH];  // Return addresses of the crashed task.
+  char task[16];                                  // Name of the crashed or hung task.
+  uint8_t reason;                                 // Reset reason, as esp_reset_reason_t.
+  uint8_t stage;                                  // Last pipeline stage entered, as TraceStageEnum.
+  uint8_t backtraceDepth;                         // Number of valid backtrace addresses.
+};
+
+/**
+* @struct ResetHistory
+* @brief Rolling history stored in flash.
+*/
+struct ResetHistory {
+  uint32_t bootCount;                     // Number of boots recorded.
+  uint8_t next;                           // Index of the slot written next.
+  ResetRecord records[RESET_LOG_HISTORY];  // Recorded resets, oldest overwritten first.
+};
+
+// Breadcrumb of the current boot, placed in RTC memory that is not cleared on reset.
+RTC_NOINIT_ATTR ResetBreadcrumb resetBreadcrumb;
+
+// History loaded at boot, including the record of the last reset.
+static ResetHistory resetHistory;
+
+// Whether the record of the last reset still has to be published.
+static bool resetLogPending = false;
+
+// Timer updating the uptime of the breadcrumb.
+static esp_timer_handle_t uptimeTimer = NULL;
+
+/**
+* @brief Get the display name of a reset reason.
+*
+* @param reason The reset reason, as esp_reset_reason_t.
+* @return Constant string naming the reason.
+*/
+static const char* resetReasonName(uint8_t reason) {
+  switch (reason) {
+    case ESP_RST_POWERON:
+      return "power-on";
+    case ESP_RST_EXT:
+      return "external";
+    case ESP_RST_SW:
+      return "software";
+    case ESP_RST_PANIC:
+      return "panic";
+    case ESP_RST_INT_WDT:
+      return "interrupt-wdt";
+    case ESP_RST_TASK_WDT:
+      return "task-wdt";
+    case ESP_RST_WDT:
+      return "other-wdt";
+    case ESP_RST_DEEPSLEEP:
+      return "deep-sleep";
+    case ESP_RST_BROWNOUT:
+      return "brownout";
+    case ESP_RST_SDIO:
+      return "sdio";
+    default:
+      return "unknown";
+  }
+}
+
+/**
+* @brief Get the display name of a breadcrumb stage.
+*
+* @param stage The stage, as TraceStageEnum.
+* @return Constant string naming the stage.
+*/
+static const char* resetStageName(uint8_t stage) {
+  return stage < TRACE_STAGE_COUNT ? traceStageName((TraceStageEnum)stage) : "none";
+}
+
+/**
+* @brief Timer callback updating the uptime of the breadcrumb.
+*
+* @param argument Timer argument (not used in this function).
+*/
+static void updateBreadcrumbUptime(void* argument) {
+  resetBreadcrumb.uptime = (uint32_t)(esp_timer_get_time() / 1000000);
+}
+
+#if RESET_LOG_CORE_DUMP
+/**
+* @brief Copies the crash summary of the stored core dump into a record.
+*
+* The core dump is erased afterwards, so that the same crash is not reported twice.
+*
+* @param record Destination record.
+*/
+static void readCrashSummary(ResetRecord& record) {
+  static esp_core_dump_summary_t summary;
+
+  if (esp_core_dump_get_summary(&summary) != ESP_OK) {
+    return;
+  }
+
+  record.pc = summary.exc_pc;
+
+  // A task named by the watchdog supervisor is more telling than the task that was interrupted.
+  if (record.task[0] == '\0') {
+    strlcpy(record.task, summary.exc_task, sizeof(record.task));
+  }
+
+#if CONFIG_IDF_TARGET_ARCH_XTENSA
+  record.backtraceDepth = min((uint32_t)RESET_LOG_BACKTRACE_DEPTH, summary.exc_bt_info.depth);
+
+  for (uint8_t i = 0; i < record.backtraceDepth; ++i) {
+    record.backtrace[i] = summary.exc_bt_info.bt[i];
+  }
+#endif
+
+  esp_core_dump_image_erase();
+}
+#endif
+
+/**
+* @brief Records the previous reset and starts the breadcrumb of this boot.
+*
+* This function reads the reset reason, the breadcrumb of the previous boot and the core
+* dump summary, appends the record to the history in flash, and starts the uptime timer.
+* Call it once, early in setup().
+*/
+void initResetLog() {
+  ResetRecord record;
+  memset(&record, 0, sizeof(record));
+
+  record.reason = esp_reset_reason();
+  record.stage = RESET_LOG_NO_STAGE;
+
+  // RTC memory holds random data after power-on, even if the magic happens to match.
+  if (record.reason != ESP_RST_POWERON && resetBreadcrumb.magic == RESET_LOG_MAGIC) {
+    record.uptime = resetBreadcrumb.uptime;
+    record.stage = resetBreadcrumb.stage;
+    memcpy(record.task, resetBreadcrumb.offender, sizeof(record.task));
+    record.task[sizeof(record.task) - 1] = '\0';
+  }
+
+#if RESET_LOG_CORE_DUMP
+  if (record.reason == ESP_RST_PANIC || record.reason == ESP_RST_INT_WDT || record.reason == ESP_RST_TASK_WDT) {
+    readCrashSummary(record);
+  }
+#endif
+
+  // Start the breadcrumb of this boot.
+  resetBreadcrumb.magic = RESET_LOG_MAGIC;
+  resetBreadcrumb.uptime = 0;
+  resetBreadcrumb.stage = RESET_LOG_NO_STAGE;
+  resetBreadcrumb.offender[0] = '\0';
+
+  // Append the record to the history. A history with a different layout is started over.
+  Preferences preferences;
+  bool isOpen = preferences.begin(RESET_LOG_NAMESPACE, false);
+
+  if (isOpen && (preferences.getBytes("history", &resetHistory, sizeof(resetHistory)) != sizeof(resetHistory) || resetHistory.next >= RESET_LOG_HISTORY)) {
+    memset(&resetHistory, 0, sizeof(resetHistory));
+  }
+
+  // The record is kept in memory even if it cannot be saved, so this boot still reports it.
+  record.boot = resetHistory.bootCount++;
+  resetHistory.records[resetHistory.next] = record;
+  resetHistory.next = (resetHistory.next + 1) % RESET_LOG_HISTORY;
+
+  if (isOpen) {
+    preferences.putBytes("history", &resetHistory, sizeof(resetHistory));
+    preferences.end();
+  } else {
+    debug(ERR, "Opening '%s' namespace failed, reset history not saved.", RESET_LOG_NAMESPACE);
+  }
+
+  resetLogPending = true;
+
+  // Keep the uptime of the breadcrumb current, even if the loop task hangs.
+  const esp_timer_create_args_t timerArguments = {
+    .callback = &updateBreadcrumbUptime,
+    .arg = NULL,
+    .dispatch_method = ESP_TIMER_TASK,
+    .name = "ResetLogUptime",
+    .skip_unhandled_events = true
+  };
+
+  if (uptimeTimer == NULL && esp_timer_create(&timerArguments, &uptimeTimer) == ESP_OK) {
+    esp_timer_start_periodic(uptimeTimer, 1000000);
+  }
+
+  debug(LOG, "Reset reason '%s' after %u s uptime, last stage '%s'.", resetReasonName(record.reason), (unsigned int)record.uptime, resetStageName(record.stage));
+
+  if (record.pc != 0) {
+    debug(ERR, "Crash in task '%s' at 0x%08x.", record.task, (unsigned int)record.pc);
+  } else if (record.task[0] != '\0') {
+    debug(ERR, "Reset caused by task '%s'.", record.task);
+  }
+}
+
+/**
+* @brief Names the task that caused an imminent reset.
+*
+* @param name The task name, truncated to fit the breadcrumb.
+*/
+void resetLogSetOffender(const char* name) {
+  strlcpy(resetBreadcrumb.offender, name, sizeof(resetBreadcrumb.offender));
+}
+
+/**
+* @brief Check if the reset record has not been published yet.
+*
+* @return true until markResetLogPublished() is called.
+*/
+bool isResetLogPending() {
+  return resetLogPending;
+}
+
+/**
+* @brief Marks the reset record as published.
+*/
+void markResetLogPublished() {
+  resetLogPending = false;
+}
+
+/**
+* @brief Format the last reset and the rolling history as JSON.
+*
+* The last reset is written in full. The history is a list of
+* [boot, reason, uptime, stage] entries, newest first.
+*
+* @param buffer Destination buffer.
+* @param size Size of the destination buffer.
+* @return Number of characters written, excluding the terminator.
+*/
+size_t formatResetLogJson(char* buffer, size_t size) {
+  if (size < 4) {
+    return 0;
+  }
+
+  size_t length = 0;
+  uint8_t newest = (resetHistory.next + RESET_LOG_HISTORY - 1) % RESET_LOG_HISTORY;
+  const ResetRecord& last = resetHistory.records[newest];
+
+  // Keep room for the closing brackets of the history and the object.
+  appendJson(buffer, size - 1, length, "{\"boot\":%u,\"reason\":\"%s\",\"uptime\":%u,\"stage\":\"%s\"",
+             (unsigned int)last.boot, resetReasonName(last.reason), (unsigned int)last.uptime, resetStageName(last.stage));
+
+  if (last.task[0] != '\0') {
+    appendJson(buffer, size - 1, length, ",\"task\":\"%s\"", last.task);
+  }
+
+  if (last.pc != 0) {
+    appendJson(buffer, size - 1, length, ",\"pc\":\"0x%08x\",\"bt\":[", (unsigned int)last.pc);
+
+    for (uint8_t i = 0; i < last.backtraceDepth; ++i) {
+      appendJson(buffer, size - 1, length, "%s\"0x%08x\"", i == 0 ? "" : ",", (unsigned int)last.backtrace[i]);
+    }
+
+    appendJson(buffer, size - 1, length, "]");
+  }
+
+  appendJson(buffer, size - 1, length, ",\"history\":[");
+
+  for (uint8_t i = 0; i < RESET_LOG_HISTORY && i < resetHistory.bootCount; ++i) {
+    const ResetRecord& record = resetHistory.records[(newest + RESET_LOG_HISTORY - i) % RESET_LOG_HISTORY];
+
+    if (!appendJson(buffer, size - 1, length, "%s[%u,\"%s\",%u,\"%s\"]", i == 0 ? "" : ",",
+                    (unsigned int)record.boot, resetReasonName(record.reason), (unsigned int)record.uptime, resetStageName(record.stage))) {
+      break;
+    }
+  }
+
+  buffer[length++] = ']';
+  buffer[length++] = '}';
+  buffer[length] = '\0';
+
+  return length;
+}
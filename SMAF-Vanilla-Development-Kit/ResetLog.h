@@ -0,0 +1,110 @@
+/**
+* @file ResetLog.h
+* @brief Declaration of the persistent reset log for Arduino project.
+*
+* This file contains the declarations of the functions that record why and when the device
+* reset. While running, a breadcrumb with the uptime and the last pipeline stage is kept in
+* RTC memory, which survives software and watchdog resets. At boot, the breadcrumb is
+* combined with the reset reason and, when a core dump is stored in flash, a compact crash
+* summary. The resulting record is appended to a rolling history in flash and published
+* once the device is connected again.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#ifndef RESET_LOG_H
+#define RESET_LOG_H
+
+#include "Arduino.h"
+
+// Define reset log parameters.
+#define RESET_LOG_NAMESPACE "SMAF-RST"    // Preferences namespace of the reset history.
+#define RESET_LOG_HISTORY 8               // Number of resets kept in the rolling history.
+#define RESET_LOG_BACKTRACE_DEPTH 4       // Backtrace addresses kept per crash.
+#define RESET_LOG_MAGIC 0x534D4146        // Marks a valid breadcrumb in RTC memory.
+#define RESET_LOG_NO_STAGE 0xFF           // No pipeline stage entered since boot.
+
+/**
+* @struct ResetBreadcrumb
+* @brief State kept in RTC memory while the device runs.
+*/
+struct ResetBreadcrumb {
+  uint32_t magic;          // RESET_LOG_MAGIC if the breadcrumb is valid.
+  uint32_t uptime;         // Seconds since boot, updated every second.
+  volatile uint8_t stage;  // Last pipeline stage entered, as TraceStageEnum.
+  char offender[16];       // Task named by the watchdog supervisor before the reset, empty if none.
+};
+
+// Breadcrumb of the current boot, placed in RTC memory that is not cleared on reset.
+extern ResetBreadcrumb resetBreadcrumb;
+
+/**
+* @brief Marks the pipeline stage the device is entering.
+*
+* This is a single byte store, cheap enough for the hot path.
+*
+* @param stage The stage, as TraceStageEnum.
+*/
+static inline void resetLogSetStage(uint8_t stage) {
+  resetBreadcrumb.stage = stage;
+}
+
+/**
+* @brief Names the task that caused an imminent reset.
+*
+* @param name The task name, truncated to fit the breadcrumb.
+*/
+void resetLogSetOffender(const char* name);
+
+/**
+* @brief Records the previous reset and starts the breadcrumb of this boot.
+*
+* This function reads the reset reason, the breadcrumb of the previous boot and the core
+* dump summary, appends the record to the history in flash, and starts the uptime timer.
+* Call it once, early in setup().
+*/
+void initResetLog();
+
+/**
+* @brief Check if the reset record has not been published yet.
+*
+* @return true until markResetLogPublished() is called.
+*/
+bool isResetLogPending();
+
+/**
+* @brief Marks the reset record as published.
+*/
+void markResetLogPublished();
+
+/**
+* @brief Format the last reset and the rolling history as JSON.
+*
+* The last reset is written in full. The history is a list of
+* [boot, reason, uptime, stage] entries, newest first.
+*
+* @param buffer Destination buffer.
+* @param size Size of the destination buffer.
+* @return Number of characters written, excluding the terminator.
+*/
+size_t formatResetLogJson(char* buffer, size_t size);
+
+#endif
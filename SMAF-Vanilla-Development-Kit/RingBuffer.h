@@ -0,0 +1,184 @@
+/**
+* @file RingBuffer.h
+* @brief Declaration and implementation of a bounded lock-free ring buffer.
+*
+* This file contains a fixed-capacity, multi-producer multi-consumer ring buffer that
+* can be shared between tasks running on both ESP32 cores. Every slot carries its own
+* sequence number, so producers and consumers only synchronize through single atomic
+* operations and never take a lock or disable interrupts. When the buffer is full,
+* writes fail immediately instead of blocking, which makes it safe to use on hot paths.
+*
+* @note The implementation lives in this header because the buffer is a class template.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include "Arduino.h"
+#include <atomic>
+
+template <typename T, size_t Capacity>
+class RingBuffer {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "RingBuffer capacity must be a power of two.");
+
+public:
+  /**
+  * @brief Constructs an empty ring buffer.
+  *
+  * Every slot is stamped with its own index as the initial sequence number, which marks
+  * it as free for the producer that claims that position first.
+  */
+  RingBuffer()
+    : _writePosition(0),
+      _readPosition(0) {
+    for (size_t i = 0; i < Capacity; ++i) {
+      _slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+  * @brief Claims a free slot for writing in place.
+  *
+  * The returned slot belongs to the caller until commit() is called with the same slot.
+  * This lets producers format data directly into the buffer without an extra copy.
+  *
+  * @return Pointer to the claimed slot, or nullptr if the buffer is full.
+  */
+  T* claim() {
+    size_t position = _writePosition.load(std::memory_order_relaxed);
+
+    for (;;) {
+      Slot& slot = _slots[position & (Capacity - 1)];
+      size_t sequence = slot.sequence.load(std::memory_order_acquire);
+      intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+
+      if (difference == 0) {
+        // The slot is free. Try to take ownership of this position.
+        if (_writePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+          slot.position = position;
+          return &slot.data;
+        }
+      } else if (difference < 0) {
+        // The consumer has not released this slot yet, the buffer is full.
+        return nullptr;
+      } else {
+        // Another producer claimed this position first, reload and retry.
+        position = _writePosition.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+  * @brief Publishes a slot previously returned by claim() to consumers.
+  *
+  * @param data Pointer returned by claim().
+  */
+  void commit(T* data) {
+    // Recover the slot index from the address of its data member.
+    size_t index = (reinterpret_cast<uint8_t*>(data) - reinterpret_cast<uint8_t*>(&_slots[0].data)) / sizeof(Slot);
+    Slot& slot = _slots[index];
+    slot.sequence.store(slot.position + 1, std::memory_order_release);
+  }
+
+  /**
+  * @brief Copies an item into the buffer.
+  *
+  * @param item The item to store.
+  * @return true if the item was stored, false if the buffer is full.
+  */
+  bool push(const T& item) {
+    T* data = claim();
+
+    if (data == nullptr) {
+      return false;
+    }
+
+    *data = item;
+    commit(data);
+    return true;
+  }
+
+  /**
+  * @brief Removes the oldest item from the buffer.
+  *
+  * @param item Destination for the removed item.
+  * @return true if an item was removed, false if the buffer is empty.
+  */
+  bool pop(T& item) {
+    size_t position = _readPosition.load(std::memory_order_relaxed);
+
+    for (;;) {
+      Slot& slot = _slots[position & (Capacity - 1)];
+      size_t sequence = slot.sequence.load(std::memory_order_acquire);
+      intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
+
+      if (difference == 0) {
+        // The slot holds committed data. Try to take ownership of this position.
+        if (_readPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+          item = slot.data;
+          slot.sequence.store(position + Capacity, std::memory_order_release);
+          return true;
+        }
+      } else if (difference < 0) {
+        // Nothing has been committed at this position yet, the buffer is empty.
+        return false;
+      } else {
+        // Another consumer took this position first, reload and retry.
+        position = _readPosition.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+  * @brief Check if the buffer currently holds no committed items.
+  *
+  * @return true if the buffer is empty at the time of the call.
+  */
+  bool isEmpty() const {
+    size_t position = _readPosition.load(std::memory_order_relaxed);
+    const Slot& slot = _slots[position & (Capacity - 1)];
+    return slot.sequence.load(std::memory_order_acquire) != position + 1;
+  }
+
+  /**
+  * @brief Get the fixed capacity of the buffer.
+  *
+  * @return The number of slots in the buffer.
+  */
+  static constexpr size_t capacity() {
+    return Capacity;
+  }
+
+private:
+  struct Slot {
+    std::atomic<size_t> sequence;  // Slot state, compared against read and write positions.
+    size_t position;               // Position claimed by the current producer.
+    T data;                        // Stored item.
+  };
+
+  Slot _slots[Capacity];
+  std::atomic<size_t> _writePosition;  // Next position handed out to producers.
+  std::atomic<size_t> _readPosition;   // Next position handed out to consumers.
+};
+
+#endif
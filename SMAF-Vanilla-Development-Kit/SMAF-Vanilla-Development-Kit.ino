@@ -28,29 +28,66 @@
 #include "PubSubClient.h"
 #include "AudioVisualNotifications.h"
 #include "Helpers.h"
+#include "Trace.h"
+#include "Profiler.h"
+#include "Metrics.h"
+#include "PublishLatency.h"
+#include "HealthMonitor.h"
+#include "ResetLog.h"
+#include "EnergyMonitor.h"
+#include "WatchdogSupervisor.h"
+#include "RecoveryLadder.h"
+#include "StatusChannel.h"
+#include "Events.h"
+#include "Pipeline.h"
+#include "AllocationCounter.h"
+#include "Scheduler.h"
 #include "Wire.h"
+#include "freertos/event_groups.h"
 #include "time.h"
 #include "SparkFun_u-blox_GNSS_v3.h"
 #include "Adafruit_SHT4x.h"
 
-// Define constants for ESP32 core numbers.
-#define ESP32_CORE_PRIMARY 0    // Numeric value representing the primary core.
-#define ESP32_CORE_SECONDARY 1  // Numeric value representing the secondary core.
+// Function prototype for the DeviceStatusThread function.
+void DeviceStatusThread(void* pvParameters);
 
-// Enum to represent different device statuses.
-enum DeviceStatusEnum : byte {
-  NONE,             // Disable RGB led.
-  NOT_READY,        // Device is not ready.
-  READY_TO_SEND,    // Device is ready to send data.
-  WAITING_GNSS,     // Device is waiting for GNSS data.
-  MAINTENANCE_MODE  // Device is in maintenance mode.
-};
+// Stack size of the DeviceStatusThread, the patterns run on the frame timer.
+#define DEVICE_STATUS_STACK_SIZE 2048
 
-// Variable to store the current device status.
-DeviceStatusEnum deviceStatus = NONE;  // Initial state is set to NOT_READY.
+// Function prototypes for the threads that start the I2C modules during boot.
+void Sht4BootThread(void* pvParameters);
+void GnssBootThread(void* pvParameters);
 
-// Function prototype for the DeviceStatusThread function.
-void DeviceStatusThread(void* pvParameters);
+// Function prototypes for the acquisition and encode stages of the position pipeline.
+// The loop is the transport stage.
+void AcquisitionThread(void* pvParameters);
+void EncodeThread(void* pvParameters);
+
+// Bits set by the boot threads once their module is ready.
+#define BOOT_SHT4X_READY (1 << 0)
+#define BOOT_GNSS_READY (1 << 1)
+
+// Boot threads report to this event group, setup() waits for both bits.
+static EventGroupHandle_t bootEvents = NULL;
+static StaticEventGroup_t bootEventsBuffer;
+
+// Stacks and control blocks of the threads that run until the device resets.
+// Static allocation keeps the heap untouched by steady-state operation. The boot threads
+// end after boot and free their stacks, they are allocated dynamically.
+static StackType_t deviceStatusThreadStack[DEVICE_STATUS_STACK_SIZE];
+static StaticTask_t deviceStatusThreadBuffer;
+static StackType_t acquisitionThreadStack[PIPELINE_ACQUISITION_STACK_SIZE];
+static StaticTask_t acquisitionThreadBuffer;
+static StackType_t encodeThreadStack[PIPELINE_ENCODE_STACK_SIZE];
+static StaticTask_t encodeThreadBuffer;
+
+// Time a single Wi-Fi connection attempt gets, in milliseconds.
+#define NETWORK_CONNECT_TIMEOUT 6400
+
+// Periods of the loop task jobs that are not set by their own module, in milliseconds.
+#define NETWORK_SERVICE_INTERVAL 10   // MQTT client and metrics endpoint.
+#define RECOVERY_CHECK_INTERVAL 1000  // Recovery ladder step timeouts.
+#define PROFILE_CHECK_INTERVAL 1000   // Dumped profiler sample buffers.
 
 // SoftAP configurationuration parameters.
 const char* configurationNetworkName = "SMAF-DK-SAP-configuration";
@@ -76,6 +113,24 @@ static uint16_t mqttServerPort;
 static bool audioNotifications;
 static bool visualNotifications;
 
+// State of the running Wi-Fi connection attempt.
+static bool isNetworkAttemptActive = false;
+static uint32_t networkAttemptStart = 0;
+
+// Queues between the position pipeline stages.
+PipelineQueue<PositionRecord, PIPELINE_QUEUE_CAPACITY> positionQueue("smaf_pipeline_positions_dropped_total", "PVT solutions dropped because the encode stage fell behind.");
+PipelineQueue<EncodedRecord, PIPELINE_QUEUE_CAPACITY> encodedQueue("smaf_pipeline_payloads_dropped_total", "Encoded payloads dropped because the transport stage fell behind.");
+
+// Latest GNSS solution and environment reading. Written by the acquisition stage, read by any task.
+Seqlock<LatestSample> latestSample;
+
+// Set by the recovery ladder. The acquisition stage owns the I2C bus and restarts the modules.
+static std::atomic<bool> isSensorRestartRequested(false);
+
+// Supervisor check-in ID of the loop.
+// A missing broker echo is handled by the recovery ladder, which reboots only as its last step.
+static int8_t loopCheckIn = SUPERVISOR_INVALID_ID;
+
 /**
 * @brief WiFiClient and PubSubClient instances for establishing MQTT communication.
 * 
@@ -101,12 +156,60 @@ AudioVisualNotifications notifications(4, 2, 30, 5);
 // Define the pin for the configurationuration button.
 int configurationurationButton = 6;
 
+// Define the I2C pins shared by the SHT4x and GNSS modules.
+#define I2C_SDA_PIN 1
+#define I2C_SCL_PIN 2
+
 // SFE_UBLOX_GNSS Library.
 SFE_UBLOX_GNSS gnss;
 
 // Adafruit SHT45 Library.
 Adafruit_SHT4x sht4 = Adafruit_SHT4x();
 
+// Alarm changes published by the health monitor, drained by the health report.
+EventMailbox<AlarmEvent, EVENT_ALARM_CAPACITY> healthAlarmMailbox("smaf_health_alarm_events_dropped_total", "Alarm events dropped because the health report fell behind.");
+
+// Metrics exporter serving the Prometheus endpoint and formatting the MQTT stats message.
+MetricsExporter metricsExporter(METRICS_SERVER_PORT);
+
+// GNSS metrics.
+MetricCounter gnssSolutionCount("smaf_gnss_solutions_total", "PVT solutions received from the GNSS module.");
+MetricCounter gnssNoFixCount("smaf_gnss_no_fix_total", "PVT solutions without a valid position fix.");
+MetricGauge gnssSatelliteGauge("smaf_gnss_satellites", "Satellites used in the last PVT solution.");
+
+// MQTT metrics.
+MetricCounter mqttPublishCount("smaf_mqtt_publish_total", "Position messages published to the MQTT broker.");
+MetricCounter mqttPublishFailureCount("smaf_mqtt_publish_failures_total", "Position messages the MQTT client failed to publish.");
+MetricHistogram mqttPublishDuration("smaf_mqtt_publish_duration_us", "Time spent publishing a position message, in microseconds.");
+MetricCounter mqttConnectCount("smaf_mqtt_connects_total", "Successful connections to the MQTT broker.");
+MetricCounter mqttConnectFailureCount("smaf_mqtt_connect_failures_total", "Failed connection attempts to the MQTT broker.");
+MetricCounter mqttResponseCount("smaf_mqtt_responses_total", "Messages received back from the MQTT broker.");
+
+// Boot milestones, in milliseconds since boot. Zero until the milestone is reached.
+MetricGauge bootSensorsReadyGauge("smaf_boot_sensors_ready_ms", "Time from boot until the SHT4x and GNSS modules were ready.");
+MetricGauge bootFirstFixGauge("smaf_boot_first_fix_ms", "Time from boot to the first GNSS solution with a position fix.");
+MetricGauge bootFirstPublishGauge("smaf_boot_first_publish_ms", "Time from boot to the first published position.");
+
+// Environment metrics, updated from the latest sample.
+MetricGauge temperatureGauge("smaf_environment_temperature_centi_celsius", "Last SHT4x temperature, in degrees Celsius * 100.");
+MetricGauge humidityGauge("smaf_environment_humidity_centi_percent", "Last SHT4x relative humidity, in percent * 100.");
+MetricCounter sht4ReadFailureCount("smaf_sht4x_read_failures_total", "SHT4x readings that failed.");
+
+// Wi-Fi metrics.
+MetricCounter wifiConnectCount("smaf_wifi_connects_total", "Successful connections to the Wi-Fi network.");
+MetricCounter wifiConnectAttemptCount("smaf_wifi_connect_attempts_total", "Connection attempts to the Wi-Fi network.");
+MetricGauge wifiRssiGauge("smaf_wifi_rssi_dbm", "Signal strength of the Wi-Fi network.");
+
+// Jobs of the loop task. A job may start up to its tolerance late without missing its deadline.
+SCHEDULER_JOB(networkJob, network, serviceNetwork, NETWORK_SERVICE_INTERVAL, 20);
+SCHEDULER_JOB(environmentJob, environment, exportEnvironment, PIPELINE_ENVIRONMENT_INTERVAL, 500);
+SCHEDULER_JOB(recoveryJob, recovery, recoveryUpdate, RECOVERY_CHECK_INTERVAL, 1000);
+SCHEDULER_JOB(profileJob, profile, publishProfile, PROFILE_CHECK_INTERVAL, 1000);
+SCHEDULER_JOB(traceJob, trace, traceExport, TRACE_EXPORT_INTERVAL, 1000);
+SCHEDULER_JOB(statsJob, stats, publishStats, METRICS_PUBLISH_INTERVAL, 1000);
+SCHEDULER_JOB(healthJob, health, publishHealth, HEALTH_REPORT_INTERVAL, 1000);
+SCHEDULER_JOB(energyJob, energy, energyExport, ENERGY_EXPORT_INTERVAL, 1000);
+
 // NTP Server configuration.
 const char* ntpServer = "europe.pool.ntp.org";  // Global - pool.ntp.org
 const long gmtOffset = 0;
@@ -120,24 +223,43 @@ const int dstOffset = 0;
 *
 */
 void setup() {
-  // Create a new task (DeviceStatusThread) and assign it to the primary core (ESP32_CORE_PRIMARY).
-  xTaskCreatePinnedToCore(
-    DeviceStatusThread,    // Function to implement the task.
-    "DeviceStatusThread",  // Name of the task.
-    8000,                  // Stack size in words.
-    NULL,                  // Task input parameter (e.g., delay).
-    1,                     // Priority of the task.
-    NULL,                  // Task handle.
-    ESP32_CORE_SECONDARY   // Core where the task should run.
+  // Create a new task (DeviceStatusThread) and assign it to the secondary core (ESP32_CORE_SECONDARY).
+  xTaskCreateStaticPinnedToCore(
+    DeviceStatusThread,         // Function to implement the task.
+    "DeviceStatusThread",       // Name of the task.
+    DEVICE_STATUS_STACK_SIZE,   // Stack size in words.
+    NULL,                       // Task input parameter (e.g., delay).
+    1,                          // Priority of the task.
+    deviceStatusThreadStack,    // Stack buffer.
+    &deviceStatusThreadBuffer,  // Task control block.
+    ESP32_CORE_SECONDARY        // Core where the task should run.
   );
 
   // Initialize serial communication at a baud rate of 115200.
   Serial.begin(115200);
 
+  // Start the logger thread that drains queued debug messages to the Serial monitor.
+  initLogger();
+
+  // Record why the device reset, before anything else can fail.
+  initResetLog();
+
+  // Receive alarm changes in the loop task, before the health monitor can raise one.
+  healthAlarmMailbox.attach();
+
+  // Start sampling heap, stack and CPU usage.
+  initHealthMonitor();
+
+  // Start accounting the time every component spends in each power state.
+  initEnergyMonitor();
+
+  // Export the heap operations of the pipeline stages per PVT solution.
+  initAllocationCounter();
+
   // Set Wire library custom I2C pins.
   // Example usage:
   // Wire.setPins(SDA_PIN_NUMBER, SCL_PIN_NUMBER);
-  Wire.setPins(1, 2);
+  Wire.setPins(I2C_SDA_PIN, I2C_SCL_PIN);
 
   // Set the pin mode for the configurationuration button to INPUT.
   pinMode(configurationurationButton, INPUT);
@@ -158,17 +280,17 @@ void setup() {
   // This does not light up neo pixels.
   notifications.initializeVisualNotifications();
 
+  // Start the melody sequencer, melodies play in the background from now on.
+  notifications.initializeAudioNotifications();
+
   // Play intro melody on speaker if enabled in preferences.
   if (audioNotifications) {
     notifications.introAudioNotification();
   }
 
-  // Delay for 2400 milliseconds (2.4 seconds).
-  delay(1600);
-
   // Print a formatted welcome message with build information.
-  String buildVersion = "v0.002";
-  String buildDate = "Q2, 2024.";
+  const char* buildVersion = "v0.002";
+  const char* buildDate = "Q2, 2024.";
   Serial.printf("\n\rSMAF-DEVELOPMENT-KIT, Crafted with love in Europe.\n\rBuild version: %s\n\rBuild date: %s\n\r\n\r", buildVersion, buildDate);
 
   bool isConfigurationValid = configuration.loadPreferences();
@@ -177,9 +299,13 @@ void setup() {
   if ((digitalRead(configurationurationButton) == LOW) || (!isConfigurationValid)) {
     // Log SoftAP information and start SoftAP configurationuration server.
     configuration.startConfiguration();
+    energySetState(ENERGY_RADIO, ENERGY_RADIO_CONNECTED);
+
+    // Serve metrics on the SoftAP too, they include the configuration page timings.
+    metricsExporter.begin();
 
     // Set device status to Maintenance Mode.
-    deviceStatus = MAINTENANCE_MODE;
+    setDeviceStatus(MAINTENANCE_MODE);
 
     // Play configuration melody notification on speaker.
     if (audioNotifications) {
@@ -189,48 +315,107 @@ void setup() {
     // Render the configurationuration page in maintenance mode.
     while (true) {
       configuration.renderConfigurationPage();
+      metricsExporter.handleClient();
 
       // Prevent watchdog reset.
       yield();
     }
   } else {
     // Set device status to Not Ready Mode.
-    deviceStatus = NOT_READY;
-
-    // Start SHT4x module.
-    while (!sht4.begin()) {
-      debug(ERR, "SHT4x module not detected on I2C lines.");
-      delay(800);
-    }
-
-    // Log successful SHT4x module initialization.
-    debug(SCS, "SHT4x module detected on I2C lines.");
-
-    // Set SHT4x precision and heater settings.
-    sht4.setPrecision(SHT4X_HIGH_PRECISION);
-    sht4.setHeater(SHT4X_NO_HEATER);
-
-    // Start GNSS module.
-    while (!gnss.begin()) {
-      debug(ERR, "GNSS module not detected on I2C lines.");
-      delay(800);
-    }
-
-    // Log successful GNSS module initialization.
-    debug(SCS, "GNSS module detected on I2C lines.");
-
-    // Set the I2C port to output UBX only (turn off NMEA noise).
-    gnss.setI2COutput(COM_TYPE_UBX);
+    setDeviceStatus(NOT_READY);
+
+    // Start associating with the Wi-Fi network, the driver connects in the background
+    // while the I2C modules are started.
+    beginNetworkAttempt();
+
+    // Start the SHT4x and GNSS modules concurrently, each in its own boot thread.
+    // The Wire library serializes their transfers on the shared I2C bus.
+    Wire.begin();
+    bootEvents = xEventGroupCreateStatic(&bootEventsBuffer);
+
+    xTaskCreatePinnedToCore(
+      Sht4BootThread,    // Function to implement the task.
+      "Sht4BootThread",  // Name of the task.
+      2048,              // Stack size in words.
+      NULL,              // Task input parameter.
+      1,                 // Priority of the task.
+      NULL,              // Task handle.
+      tskNO_AFFINITY     // Run on whichever core is idle.
+    );
+
+    xTaskCreatePinnedToCore(
+      GnssBootThread,    // Function to implement the task.
+      "GnssBootThread",  // Name of the task.
+      4096,              // Stack size in words.
+      NULL,              // Task input parameter.
+      1,                 // Priority of the task.
+      NULL,              // Task handle.
+      tskNO_AFFINITY     // Run on whichever core is idle.
+    );
 
     // Initialize NTP server time configuration.
+    // SNTP starts querying as soon as the network is up.
     configTime(gmtOffset, dstOffset, ntpServer);
 
     // MQTT Client message buffer size.
-    // Default is set to 256.
-    mqtt.setBufferSize(1024);
-
-    // Setup hardware Watchdog timer. Bark Bark.
-    initWatchdog(30, true);
+    // Default is set to 256. The stats message with all registered metrics needs up to 2 kB.
+    mqtt.setBufferSize(2560);
+
+    // The acquisition stage reads the GNSS module, so wait until both modules are ready.
+    xEventGroupWaitBits(bootEvents, BOOT_SHT4X_READY | BOOT_GNSS_READY, pdFALSE, pdTRUE, portMAX_DELAY);
+    recordBootMilestone(bootSensorsReadyGauge, "sensors ready");
+
+    // Start the position pipeline. The loop publishes the encoded records.
+    encodedQueue.attachConsumer();
+
+    TaskHandle_t encodeThread = xTaskCreateStaticPinnedToCore(
+      EncodeThread,                // Function to implement the task.
+      "EncodeThread",              // Name of the task.
+      PIPELINE_ENCODE_STACK_SIZE,  // Stack size in words.
+      NULL,                        // Task input parameter.
+      PIPELINE_ENCODE_PRIORITY,    // Priority of the task.
+      encodeThreadStack,           // Stack buffer.
+      &encodeThreadBuffer,         // Task control block.
+      PIPELINE_ENCODE_CORE         // Core where the task should run.
+    );
+
+    TaskHandle_t acquisitionThread = xTaskCreateStaticPinnedToCore(
+      AcquisitionThread,                // Function to implement the task.
+      "AcquisitionThread",              // Name of the task.
+      PIPELINE_ACQUISITION_STACK_SIZE,  // Stack size in words.
+      NULL,                             // Task input parameter.
+      PIPELINE_ACQUISITION_PRIORITY,    // Priority of the task.
+      acquisitionThreadStack,           // Stack buffer.
+      &acquisitionThreadBuffer,         // Task control block.
+      PIPELINE_ACQUISITION_CORE         // Core where the task should run.
+    );
+
+    allocationCounterAttach(encodeThread);
+    allocationCounterAttach(acquisitionThread);
+
+    // Supervise the loop, the supervisor feeds the hardware watchdog. Bark Bark.
+    // The loop deadline covers a single Wi-Fi or MQTT connection attempt.
+    loopCheckIn = supervisorRegister("loopTask", 30000);
+    initSupervisor();
+
+    // Recover from faults step by step before rebooting.
+    recoverySetAction(RECOVERY_MQTT_RECONNECT, reconnectMqttBroker);
+    recoverySetAction(RECOVERY_WIFI_RESTART, restartNetwork);
+    recoverySetAction(RECOVERY_I2C_REINIT, requestSensorRestart);
+    recoverySetLinkCheck(isNetworkConnected);
+
+    // Start sampling the loop core if the profiler is compiled in.
+    initProfiler();
+
+    // Schedule the periodic work of the loop task. The first reports go out one period after boot.
+    scheduleJob(networkJob, 0);
+    scheduleJob(environmentJob, 0);
+    scheduleJob(recoveryJob, 0);
+    scheduleJob(profileJob, PROFILE_CHECK_INTERVAL);
+    scheduleJob(traceJob, TRACE_EXPORT_INTERVAL);
+    scheduleJob(statsJob, METRICS_PUBLISH_INTERVAL);
+    scheduleJob(healthJob, 0);
+    scheduleJob(energyJob, ENERGY_EXPORT_INTERVAL);
   }
 }
 
@@ -243,61 +428,123 @@ void setup() {
 *
 */
 void loop() {
-  // Attempt to connect to the Wi-Fi network.
-  connectToNetwork();
+  supervisorCheckIn(loopCheckIn);
 
-  // Attempt to connect to the MQTT broker.
-  connectToMqttBroker();
+  // Attempt to connect to the Wi-Fi network and the MQTT broker, one attempt per iteration.
+  // The recovery ladder keeps running while the device is not connected.
+  if (!connectToNetwork() || !connectToMqttBroker()) {
+    recoveryUpdate();
+    return;
+  }
 
-  // Store MQTT data here.
-  String mqttData = String();
+  // Publish every encoded record the pipeline has ready.
+  static EncodedRecord record;
 
-  // Request (poll) the position, velocity and time (PVT) information.
-  // The module only responds when a new position is available. Default is once per second.
-  // getPVT() returns true when new data is received.
-  if (gnss.getPVT() == true) {
-    bool gnssFixOk = gnss.getGnssFixOk();
-    uint8_t satellitesInRange = gnss.getSIV();
-    int32_t latitude = gnss.getLatitude();
-    int32_t longitude = gnss.getLongitude();
-    int32_t speed = gnss.getGroundSpeed();
-    int32_t heading = gnss.getHeading();
-    int32_t altitude = gnss.getAltitudeMSL();
-    String timestamp = getUtcTimeString();
-
-    // String constructMqttMessage(int32_t longitude, int32_t latitude, int32_t speed, int32_t altitude, String time)
-    mqttData = constructMqttMessage(
-      satellitesInRange,
-      longitude,
-      latitude,
-      altitude,
-      speed,
-      heading,
-      timestamp);
-
-    // If the device is ready to send, publish a message to the MQTT broker.
-    if (gnssFixOk && latitude != 0 && longitude != 0) {
-      deviceStatus = READY_TO_SEND;
-      debug(SCS, "Device is ready to post data, %d satellites locked.", satellitesInRange);
-      debug(CMD, "Posting data package to MQTT broker '%s' on topic '%s'.", mqttServerAddress, mqttTopic);
-      mqtt.publish(mqttTopic, mqttData.c_str(), true);
+  while (encodedQueue.pop(record, 0)) {
+    publishPosition(record);
+  }
+
+  // Publish the health report right away when alarms change, instead of at the next period.
+  if (takeAlarmChanges()) {
+    scheduleJob(healthJob, 0);
+  }
+
+  // Run the jobs that are due, then sleep until the next one is released. A committed
+  // record or a posted event wakes the loop task early.
+  schedulerRun();
+}
+
+/**
+* @brief Job that services the MQTT client and the metrics endpoint.
+*
+* Checks for incoming data on the subscribed MQTT topic. This is the hard connection check:
+* if nothing comes back, the pipeline stops making progress and the recovery ladder steps in.
+*/
+void serviceNetwork() {
+  {
+    TRACE_SCOPE(TRACE_MQTT_LOOP);
+    mqtt.loop();
+  }
+
+  // Serve a pending metrics scrape.
+  metricsExporter.handleClient();
+}
+
+/**
+* @brief Publishes an encoded record to the MQTT broker and updates the device status.
+*
+* Records without a position fix are not published, they only report that the device
+* is waiting for satellites.
+*
+* @param record The encoded record to publish.
+*/
+void publishPosition(EncodedRecord& record) {
+  allocationCounterCheckpoint();
+
+  // If the device is ready to send, publish a message to the MQTT broker.
+  if (record.positionValid) {
+    setDeviceStatus(READY_TO_SEND);
+    debug(SCS, "Device is ready to post data, %d satellites locked.", record.satellites);
+    debug(CMD, "Posting data package to MQTT broker '%s' on topic '%s'.", mqttServerAddress, mqttTopic);
+
+    TRACE_SCOPE(TRACE_PUBLISH);
+    uint32_t publishStart = micros();
+
+    bool published = record.payload.length() != 0 && mqtt.publish(mqttTopic, (const uint8_t*)record.payload.c_str(), record.payload.length(), true);
+    latencyMarkWritten(record.latency, published);
+
+    if (published) {
+      mqttPublishCount.increment();
+      postStatusEvent(STATUS_PUBLISHED);
+      recordBootMilestone(bootFirstPublishGauge, "first publish");
+      energyRecordFix();
     } else {
-      deviceStatus = WAITING_GNSS;
-      debug(ERR, "Device is not ready to post data. Searching for satellites, %d locked.", satellitesInRange);
+      mqttPublishFailureCount.increment();
+    }
+
+    mqttPublishDuration.observe(micros() - publishStart);
+  } else {
+    gnssNoFixCount.increment();
+    latencyMarkWritten(record.latency, false);
+
+    if (getDeviceStatus() == READY_TO_SEND) {
+      postStatusEvent(STATUS_FIX_LOST);
     }
+
+    setDeviceStatus(WAITING_GNSS);
+
+    // Nothing to publish yet, a solution from the GNSS module is all the progress there can be.
+    recoveryReportProgress();
+    debug(ERR, "Device is not ready to post data. Searching for satellites, %d locked.", record.satellites);
   }
+}
+
+/**
+* @brief Updates the environment metrics from the latest sample.
+*
+* Reads the shared snapshot only when it changed since the previous call.
+*/
+void exportEnvironment() {
+  static uint32_t lastSequence = 0;
 
-  // Check for incoming data on defined MQTT topic.
-  // This is hard core connection check.
-  // If no data on topic is received, we are not connected to internet or server and watchdog will reset the device.
-  mqtt.loop();
+  if (latestSample.sequence() == lastSequence) {
+    return;
+  }
+
+  LatestSample sample;
+  lastSequence = latestSample.read(sample);
+
+  if (sample.environmentValid) {
+    temperatureGauge.set(sample.temperature);
+    humidityGauge.set(sample.humidity);
+  }
 }
 
 /**
 * @brief Handles the server response received on a specific MQTT topic.
 *
-* This function logs the server response using debug output. If the device status is not
-* in maintenance mode, it also resets the watchdog timer to prevent system reset.
+* This function logs the server response using debug output. The echo of a published
+* position is reported to the recovery ladder as progress.
 *
 * @param topic The MQTT topic on which the server response was received.
 * @param payload Pointer to the payload data received from the server.
@@ -305,204 +552,797 @@ void loop() {
 */
 void serverResponse(char* topic, byte* payload, unsigned int length) {
   debug(SCS, "Server '%s' responded.", mqttServerAddress);
+  mqttResponseCount.increment();
 
-  // Reset WDT.
-  if (deviceStatus != MAINTENANCE_MODE) {
-    resetWatchdog();
+  // The broker echo of our own payload completes its latency record and proves the whole pipeline works.
+  // Retained messages delivered on subscribe do not match a record and are not counted.
+  if (latencyAcknowledge(payload, length)) {
+    recoveryReportProgress();
   }
 }
 
+/**
+* @brief Starts a connection attempt to the configurationured Wi-Fi network.
+*
+* The Wi-Fi driver associates in the background. connectToNetwork() waits for the attempt
+* to complete instead of starting a new one.
+*/
+void beginNetworkAttempt() {
+  energySetState(ENERGY_RADIO, ENERGY_RADIO_CONNECTING);
+
+  // Disable auto-reconnect and set Wi-Fi mode to station mode.
+  WiFi.setAutoReconnect(false);
+  WiFi.mode(WIFI_STA);
+
+  debug(CMD, "Connecting device to '%s'", networkName);
+
+  // Attempt to connect to the Wi-Fi network using configurationured credentials.
+  wifiConnectAttemptCount.increment();
+  WiFi.begin(networkName, networkPass);
+
+  networkAttemptStart = millis();
+  isNetworkAttemptActive = true;
+}
+
 /**
 * @brief Attempt to connect SMAF-DK to the configurationured Wi-Fi network.
 *
-* If SMAF-DK is not connected to the Wi-Fi network, this function tries to establish
-* a connection using the settings from the WiFiconfiguration instance.
+* If SMAF-DK is not connected to the Wi-Fi network, this function waits for the running
+* connection attempt, or starts one using the settings from the WiFiconfiguration instance.
+* It returns as soon as the device is connected.
+*
+* @warning This function may delay for up to NETWORK_CONNECT_TIMEOUT milliseconds while
+* attempting to connect to the Wi-Fi network.
 *
-* @warning This function may delay for extended periods while attempting to connect
-* to the Wi-Fi network.
+* @return true if the device is connected to the Wi-Fi network.
 */
-void connectToNetwork() {
+bool connectToNetwork() {
   if (WiFi.status() != WL_CONNECTED) {
     // Set initial device status.
-    deviceStatus = NOT_READY;
+    setDeviceStatus(NOT_READY);
+    reportLink(LINK_WIFI, false);
 
-    // Disable auto-reconnect and set Wi-Fi mode to station mode.
-    WiFi.setAutoReconnect(false);
-    WiFi.mode(WIFI_STA);
-
-    // Log an error if not connected to the configurationured SSID.
-    debug(ERR, "Device not connected to '%s'.", networkName);
+    if (!isNetworkAttemptActive) {
+      // Log an error if not connected to the configurationured SSID.
+      debug(ERR, "Device not connected to '%s'.", networkName);
+      beginNetworkAttempt();
+    }
 
-    // Keep attempting to connect until successful.
-    while (WiFi.status() != WL_CONNECTED) {
-      debug(CMD, "Connecting device to '%s'", networkName);
+    // Wait for the attempt, but no longer than it takes.
+    while (WiFi.status() != WL_CONNECTED && millis() - networkAttemptStart < NETWORK_CONNECT_TIMEOUT) {
+      delay(100);
+    }
 
-      // Attempt to connect to the Wi-Fi network using configurationured credentials.
-      WiFi.begin(networkName, networkPass);
-      delay(6400);
+    if (WiFi.status() != WL_CONNECTED) {
+      isNetworkAttemptActive = false;
+      return false;
     }
+  }
+
+  // Complete an attempt that succeeded, possibly in the background during boot.
+  if (isNetworkAttemptActive) {
+    isNetworkAttemptActive = false;
 
     // Log successful connection and set device status.
-    debug(SCS, "Device connected to '%s'.", networkName);
+    debug(SCS, "Device connected to '%s' after %u ms.", networkName, (unsigned int)(millis() - networkAttemptStart));
+    wifiConnectCount.increment();
+    energySetState(ENERGY_RADIO, ENERGY_RADIO_CONNECTED);
+
+    // The scrape endpoint can listen once the station interface is up.
+    metricsExporter.begin();
   }
+
+  reportLink(LINK_WIFI, true);
+  return true;
 }
 
 /**
 * @brief Attempt to connect to the configurationured MQTT broker.
 *
-* If the MQTT client is not connected, this function tries to establish a connection
-* to the MQTT broker using the settings from the WiFiconfiguration instance.
+* If the MQTT client is not connected, this function makes a single attempt to establish
+* a connection to the MQTT broker using the settings from the WiFiconfiguration instance.
 *
 * @note Assumes that MQTT configurationuration parameters (server address, port, client ID,
 * username, password) have been previously set in the WiFiconfiguration instance.
 *
-* @warning This function may delay for extended periods while attempting to connect
+* @warning This function may delay for several seconds while attempting to connect
 * to the MQTT broker.
+*
+* @return true if the device is connected to the MQTT broker.
 */
-void connectToMqttBroker() {
-  if (!mqtt.connected()) {
-    // Set initial device status.
-    deviceStatus = NOT_READY;
+bool connectToMqttBroker() {
+  if (mqtt.connected()) {
+    return true;
+  }
 
-    // Set MQTT server and connection parameters.
-    mqtt.setServer(mqttServerAddress, mqttServerPort);
-    // mqtt.setKeepAlive(30000);     // To be configurationured on the settings page.
-    // mqtt.setSocketTimeout(4000);  // To be configurationured on the settings page.
-    mqtt.setCallback(serverResponse);
+  // Set initial device status.
+  setDeviceStatus(NOT_READY);
+  reportLink(LINK_MQTT, false);
+
+  // Set MQTT server and connection parameters.
+  mqtt.setServer(mqttServerAddress, mqttServerPort);
+  // mqtt.setKeepAlive(30000);     // To be configurationured on the settings page.
+  // mqtt.setSocketTimeout(4000);  // To be configurationured on the settings page.
+  mqtt.setCallback(serverResponse);
+
+  // Log an error if not connected.
+  debug(ERR, "Device not connected to MQTT broker '%s'.", mqttServerAddress);
+  debug(CMD, "Connecting device to MQTT broker '%s'.", mqttServerAddress);
+
+  if (!mqtt.connect(mqttClientId, mqttUsername, mqttPass)) {
+    // Retry after a delay if connection failed.
+    mqttConnectFailureCount.increment();
+    delay(4000);
+    return false;
+  }
 
-    // Log an error if not connected.
-    debug(ERR, "Device not connected to MQTT broker '%s'.", mqttServerAddress);
+  // Log successful connection and set device status.
+  debug(SCS, "Device connected to MQTT broker '%s'.", mqttServerAddress);
+  mqttConnectCount.increment();
+  reportLink(LINK_MQTT, true);
 
-    // Keep attempting to connect until successful.
-    while (!mqtt.connected()) {
-      debug(CMD, "Connecting device to MQTT broker '%s'.", mqttServerAddress);
+  // Subscribe to MQTT topic.
+  mqtt.subscribe(mqttTopic);
 
-      if (mqtt.connect(mqttClientId, mqttUsername, mqttPass)) {
-        // Log successful connection and set device status.
-        debug(SCS, "Device connected to MQTT broker '%s'.", mqttServerAddress);
+  // Report the last reset once the broker can be reached again.
+  publishResetLog();
 
-        // Subscribe to MQTT topic.
-        mqtt.subscribe(mqttTopic);
+  setDeviceStatus(WAITING_GNSS);
+  // setDeviceStatus(READY_TO_SEND);
 
-        deviceStatus = WAITING_GNSS;
-        // deviceStatus = READY_TO_SEND;
-      } else {
-        // Retry after a delay if connection failed.
-        delay(4000);
-      }
-    }
+  return true;
+}
+
+/**
+* @brief Publishes a connectivity event when a link changes state.
+*
+* Called from the loop task only. Repeated reports of the same state are ignored, so
+* subscribers see each transition once.
+*
+* @param link The link that was checked.
+* @param connected true if the link is up.
+*/
+void reportLink(LinkEnum link, bool connected) {
+  static bool isLinkUp[] = { false, false };
+
+  if (isLinkUp[link] == connected) {
+    return;
+  }
+
+  isLinkUp[link] = connected;
+
+  ConnectivityEvent event = { link, connected };
+  publishEvent(event);
+}
+
+/**
+* @brief Recovery step that drops the MQTT session.
+*
+* The next loop iteration connects to the broker again with a fresh socket.
+*/
+void reconnectMqttBroker() {
+  mqtt.disconnect();
+  wifiClient.stop();
+  reportLink(LINK_MQTT, false);
+}
+
+/**
+* @brief Recovery step that restarts the Wi-Fi driver.
+*
+* The radio is switched off and back on, which clears a stuck association or DHCP lease.
+* The next loop iteration connects to the network and the broker again.
+*/
+void restartNetwork() {
+  reconnectMqttBroker();
+
+  WiFi.disconnect(true);
+  WiFi.mode(WIFI_OFF);
+  energySetState(ENERGY_RADIO, ENERGY_RADIO_OFF);
+  reportLink(LINK_WIFI, false);
+  delay(200);
+  WiFi.mode(WIFI_STA);
+
+  // The next loop iteration starts a fresh connection attempt.
+  isNetworkAttemptActive = false;
+}
+
+/**
+* @brief Check if the device is associated with the Wi-Fi network.
+*
+* Holds the recovery ladder at the Wi-Fi restart step while the network is out of range.
+*
+* @return true if the Wi-Fi link is up.
+*/
+bool isNetworkConnected() {
+  return WiFi.status() == WL_CONNECTED;
+}
+
+/**
+* @brief Recovery step that re-initializes the I2C peripherals.
+*
+* The acquisition stage owns the I2C bus, so the request is handed to it and carried out
+* before its next GNSS poll.
+*/
+void requestSensorRestart() {
+  isSensorRestartRequested.store(true);
+}
+
+/**
+* @brief Re-initializes the I2C peripherals, called by the acquisition stage.
+*
+* The I2C driver is stopped, a bus held low by a peripheral is released, and the SHT4x
+* and GNSS modules are started again. A module that does not respond is retried by the
+* next step, which reboots the device.
+*/
+void reinitializeSensors() {
+  Wire.end();
+
+  if (!clearI2cBus(I2C_SDA_PIN, I2C_SCL_PIN)) {
+    debug(ERR, "I2C bus is still held low.");
   }
+
+  Wire.setPins(I2C_SDA_PIN, I2C_SCL_PIN);
+  Wire.begin();
+
+  beginSht4();
+  beginGnss();
 }
 
 /**
-* @brief Retrieves the current UTC time as a formatted string.
+* @brief Starts the SHT4x module and applies its settings.
 *
-* This function retrieves the current UTC time using the system time. If successful,
-* it formats the time into a UTC date time string (e.g., "2024-06-20T20:56:59Z").
-* If the UTC time cannot be obtained, it returns "Unknown".
+* @return true if the module responded on the I2C lines.
+*/
+bool beginSht4() {
+  if (!sht4.begin()) {
+    debug(ERR, "SHT4x module not detected on I2C lines.");
+    return false;
+  }
+
+  // Log successful SHT4x module initialization.
+  debug(SCS, "SHT4x module detected on I2C lines.");
+
+  // Set SHT4x precision and heater settings.
+  sht4.setPrecision(SHT4X_HIGH_PRECISION);
+  sht4.setHeater(SHT4X_NO_HEATER);
+
+  return true;
+}
+
+/**
+* @brief Starts the GNSS module and applies its settings.
 *
-* @return A String containing the current UTC time in the specified format, or "Unknown" if the time cannot be retrieved.
+* @return true if the module responded on the I2C lines.
 */
-String getUtcTimeString() {
+bool beginGnss() {
+  if (!gnss.begin()) {
+    debug(ERR, "GNSS module not detected on I2C lines.");
+    return false;
+  }
+
+  // Log successful GNSS module initialization.
+  debug(SCS, "GNSS module detected on I2C lines.");
+
+  // Set the I2C port to output UBX only (turn off NMEA noise).
+  gnss.setI2COutput(COM_TYPE_UBX);
+
+  // Send a PVT solution at every navigation epoch, so the acquisition stage never waits for a poll.
+  gnss.setNavigationFrequency(PIPELINE_NAVIGATION_RATE);
+  gnss.setAutoPVT(true);
+
+  return true;
+}
+
+/**
+* @brief Formats a system time as a UTC time string.
+*
+* This function formats the time into a UTC date time string (e.g., "2024-06-20T20:56:59Z").
+* If the system time was not synchronized yet, it returns "Unknown".
+*
+* @param time System time in seconds since 1970.
+* @return A string containing the UTC time in the specified format, or "Unknown" if the time is not valid.
+*/
+FixedString<24> getUtcTimeString(time_t time) {
   struct tm timeinfo;
+  localtime_r(&time, &timeinfo);
+
+  // The same check as getLocalTime(), the clock starts in 1970 until NTP has synchronized.
+  if (timeinfo.tm_year <= (2016 - 1900)) {
+    return FixedString<24>("Unknown");
+  }
+
+  FixedString<24> timestamp;
+  timestamp.appendf("%04d-%02d-%02dT%02d:%02d:%02dZ", timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday,
+                    timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
+  return timestamp;
+}
+
+/**
+* @brief Reads temperature and humidity from the SHT4x module.
+*
+* @param sample The sample that receives the reading. Left unchanged if the reading fails.
+* @return true if the module was read.
+*/
+bool readEnvironment(LatestSample& sample) {
+  sensors_event_t humidity;
+  sensors_event_t temperature;
+
+  if (!sht4.getEvent(&humidity, &temperature)) {
+    sht4ReadFailureCount.increment();
+    return false;
+  }
+
+  sample.temperature = lroundf(temperature.temperature * 100.0f);
+  sample.humidity = lroundf(humidity.relative_humidity * 100.0f);
+  sample.environmentTime = millis();
+  sample.environmentValid = true;
+
+  return true;
+}
 
-  if (!getLocalTime(&timeinfo)) {
-    return "Unknown";
+/**
+* @brief Retrieves the epoch of the last PVT solution as Unix time.
+*
+* @return The GNSS epoch in microseconds since 1970, or 0 if the GNSS date or time is not valid.
+*/
+uint64_t getGnssEpochMicroseconds() {
+  if (!gnss.getDateValid() || !gnss.getTimeValid()) {
+    return 0;
   }
 
-  // Create a buffer to hold the formatted time string
-  char buffer[80];
-  strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &timeinfo);
-  return String(buffer);
+  uint32_t microsecond = 0;
+  uint32_t second = gnss.getUnixEpoch(microsecond);
+
+  return (uint64_t)second * 1000000ULL + microsecond;
 }
 
 /**
 * @brief Constructs an MQTT message string containing GPS and time-related data.
 *
 * Constructs a JSON-formatted MQTT message string containing various GPS-related data
-* (satellites in range, longitude, latitude, speed, heading, altitude) and time-related
-* information (timestamp, GMT offset, DST offset).
+* (satellites in range, longitude, latitude, speed, heading, altitude), the environment
+* reading (temperature, humidity) and time-related information (timestamp). The message is formatted in place with integer arithmetic only,
+* so it never allocates heap memory.
 *
-* @param timestamp Human-readable timestamp in UTC format.
+* @param message Destination for the message, cleared first.
 * @param satellitesInRange Number of satellites currently in range.
 * @param longitude Longitude value in microdegrees (degrees * 1E-7).
 * @param latitude Latitude value in microdegrees (degrees * 1E-7).
-* @param altitude Altitude value in meters.
-* @param speed Speed value in meters per second.
+* @param altitude Altitude value in millimeters.
+* @param speed Speed value in millimeters per second.
 * @param heading Heading direction in microdegrees (degrees * 1E-5).
-* @return A String containing the constructed MQTT message in JSON format.
-*/
-String constructMqttMessage(uint8_t satellitesInRange, int32_t longitude, int32_t latitude, int32_t altitude, int32_t speed, int32_t heading, String timestamp) {
-  String message;
-
-  message += "{";
-  message += quotation("timestamp") + ":" + quotation(timestamp) + ",";
-  message += quotation("satellites") + ":" + String(satellitesInRange) + ",";
-  message += quotation("longitude") + ":";
-  message += "{";
-  message += quotation("value") + ":" + String((longitude * 1E-7), 6) + ",";
-  message += quotation("unit") + ":" + quotation("deg");
-  message += "},";
-  message += quotation("latitude") + ":";
-  message += "{";
-  message += quotation("value") + ":" + String((latitude * 1E-7), 6) + ",";
-  message += quotation("unit") + ":" + quotation("deg");
-  message += "},";
-  message += quotation("altitude") + ":";
-  message += "{";
-  message += quotation("value") + ":" + String(int((altitude / 1000.0))) + ",";
-  message += quotation("unit") + ":" + quotation("m");
-  message += "},";
-  message += quotation("speed") + ":";
-  message += "{";
-  message += quotation("value") + ":" + String(int((speed / 1000.0) * 3.6)) + ",";
-  message += quotation("unit") + ":" + quotation("km/h");
-  message += "},";
-  message += quotation("heading") + ":";
-  message += "{";
-  message += quotation("value") + ":" + String((heading * 1E-5), 0) + ",";
-  message += quotation("unit") + ":" + quotation("deg");
-  message += "}";
-  message += "}";
-
-  return message;
+* @param timestamp Human-readable timestamp in UTC format.
+* @param environment Latest sample holding the SHT4x reading, left out if not valid or too old.
+* @param traceId Latency trace ID of the record, matched when the broker echoes the message.
+* @param epoch GNSS epoch in microseconds since 1970, or 0 if unknown.
+* @return true if the whole message fit, false if it was truncated.
+*/
+bool constructMqttMessage(PipelinePayload& message, uint8_t satellitesInRange, int32_t longitude, int32_t latitude, int32_t altitude, int32_t speed, int32_t heading, const char* timestamp, const LatestSample& environment, uint32_t traceId, uint64_t epoch) {
+  message.clear();
+
+  message.appendf("{\"timestamp\":\"%s\",", timestamp);
+  message.appendf("\"satellites\":%u,", (unsigned int)satellitesInRange);
+  message.append("\"longitude\":{\"value\":");
+  message.appendDecimal(longitude, 7, 6);
+  message.append(",\"unit\":\"deg\"},");
+  message.append("\"latitude\":{\"value\":");
+  message.appendDecimal(latitude, 7, 6);
+  message.append(",\"unit\":\"deg\"},");
+  message.appendf("\"altitude\":{\"value\":%d,\"unit\":\"m\"},", (int)(altitude / 1000));
+  message.appendf("\"speed\":{\"value\":%d,\"unit\":\"km/h\"},", (int)((int64_t)speed * 36 / 10000));
+  message.append("\"heading\":{\"value\":");
+  message.appendDecimal(heading, 5, 0);
+  message.append(",\"unit\":\"deg\"}");
+
+  if (environment.environmentValid && millis() - environment.environmentTime < PIPELINE_ENVIRONMENT_MAX_AGE) {
+    message.append(",\"temperature\":{\"value\":");
+    message.appendDecimal(environment.temperature, 2, 1);
+    message.append(",\"unit\":\"C\"},");
+    message.append("\"humidity\":{\"value\":");
+    message.appendDecimal(environment.humidity, 2, 1);
+    message.append(",\"unit\":\"%\"}");
+  }
+
+#if LATENCY_TRACE_ID_ENABLED
+  // Trace ID and GNSS epoch let the backend match the record and measure its own ingest latency.
+  message.appendf(",\"trace\":%u", (unsigned int)traceId);
+
+  if (epoch != 0) {
+    message.appendf(",\"epoch_ms\":%llu", (unsigned long long)(epoch / 1000));
+  }
+#endif
+
+  message.append('}');
+
+  return !message.isTruncated();
+}
+
+/**
+* @brief Publishes the folded sampling profile to the MQTT broker.
+*
+* The profile is published in chunks on the "<topic>/profile" topic, one "task;0xpc count"
+* line per entry. Does nothing unless the profiler is compiled in and a dump is waiting.
+*/
+void publishProfile() {
+  char chunk[768];
+
+  if (!profilerNextChunk(chunk, sizeof(chunk))) {
+    return;
+  }
+
+  char profileTopic[128];
+  snprintf(profileTopic, sizeof(profileTopic), "%s/profile", mqttTopic);
+
+  do {
+    mqtt.publish(profileTopic, chunk, false);
+  } while (profilerNextChunk(chunk, sizeof(chunk)));
+
+  debug(CMD, "Sampling profile posted to MQTT topic '%s'.", profileTopic);
+}
+
+/**
+* @brief Publishes the metrics registry to the MQTT broker.
+*
+* The compact JSON stats message is published on the "<topic>/stats" topic once every
+* METRICS_PUBLISH_INTERVAL.
+*/
+void publishStats() {
+  wifiRssiGauge.set(WiFi.RSSI());
+
+  static char stats[2048];
+  metricsExporter.formatJson(stats, sizeof(stats));
+
+  char statsTopic[128];
+  snprintf(statsTopic, sizeof(statsTopic), "%s/stats", mqttTopic);
+
+  if (mqtt.publish(statsTopic, stats, false)) {
+    debug(CMD, "Stats posted to MQTT topic '%s'.", statsTopic);
+  } else {
+    debug(ERR, "Stats could not be posted to MQTT topic '%s'.", statsTopic);
+  }
+}
+
+/**
+* @brief Publishes the reset log to the MQTT broker.
+*
+* The last reset and the rolling reset history are published on the "<topic>/resets" topic
+* once per boot. If publishing fails, it is retried after the next broker connection.
+*/
+void publishResetLog() {
+  if (!isResetLogPending()) {
+    return;
+  }
+
+  char resets[768];
+  formatResetLogJson(resets, sizeof(resets));
+
+  char resetsTopic[128];
+  snprintf(resetsTopic, sizeof(resetsTopic), "%s/resets", mqttTopic);
+
+  if (mqtt.publish(resetsTopic, resets, false)) {
+    markResetLogPublished();
+    debug(CMD, "Reset log posted to MQTT topic '%s'.", resetsTopic);
+  } else {
+    debug(ERR, "Reset log could not be posted to MQTT topic '%s'.", resetsTopic);
+  }
+}
+
+/**
+* @brief Drains the alarm changes published by the health monitor.
+*
+* The health report carries the current alarms, so all queued changes are answered by one report.
+*
+* @return true if the alarms changed since the last call.
+*/
+bool takeAlarmChanges() {
+  bool isAlarmChanged = healthAlarmMailbox.takeOverrun();
+  AlarmEvent event;
+
+  while (healthAlarmMailbox.receive(event)) {
+    isAlarmChanged = true;
+  }
+
+  return isAlarmChanged;
+}
+
+/**
+* @brief Job that publishes the health report to the MQTT broker.
+*
+* The JSON health report is published on the "<topic>/health" topic once every
+* HEALTH_REPORT_INTERVAL, and immediately whenever the health monitor publishes an
+* alarm change.
+*/
+void publishHealth() {
+  static char report[1024];
+  formatHealthJson(report, sizeof(report));
+
+  char healthTopic[128];
+  snprintf(healthTopic, sizeof(healthTopic), "%s/health", mqttTopic);
+
+  if (mqtt.publish(healthTopic, report, false)) {
+    debug(CMD, "Health report posted to MQTT topic '%s'.", healthTopic);
+  } else {
+    debug(ERR, "Health report could not be posted to MQTT topic '%s'.", healthTopic);
+  }
+}
+
+/**
+* @brief Records the time from boot to a milestone, once per boot.
+*
+* @param gauge The gauge holding the milestone time.
+* @param milestone Name of the milestone, used in the terminal.
+*/
+void recordBootMilestone(MetricGauge& gauge, const char* milestone) {
+  if (gauge.value() != 0) {
+    return;
+  }
+
+  uint32_t elapsed = millis();
+  gauge.set(elapsed);
+  debug(LOG, "Boot to %s took %u ms.", milestone, (unsigned int)elapsed);
+}
+
+/**
+* @brief Thread function for the acquisition stage of the position pipeline.
+*
+* This thread owns the I2C bus. It reads every PVT solution the GNSS module sends, stamps
+* it for the latency tracker and hands it to the encode stage. It also reads the SHT4x
+* module periodically, and is the only writer of the latest sample.
+*
+* @param pvParameters Pointer to task parameters (not used in this function).
+*/
+void AcquisitionThread(void* pvParameters) {
+  // The deadline covers a restart of the I2C modules.
+  int8_t acquisitionCheckIn = supervisorRegister("AcquisitionThread", 10000);
+
+  // Master copy of the latest sample, published to the snapshot after every change.
+  LatestSample sample = LatestSample();
+  uint32_t lastEnvironmentRead = millis() - PIPELINE_ENVIRONMENT_INTERVAL;
+
+  for (;;) {
+    supervisorCheckIn(acquisitionCheckIn);
+
+    if (isSensorRestartRequested.exchange(false)) {
+      reinitializeSensors();
+    }
+
+    if (millis() - lastEnvironmentRead >= PIPELINE_ENVIRONMENT_INTERVAL) {
+      lastEnvironmentRead = millis();
+
+      if (readEnvironment(sample)) {
+        latestSample.write(sample);
+      }
+    }
+
+    // getPVT() returns true when a new solution has been received, at PIPELINE_NAVIGATION_RATE.
+    resetLogSetStage(TRACE_PVT_ACQUISITION);
+    uint32_t pvtStart = readCycleCounter();
+
+    if (!gnss.getPVT()) {
+      vTaskDelay(PIPELINE_POLL_INTERVAL / portTICK_PERIOD_MS);
+      continue;
+    }
+
+    PositionRecord record;
+    bool gnssFixOk = gnss.getGnssFixOk();
+    record.satellites = gnss.getSIV();
+    record.latitude = gnss.getLatitude();
+    record.longitude = gnss.getLongitude();
+    record.speed = gnss.getGroundSpeed();
+    record.heading = gnss.getHeading();
+    record.altitude = gnss.getAltitudeMSL();
+    record.positionValid = gnssFixOk && record.latitude != 0 && record.longitude != 0;
+    traceRecord(TRACE_PVT_ACQUISITION, readCycleCounter() - pvtStart);
+
+    // Recorded here, so the time excludes connecting and is also taken without a network.
+    if (record.positionValid) {
+      recordBootMilestone(bootFirstFixGauge, "first fix");
+    }
+
+    gnssSolutionCount.increment();
+    gnssSatelliteGauge.set(record.satellites);
+    energySetState(ENERGY_GNSS, gnssFixOk ? ENERGY_GNSS_TRACKING : ENERGY_GNSS_ACQUISITION);
+
+    // Start following this record from the GNSS epoch to the broker echo.
+    record.epoch = getGnssEpochMicroseconds();
+    record.time = time(NULL);
+    latencyBeginRecord(record.latency, record.epoch);
+
+    positionQueue.push(record);
+
+    FixEvent fix = { (uint32_t)millis(), record.satellites, record.positionValid };
+    publishEvent(fix);
+
+    sample.epoch = record.epoch;
+    sample.fixTime = millis();
+    sample.latitude = record.latitude;
+    sample.longitude = record.longitude;
+    sample.altitude = record.altitude;
+    sample.speed = record.speed;
+    sample.heading = record.heading;
+    sample.satellites = record.satellites;
+    sample.positionValid = record.positionValid;
+    latestSample.write(sample);
+  }
+}
+
+/**
+* @brief Thread function for the encode stage of the position pipeline.
+*
+* This thread formats every PVT solution with a position fix into the MQTT payload,
+* directly into a record of the transport queue.
+*
+* @param pvParameters Pointer to task parameters (not used in this function).
+*/
+void EncodeThread(void* pvParameters) {
+  int8_t encodeCheckIn = supervisorRegister("EncodeThread", 5000);
+  positionQueue.attachConsumer();
+
+  for (;;) {
+    supervisorCheckIn(encodeCheckIn);
+
+    // Wake up at least once a second to check in with the supervisor.
+    PositionRecord position;
+
+    if (!positionQueue.pop(position, 1000)) {
+      continue;
+    }
+
+    EncodedRecord* encoded = encodedQueue.claim();
+
+    if (encoded == nullptr) {
+      continue;
+    }
+
+    encoded->latency = position.latency;
+    encoded->satellites = position.satellites;
+    encoded->positionValid = position.positionValid;
+    encoded->payload.clear();
+
+    // Records without a position fix are not published, so they are not formatted either.
+    if (position.positionValid) {
+      FixedString<24> timestamp;
+      {
+        TRACE_SCOPE(TRACE_TIMESTAMP_FORMAT);
+        timestamp = getUtcTimeString(position.time);
+      }
+
+      // The latest environment reading is read from the snapshot, without waiting for the writer.
+      LatestSample environment;
+      latestSample.read(environment);
+
+      {
+        TRACE_SCOPE(TRACE_PAYLOAD_BUILD);
+        bool isComplete = constructMqttMessage(
+          encoded->payload,
+          position.satellites,
+          position.longitude,
+          position.latitude,
+          position.altitude,
+          position.speed,
+          position.heading,
+          timestamp.c_str(),
+          environment,
+          position.latency.traceId,
+          position.epoch);
+
+        // A truncated payload is not valid JSON, send nothing rather than half a message.
+        if (!isComplete) {
+          debug(ERR, "MQTT payload does not fit the pipeline record.");
+          encoded->payload.clear();
+        }
+      }
+
+      latencyMarkEncoded(encoded->latency);
+    }
+
+    encodedQueue.commit(encoded);
+  }
+}
+
+/**
+* @brief Thread function for starting the SHT4x module during boot.
+*
+* The thread retries until the module responds, reports it to setup() and deletes itself.
+*
+* @param pvParameters Pointer to task parameters (not used in this function).
+*/
+void Sht4BootThread(void* pvParameters) {
+  while (!beginSht4()) {
+    vTaskDelay(800 / portTICK_PERIOD_MS);
+  }
+
+  xEventGroupSetBits(bootEvents, BOOT_SHT4X_READY);
+  vTaskDelete(NULL);
+}
+
+/**
+* @brief Thread function for starting and configuring the GNSS module during boot.
+*
+* The thread retries until the module responds, reports it to setup() and deletes itself.
+*
+* @param pvParameters Pointer to task parameters (not used in this function).
+*/
+void GnssBootThread(void* pvParameters) {
+  while (!beginGnss()) {
+    vTaskDelay(800 / portTICK_PERIOD_MS);
+  }
+
+  xEventGroupSetBits(bootEvents, BOOT_GNSS_READY);
+  vTaskDelete(NULL);
+}
+
+/**
+* @brief Shows the RGB LED pattern of a device status.
+*
+* @param status The device status to indicate.
+*/
+void showDeviceStatus(DeviceStatusEnum status) {
+  if (!visualNotifications) {
+    // Keep the NeoPixel LED strip dark.
+    notifications.clearAllVisualNotifications();
+    return;
+  }
+
+  // Update LED status based on the device status.
+  switch (status) {
+    case NONE:
+      notifications.loadingVisualNotification();
+      break;
+    case NOT_READY:
+      notifications.notReadyVisualNotification();
+      break;
+    case READY_TO_SEND:
+      notifications.readyToSendVisualNotification();
+      break;
+    case WAITING_GNSS:
+      notifications.waitingGnssFixVisualNotification();
+      break;
+    case MAINTENANCE_MODE:
+      notifications.maintenanceVisualNotification();
+      break;
+  }
 }
 
 /**
 * @brief Thread function for handling device status indications through an RGB LED.
 *
-* This thread continuously updates the RGB LED status based on the current device status.
-* It uses the DeviceStatusEnum values to determine the appropriate LED indication.
+* This thread sleeps until a status event is posted, then selects the RGB LED pattern that
+* matches the new device status or plays the one-shot indication of the event. The patterns
+* themselves are played by the notification frame timer.
 *
 * @param pvParameters Pointer to task parameters (not used in this function).
 */
 void DeviceStatusThread(void* pvParameters) {
+  int8_t statusCheckIn = supervisorRegister("DeviceStatusThread", 5000);
+
+  attachStatusListener();
+  showDeviceStatus(getDeviceStatus());
+
   for (;;) {
-    // Clear the NeoPixel LED strip.
-    notifications.clearAllVisualNotifications();
+    supervisorCheckIn(statusCheckIn);
 
-    if (visualNotifications) {
-      // Update LED status based on the current device status.
-      switch (deviceStatus) {
-        case NONE:
-          notifications.loadingVisualNotification();
-          break;
-        case NOT_READY:
-          notifications.notReadyVisualNotification();
-          break;
-        case READY_TO_SEND:
-          notifications.readyToSendVisualNotification();
-          break;
-        case WAITING_GNSS:
-          notifications.waitingGnssFixVisualNotification();
-          break;
-        case MAINTENANCE_MODE:
-          notifications.maintenanceVisualNotification();
-          break;
-      }
+    // Wake up at least once a second to check in with the supervisor.
+    StatusEvent event;
+
+    if (!waitStatusEvent(event, 1000)) {
+      continue;
     }
 
-    // Add a delay to prevent WDT timeout.
-    vTaskDelay(10 / portTICK_PERIOD_MS); // Delay for 10 milliseconds.
+    switch (event.type) {
+      case STATUS_CHANGED:
+        showDeviceStatus(event.status);
+        break;
+      case STATUS_PUBLISHED:
+        if (visualNotifications) {
+          notifications.publishedVisualNotification();
+        }
+        break;
+      case STATUS_FIX_LOST:
+        if (visualNotifications) {
+          notifications.fixLostVisualNotification();
+        }
+        break;
+    }
   }
-}
\ No newline at end of file
+}
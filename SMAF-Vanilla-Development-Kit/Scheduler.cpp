@@ -0,0 +1,230 @@
+/**
+* @file Scheduler.cpp
+* @brief Implementation of the deadline scheduler for Arduino project.
+*
+* This file contains the implementation of the cooperative scheduler of the loop task.
+* The scheduled jobs live in a fixed array ordered as a binary min-heap by release time,
+* and every job remembers its position in the heap, so rescheduling and cancelling never
+* search the array and never allocate. Release times are kept in 64-bit microseconds of
+* the high-resolution timer, which does not wrap during the lifetime of the device.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Arduino.h"
+#include "Scheduler.h"
+#include "Helpers.h"
+#include "esp_timer.h"
+
+static_assert(SCHEDULER_MAX_JOBS <= 127, "Heap positions must fit the job heap index.");
+
+// Scheduled jobs, ordered as a min-heap by release time. Only used from the loop task.
+static SchedulerJob* heap[SCHEDULER_MAX_JOBS];
+static uint8_t heapSize = 0;
+
+/**
+* @brief Constructs a job that is not scheduled yet.
+*
+* @param name Name of the job, used in the terminal.
+* @param callback Function that carries out the job.
+* @param period Time between releases in milliseconds, 0 for a one-shot job.
+* @param tolerance Lateness in milliseconds after which a run counts as a missed deadline.
+* @param missedName Metric name of the missed deadline counter.
+* @param latenessName Metric name of the lateness histogram.
+*/
+SchedulerJob::SchedulerJob(const char* name, SchedulerCallback callback, uint32_t period, uint32_t tolerance, const char* missedName, const char* latenessName)
+  : _name(name),
+    _callback(callback),
+    _period(period),
+    _tolerance(tolerance),
+    _releaseTime(0),
+    _heapIndex(-1),
+    _missedCount(missedName, "Runs of the job that started later than its tolerance."),
+    _lateness(latenessName, "Time from the release of the job to its start, in microseconds.") {
+}
+
+/**
+* @brief Moves a job towards the root until its parent is released no later than the job.
+*
+* @param index Heap position of the job.
+*/
+void SchedulerJob::siftUp(uint8_t index) {
+  SchedulerJob* job = heap[index];
+
+  while (index > 0) {
+    uint8_t parent = (index - 1) / 2;
+
+    if (heap[parent]->_releaseTime <= job->_releaseTime) {
+      break;
+    }
+
+    heap[index] = heap[parent];
+    heap[index]->_heapIndex = index;
+    index = parent;
+  }
+
+  heap[index] = job;
+  job->_heapIndex = index;
+}
+
+/**
+* @brief Moves a job towards the leaves until no child is released before the job.
+*
+* @param index Heap position of the job.
+*/
+void SchedulerJob::siftDown(uint8_t index) {
+  SchedulerJob* job = heap[index];
+
+  for (;;) {
+    uint8_t child = 2 * index + 1;
+
+    if (child >= heapSize) {
+      break;
+    }
+
+    // Follow the child that is released first.
+    if (child + 1 < heapSize && heap[child + 1]->_releaseTime < heap[child]->_releaseTime) {
+      child++;
+    }
+
+    if (job->_releaseTime <= heap[child]->_releaseTime) {
+      break;
+    }
+
+    heap[index] = heap[child];
+    heap[index]->_heapIndex = index;
+    index = child;
+  }
+
+  heap[index] = job;
+  job->_heapIndex = index;
+}
+
+/**
+* @brief Removes the job at a heap position and fills the gap with the last job.
+*
+* @param index Heap position of the job.
+*/
+void SchedulerJob::removeFromHeap(uint8_t index) {
+  heap[index]->_heapIndex = -1;
+  heapSize--;
+
+  if (index == heapSize) {
+    return;
+  }
+
+  // The last job can belong above or below the gap.
+  SchedulerJob* last = heap[heapSize];
+  heap[index] = last;
+  siftDown(index);
+  siftUp(last->_heapIndex);
+}
+
+/**
+* @brief Schedules a job, or moves its next release if it is already scheduled.
+*
+* @param job The job to schedule.
+* @param delay Time from now to the release in milliseconds, 0 to run it on the next schedulerRun().
+* @return true if the job was scheduled, false if SCHEDULER_MAX_JOBS are already scheduled.
+*/
+bool scheduleJob(SchedulerJob& job, uint32_t delay) {
+  job._releaseTime = esp_timer_get_time() + (int64_t)delay * 1000;
+
+  if (job.isScheduled()) {
+    uint8_t index = job._heapIndex;
+    SchedulerJob::siftDown(index);
+    SchedulerJob::siftUp(job._heapIndex);
+    return true;
+  }
+
+  if (heapSize >= SCHEDULER_MAX_JOBS) {
+    debug(ERR, "Job '%s' not scheduled, %u jobs are already scheduled.", job._name, SCHEDULER_MAX_JOBS);
+    return false;
+  }
+
+  heap[heapSize] = &job;
+  heapSize++;
+  SchedulerJob::siftUp(heapSize - 1);
+  return true;
+}
+
+/**
+* @brief Removes a job from the schedule. Does nothing if it is not scheduled.
+*
+* @param job The job to remove.
+*/
+void cancelJob(SchedulerJob& job) {
+  if (job.isScheduled()) {
+    SchedulerJob::removeFromHeap(job._heapIndex);
+  }
+}
+
+/**
+* @brief Runs every released job, then sleeps until the next release.
+*
+* The sleep is a task notification wait, so it ends early when the loop task is notified,
+* and it never exceeds SCHEDULER_MAX_SLEEP.
+*/
+void schedulerRun() {
+  int64_t now = esp_timer_get_time();
+
+  while (heapSize > 0 && heap[0]->_releaseTime <= now) {
+    SchedulerJob* job = heap[0];
+    int64_t lateness = now - job->_releaseTime;
+
+    job->_lateness.observe(lateness < UINT32_MAX ? (uint32_t)lateness : UINT32_MAX);
+
+    if (lateness > (int64_t)job->_tolerance * 1000) {
+      job->_missedCount.increment();
+    }
+
+    // Schedule the next release before the run, so the job can change its own schedule.
+    if (job->_period == 0) {
+      SchedulerJob::removeFromHeap(0);
+    } else {
+      job->_releaseTime += (int64_t)job->_period * 1000;
+
+      // Skip the releases missed while the loop task was held up, for example by a reconnect.
+      if (job->_releaseTime <= now) {
+        job->_releaseTime = now + (int64_t)job->_period * 1000;
+      }
+
+      SchedulerJob::siftDown(0);
+    }
+
+    job->_callback();
+    now = esp_timer_get_time();
+  }
+
+  int64_t sleepTime = (int64_t)SCHEDULER_MAX_SLEEP * 1000;
+
+  if (heapSize > 0 && heap[0]->_releaseTime - now < sleepTime) {
+    sleepTime = heap[0]->_releaseTime - now;
+  }
+
+  if (sleepTime <= 0) {
+    return;
+  }
+
+  // Round up to whole ticks, waking before the release would only cost another pass.
+  uint32_t sleepMilliseconds = (sleepTime + 999) / 1000;
+  ulTaskNotifyTake(pdTRUE, (sleepMilliseconds + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS);
+}
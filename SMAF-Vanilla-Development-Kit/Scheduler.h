@@ -0,0 +1,138 @@
+/**
+* @file Scheduler.h
+* @brief Declaration of the deadline scheduler for Arduino project.
+*
+* This file contains the declarations of the cooperative scheduler that runs the periodic
+* and one-shot jobs of the loop task. Scheduled jobs are kept in a binary min-heap ordered
+* by release time, so finding the next job is constant time and scheduling is logarithmic.
+* Between jobs the loop task blocks until the next release, and the idle task can put the
+* CPU to sleep instead of the loop polling every function for whether it is due.
+*
+* Every job measures its lateness, the time from its release to its start, into its own
+* histogram, and counts the runs that started later than its tolerance as missed deadlines.
+*
+* @note All functions must be called from the loop task. Jobs run in the loop task too.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "Arduino.h"
+#include "Metrics.h"
+
+// Define scheduler parameters.
+#define SCHEDULER_MAX_JOBS 16     // Jobs that can be scheduled at the same time.
+#define SCHEDULER_MAX_SLEEP 1000  // Longest time the loop task sleeps in milliseconds, bounds the time between supervisor check-ins.
+
+// Function that carries out a job.
+typedef void (*SchedulerCallback)();
+
+class SchedulerJob {
+public:
+  /**
+  * @brief Constructs a job that is not scheduled yet.
+  *
+  * Use the SCHEDULER_JOB macro, which derives the metric names from the job name.
+  *
+  * @param name Name of the job, used in the terminal.
+  * @param callback Function that carries out the job.
+  * @param period Time between releases in milliseconds, 0 for a one-shot job.
+  * @param tolerance Lateness in milliseconds after which a run counts as a missed deadline.
+  * @param missedName Metric name of the missed deadline counter.
+  * @param latenessName Metric name of the lateness histogram.
+  */
+  SchedulerJob(const char* name, SchedulerCallback callback, uint32_t period, uint32_t tolerance, const char* missedName, const char* latenessName);
+
+  /**
+  * @brief Get the name of the job.
+  *
+  * @return Constant string naming the job.
+  */
+  const char* name() const {
+    return _name;
+  }
+
+  /**
+  * @brief Check if the job waits for a release.
+  *
+  * @return true if the job is scheduled.
+  */
+  bool isScheduled() const {
+    return _heapIndex >= 0;
+  }
+
+private:
+  friend bool scheduleJob(SchedulerJob& job, uint32_t delay);
+  friend void cancelJob(SchedulerJob& job);
+  friend void schedulerRun();
+
+  static void siftUp(uint8_t index);
+  static void siftDown(uint8_t index);
+  static void removeFromHeap(uint8_t index);
+
+  const char* _name;
+  SchedulerCallback _callback;
+  uint32_t _period;             // Time between releases in milliseconds, 0 for a one-shot job.
+  uint32_t _tolerance;          // Lateness in milliseconds that still meets the deadline.
+  int64_t _releaseTime;         // Next release in microseconds since boot.
+  int8_t _heapIndex;            // Position in the heap, -1 while not scheduled.
+  MetricCounter _missedCount;   // Runs that started after their deadline.
+  MetricHistogram _lateness;    // Time from release to start in microseconds.
+};
+
+// Defines a job whose metrics are named smaf_job_<name>_missed_total and smaf_job_<name>_lateness_us.
+#define SCHEDULER_JOB(variable, name, callback, period, tolerance) \
+  SchedulerJob variable(#name, callback, period, tolerance, "smaf_job_" #name "_missed_total", "smaf_job_" #name "_lateness_us")
+
+/**
+* @brief Schedules a job, or moves its next release if it is already scheduled.
+*
+* A periodic job is released again one period after every release. A one-shot job runs
+* once and is then no longer scheduled.
+*
+* @param job The job to schedule.
+* @param delay Time from now to the release in milliseconds, 0 to run it on the next schedulerRun().
+* @return true if the job was scheduled, false if SCHEDULER_MAX_JOBS are already scheduled.
+*/
+bool scheduleJob(SchedulerJob& job, uint32_t delay);
+
+/**
+* @brief Removes a job from the schedule. Does nothing if it is not scheduled.
+*
+* @param job The job to remove.
+*/
+void cancelJob(SchedulerJob& job);
+
+/**
+* @brief Runs every released job, then sleeps until the next release.
+*
+* Jobs run in release order. A periodic job is scheduled again before it runs, so it can
+* change or cancel its own schedule. A periodic job that falls more than a period behind
+* skips the releases it missed instead of running several times in a row.
+*
+* The sleep is a task notification wait, so it ends early when the loop task is notified,
+* for example by the pipeline or an event mailbox, and it never exceeds SCHEDULER_MAX_SLEEP.
+*/
+void schedulerRun();
+
+#endif
@@ -0,0 +1,202 @@
+/**
+* @file Seqlock.h
+* @brief Declaration and implementation of a seqlock-protected snapshot.
+*
+* This file contains a single-writer, multi-reader snapshot of a plain data structure
+* that can be shared between tasks running on both ESP32 cores. The writer bumps a
+* sequence number before and after every update and never waits for readers. Readers
+* copy the data and compare the sequence number before and after the copy, so a copy
+* torn by a concurrent update is detected and retried. Readers that want every update
+* can attach themselves and sleep until the writer notifies them.
+*
+* @note The implementation lives in this header because the snapshot is a class template.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include "Arduino.h"
+#include <atomic>
+#include <type_traits>
+
+// Define seqlock parameters.
+#define SEQLOCK_MAX_LISTENERS 4       // Tasks that can wait for updates of a single snapshot.
+#define SEQLOCK_SPINS_BEFORE_SLEEP 8  // Torn reads in a row before a reader sleeps for a tick.
+
+template <typename T>
+class Seqlock {
+  static_assert(std::is_trivially_copyable<T>::value, "Seqlock data must be trivially copyable.");
+
+public:
+  /**
+  * @brief Constructs a snapshot holding a value-initialized T.
+  */
+  Seqlock()
+    : _sequence(0),
+      _listenerClaims(0),
+      _data() {
+    for (uint8_t i = 0; i < SEQLOCK_MAX_LISTENERS; ++i) {
+      _listeners[i].store(NULL, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+  * @brief Replaces the snapshot and wakes the attached readers.
+  *
+  * Never blocks. Must always be called from the same task, the seqlock has a single writer.
+  *
+  * @param value The new value.
+  */
+  void write(const T& value) {
+    uint32_t sequence = _sequence.load(std::memory_order_relaxed);
+
+    // An odd sequence number marks the update in progress.
+    _sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    memcpy(const_cast<T*>(&_data), &value, sizeof(T));
+
+    _sequence.store(sequence + 2, std::memory_order_release);
+
+    uint8_t count = _listenerClaims.load(std::memory_order_relaxed);
+
+    // A claimed slot stays null until its listener is stored.
+    for (uint8_t i = 0; i < count; ++i) {
+      TaskHandle_t listener = _listeners[i].load(std::memory_order_acquire);
+
+      if (listener != NULL) {
+        xTaskNotifyGive(listener);
+      }
+    }
+  }
+
+  /**
+  * @brief Copies the snapshot if no update is in progress.
+  *
+  * @param value Destination for the copy, undefined if the read failed.
+  * @param sequence Destination for the sequence number of the copy, may be null.
+  * @return true if the copy is consistent, false if it was torn by an update.
+  */
+  bool tryRead(T& value, uint32_t* sequence = nullptr) const {
+    uint32_t before = _sequence.load(std::memory_order_acquire);
+
+    if (before & 1) {
+      return false;
+    }
+
+    memcpy(&value, const_cast<const T*>(&_data), sizeof(T));
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (_sequence.load(std::memory_order_relaxed) != before) {
+      return false;
+    }
+
+    if (sequence != nullptr) {
+      *sequence = before;
+    }
+
+    return true;
+  }
+
+  /**
+  * @brief Copies the snapshot, retrying until the copy is consistent.
+  *
+  * Retries only while an update is in progress. A reader that keeps colliding with the
+  * writer sleeps for a tick, so it cannot starve a lower-priority writer on its core.
+  *
+  * @param value Destination for the copy.
+  * @return The sequence number of the copy, pass it to waitForUpdate().
+  */
+  uint32_t read(T& value) const {
+    uint32_t sequence = 0;
+
+    for (uint8_t attempt = 1; !tryRead(value, &sequence); ++attempt) {
+      if (attempt % SEQLOCK_SPINS_BEFORE_SLEEP == 0) {
+        vTaskDelay(1);
+      }
+    }
+
+    return sequence;
+  }
+
+  /**
+  * @brief Get the sequence number of the last completed update.
+  *
+  * @return An even number that changes with every update, 0 before the first one.
+  */
+  uint32_t sequence() const {
+    return _sequence.load(std::memory_order_acquire) & ~1U;
+  }
+
+  /**
+  * @brief Registers the calling task to be notified of every update.
+  *
+  * The writer wakes readers with a task notification, so the calling task must tolerate
+  * wake-ups shared with other notification sources.
+  *
+  * @return true if the task was registered, false if all listener slots are taken.
+  */
+  bool attachListener() {
+    // Claim a slot. The count never passes the number of slots, so failed calls cannot wrap it.
+    uint8_t slot = _listenerClaims.load(std::memory_order_relaxed);
+
+    do {
+      if (slot >= SEQLOCK_MAX_LISTENERS) {
+        return false;
+      }
+    } while (!_listenerClaims.compare_exchange_weak(slot, slot + 1, std::memory_order_relaxed));
+
+    // Never waits for other attaches, the writer skips slots that are not stored yet.
+    _listeners[slot].store(xTaskGetCurrentTaskHandle(), std::memory_order_release);
+
+    return true;
+  }
+
+  /**
+  * @brief Waits until the snapshot is newer than a previously read copy.
+  *
+  * Must only be called from a task registered with attachListener().
+  *
+  * @param lastSequence Sequence number returned by read() for the last copy.
+  * @param timeout Time to wait in milliseconds.
+  * @return true if an update is available, false if none arrived within the timeout or
+  *         the wait was ended early by another notification of the task.
+  */
+  bool waitForUpdate(uint32_t lastSequence, uint32_t timeout) const {
+    if (sequence() != lastSequence) {
+      return true;
+    }
+
+    // An update after the check above leaves a notification, so none is missed.
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout));
+    return sequence() != lastSequence;
+  }
+
+private:
+  std::atomic<uint32_t> _sequence;                              // Odd while an update is in progress.
+  std::atomic<uint8_t> _listenerClaims;                         // Listener slots handed out, stops at SEQLOCK_MAX_LISTENERS.
+  std::atomic<TaskHandle_t> _listeners[SEQLOCK_MAX_LISTENERS];  // Tasks notified of updates.
+  volatile T _data;                                             // The shared snapshot.
+};
+
+#endif
@@ -0,0 +1,127 @@
+/**
+* @file StatusChannel.cpp
+* @brief Implementation of the device status channel for Arduino project.
+*
+* This file contains the implementation of the functions that pass the device status from the
+* tasks that change it to the task that indicates it. The current status is kept in an atomic
+* word that any task can read, and every change is also published on the event bus together
+* with one-shot events such as a published position. The listening task owns the status
+* mailbox and sleeps until an event is posted, so short-lived states are never missed and
+* nothing is polled.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Arduino.h"
+#include "StatusChannel.h"
+#include "Events.h"
+#include "Metrics.h"
+#include <atomic>
+
+// Current device status.
+static std::atomic<uint8_t> deviceStatus(NONE);
+
+// Events waiting for the listener.
+EventMailbox<StatusEvent, STATUS_EVENT_CAPACITY> statusMailbox("smaf_status_events_dropped_total", "Status events dropped because the queue was full.");
+
+// Status channel metrics.
+static MetricCounter statusEventCount("smaf_status_events_total", "Events posted to the status channel.");
+
+/**
+* @brief Publishes an event to the status listener.
+*
+* @param type The event to post.
+* @param status The device status at the time of the event.
+*/
+static void postEvent(StatusEventEnum type, DeviceStatusEnum status) {
+  StatusEvent event = { type, status };
+
+  statusEventCount.increment();
+  publishEvent(event);
+}
+
+/**
+* @brief Sets the device status and posts a STATUS_CHANGED event if it differs.
+*
+* @param status The new device status.
+*/
+void setDeviceStatus(DeviceStatusEnum status) {
+  if (deviceStatus.exchange(status, std::memory_order_acq_rel) != status) {
+    postEvent(STATUS_CHANGED, status);
+  }
+}
+
+/**
+* @brief Get the current device status.
+*
+* @return The device status, read with a single atomic load.
+*/
+DeviceStatusEnum getDeviceStatus() {
+  return (DeviceStatusEnum)deviceStatus.load(std::memory_order_acquire);
+}
+
+/**
+* @brief Posts a one-shot event.
+*
+* If the queue is full, the event is dropped and counted.
+*
+* @param type The event to post.
+*/
+void postStatusEvent(StatusEventEnum type) {
+  postEvent(type, getDeviceStatus());
+}
+
+/**
+* @brief Makes the calling task the listener that is woken by posted events.
+*/
+void attachStatusListener() {
+  statusMailbox.attach();
+}
+
+/**
+* @brief Waits for the next event.
+*
+* Must be called from the listener task. After events were dropped, a STATUS_CHANGED event
+* with the current status is delivered once the queue is drained, so the listener never
+* keeps showing an outdated status.
+*
+* @param event Destination for the event.
+* @param timeout Longest time to wait in milliseconds.
+* @return true if an event was delivered, false if the timeout expired.
+*/
+bool waitStatusEvent(StatusEvent& event, uint32_t timeout) {
+  for (;;) {
+    if (statusMailbox.receive(event)) {
+      return true;
+    }
+
+    if (statusMailbox.takeOverrun()) {
+      event.type = STATUS_CHANGED;
+      event.status = getDeviceStatus();
+      return true;
+    }
+
+    // Sleep until a producer posts. Several posts can be collected by one wake-up.
+    if (!waitForEvents(timeout)) {
+      return false;
+    }
+  }
+}
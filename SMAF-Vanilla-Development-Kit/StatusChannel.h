@@ -0,0 +1,109 @@
+/**
+* @file StatusChannel.h
+* @brief Declaration of the device status channel for Arduino project.
+*
+* This file contains the declarations of the functions that pass the device status from the
+* tasks that change it to the task that indicates it. The current status is kept in an atomic
+* word that any task can read, and every change is also posted to a bounded lock-free queue
+* together with one-shot events such as a published position. The listening task sleeps until
+* an event is posted, so short-lived states are never missed and nothing is polled.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#ifndef STATUS_CHANNEL_H
+#define STATUS_CHANNEL_H
+
+#include "Arduino.h"
+
+// Define status channel parameters.
+#define STATUS_EVENT_CAPACITY 16  // Events waiting for the listener, must be a power of two.
+
+// Enum to represent different device statuses.
+enum DeviceStatusEnum : byte {
+  NONE,             // Disable RGB led.
+  NOT_READY,        // Device is not ready.
+  READY_TO_SEND,    // Device is ready to send data.
+  WAITING_GNSS,     // Device is waiting for GNSS data.
+  MAINTENANCE_MODE  // Device is in maintenance mode.
+};
+
+/**
+* @enum StatusEventEnum
+* @brief Enumeration of the events posted to the status channel.
+*/
+enum StatusEventEnum : byte {
+  STATUS_CHANGED,    // The device status changed.
+  STATUS_PUBLISHED,  // A position was published to the MQTT broker.
+  STATUS_FIX_LOST    // The GNSS fix was lost while positions were being published.
+};
+
+/**
+* @struct StatusEvent
+* @brief Event delivered to the status listener.
+*/
+struct StatusEvent {
+  StatusEventEnum type;     // What happened.
+  DeviceStatusEnum status;  // Device status when the event was posted.
+};
+
+/**
+* @brief Sets the device status and posts a STATUS_CHANGED event if it differs.
+*
+* @param status The new device status.
+*/
+void setDeviceStatus(DeviceStatusEnum status);
+
+/**
+* @brief Get the current device status.
+*
+* @return The device status, read with a single atomic load.
+*/
+DeviceStatusEnum getDeviceStatus();
+
+/**
+* @brief Posts a one-shot event.
+*
+* If the queue is full, the event is dropped and counted.
+*
+* @param type The event to post.
+*/
+void postStatusEvent(StatusEventEnum type);
+
+/**
+* @brief Makes the calling task the listener that is woken by posted events.
+*/
+void attachStatusListener();
+
+/**
+* @brief Waits for the next event.
+*
+* Must be called from the listener task. After events were dropped, a STATUS_CHANGED event
+* with the current status is delivered once the queue is drained, so the listener never
+* keeps showing an outdated status.
+*
+* @param event Destination for the event.
+* @param timeout Longest time to wait in milliseconds.
+* @return true if an event was delivered, false if the timeout expired.
+*/
+bool waitStatusEvent(StatusEvent& event, uint32_t timeout);
+
+#endif
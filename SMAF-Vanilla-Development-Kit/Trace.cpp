@@ -0,0 +1,104 @@
+/**
+* @file Trace.cpp
+* @brief Implementation of hot-path stage tracing for Arduino project.
+*
+* This file contains the implementation of the stage tracing functions used in the Arduino
+* project. Trace points read the CPU cycle counter at the start and end of a pipeline stage
+* and record the duration into a log-linear histogram per stage. The histograms are exported
+* periodically to the Serial monitor as percentiles in microseconds, so regressions between
+* builds are visible without attaching a debugger.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Arduino.h"
+#include "Trace.h"
+#include "Histogram.h"
+#include "Helpers.h"
+
+/**
+* @brief Get the name of a traced stage.
+*
+* @param stage The traced stage.
+* @return Constant string naming the stage.
+*/
+const char* traceStageName(TraceStageEnum stage) {
+  switch (stage) {
+    case TRACE_PVT_ACQUISITION:
+      return "pvt";
+    case TRACE_TIMESTAMP_FORMAT:
+      return "timestamp";
+    case TRACE_PAYLOAD_BUILD:
+      return "payload";
+    case TRACE_PUBLISH:
+      return "publish";
+    case TRACE_MQTT_LOOP:
+      return "mqtt-loop";
+    default:
+      return "unknown";
+  }
+}
+
+#if TRACE_ENABLED
+// One histogram of durations in CPU cycles per stage.
+static LogLinearHistogram stageHistograms[TRACE_STAGE_COUNT];
+
+/**
+* @brief Records the duration of a stage.
+*
+* @param stage The traced stage.
+* @param cycles The duration of the stage in CPU cycles.
+*/
+void traceRecord(TraceStageEnum stage, uint32_t cycles) {
+  if (stage < TRACE_STAGE_COUNT) {
+    stageHistograms[stage].record(cycles);
+  }
+}
+
+/**
+* @brief Exports the stage histograms.
+*
+* This function logs p50, p90, p99 and maximum durations for every stage that ran since
+* the last export, then resets the histograms to start a new interval. It is called by the
+* scheduler once every TRACE_EXPORT_INTERVAL.
+*/
+void traceExport() {
+  // Reused for every stage.
+  static HistogramSnapshot snapshot;
+  uint32_t cyclesPerMicrosecond = getCpuFrequencyMhz();
+
+  for (uint8_t stage = 0; stage < TRACE_STAGE_COUNT; ++stage) {
+    stageHistograms[stage].snapshot(snapshot, true);
+
+    if (snapshot.count == 0) {
+      continue;
+    }
+
+    debug(LOG, "Trace '%s': %u samples, p50 %u us, p90 %u us, p99 %u us, max %u us.",
+          traceStageName((TraceStageEnum)stage),
+          snapshot.count,
+          snapshot.percentile(50) / cyclesPerMicrosecond,
+          snapshot.percentile(90) / cyclesPerMicrosecond,
+          snapshot.percentile(99) / cyclesPerMicrosecond,
+          snapshot.max / cyclesPerMicrosecond);
+  }
+}
+#endif
@@ -0,0 +1,142 @@
+/**
+* @file Trace.h
+* @brief Declaration of hot-path stage tracing for Arduino project.
+*
+* This file contains the declarations of the stage tracing functions used in the Arduino
+* project. Trace points read the CPU cycle counter at the start and end of a pipeline stage
+* and record the duration into a log-linear histogram per stage. The histograms are exported
+* periodically to the Serial monitor as percentiles in microseconds, so regressions between
+* builds are visible without attaching a debugger.
+*
+* @note Set TRACE_ENABLED to 0 to remove all trace points at compile time.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "Arduino.h"
+#include "ResetLog.h"
+
+// Enable stage tracing (0 = disabled, 1 = enabled). Override with a build flag.
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 1
+#endif
+
+// Interval between histogram exports in milliseconds.
+#define TRACE_EXPORT_INTERVAL 60000
+
+/**
+* @enum TraceStageEnum
+* @brief Enumeration of the traced pipeline stages.
+*/
+enum TraceStageEnum : byte {
+  TRACE_PVT_ACQUISITION,   // Reading a new PVT solution from the GNSS module.
+  TRACE_TIMESTAMP_FORMAT,  // Formatting the UTC timestamp.
+  TRACE_PAYLOAD_BUILD,     // Constructing the MQTT payload.
+  TRACE_PUBLISH,           // Publishing the payload to the MQTT broker.
+  TRACE_MQTT_LOOP,         // Servicing the MQTT client.
+  TRACE_STAGE_COUNT        // Number of traced stages.
+};
+
+/**
+* @brief Reads the CPU cycle counter of the current core.
+*
+* @return The current cycle count. Wraps around roughly every 18 seconds at 240 MHz.
+*/
+static inline uint32_t readCycleCounter() {
+  return ESP.getCycleCount();
+}
+
+#if TRACE_ENABLED
+/**
+* @brief Records the duration of a stage.
+*
+* @param stage The traced stage.
+* @param cycles The duration of the stage in CPU cycles.
+*/
+void traceRecord(TraceStageEnum stage, uint32_t cycles);
+
+/**
+* @brief Exports the stage histograms.
+*
+* This function logs p50, p90, p99 and maximum durations for every stage that ran since
+* the last export, then resets the histograms to start a new interval. It is called by the
+* scheduler once every TRACE_EXPORT_INTERVAL.
+*/
+void traceExport();
+#else
+static inline void traceRecord(TraceStageEnum, uint32_t) {}
+static inline void traceExport() {}
+#endif
+
+/**
+* @brief Get the name of a traced stage.
+*
+* @param stage The traced stage.
+* @return Constant string naming the stage.
+*/
+const char* traceStageName(TraceStageEnum stage);
+
+/**
+* @brief Records the duration of the enclosing scope as a stage.
+*
+* The constructor reads the cycle counter and the destructor records the elapsed cycles.
+* The stage is also stored as the reset log breadcrumb, even when tracing is disabled.
+* Call cancel() to discard the measurement, for example when the stage did no work.
+*/
+class TraceScope {
+public:
+#if TRACE_ENABLED
+  explicit TraceScope(TraceStageEnum stage)
+    : _stage(stage), _start(readCycleCounter()), _active(true) {
+    resetLogSetStage(stage);
+  }
+
+  ~TraceScope() {
+    if (_active) {
+      traceRecord(_stage, readCycleCounter() - _start);
+    }
+  }
+
+  void cancel() {
+    _active = false;
+  }
+
+private:
+  TraceStageEnum _stage;
+  uint32_t _start;
+  bool _active;
+#else
+  explicit TraceScope(TraceStageEnum stage) {
+    resetLogSetStage(stage);
+  }
+  void cancel() {}
+#endif
+};
+
+// Declare a trace scope named after the current line.
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(stage) TraceScope TRACE_CONCAT(traceScope, __LINE__)(stage)
+
+#endif
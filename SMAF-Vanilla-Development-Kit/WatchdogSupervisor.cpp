@@ -0,0 +1,218 @@
+/**
+* @file WatchdogSupervisor.cpp
+* @brief Implementation of the multi-task watchdog supervisor for Arduino project.
+*
+* This file contains the implementation of the watchdog supervisor. Only the supervisor
+* thread is attached to the hardware task watchdog. Supervised tasks record their check-in
+* time with a single atomic store, and the supervisor compares it against their deadlines.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "Arduino.h"
+#include "WatchdogSupervisor.h"
+#include "ResetLog.h"
+#include "Helpers.h"
+#include "esp_task_wdt.h"
+#include <atomic>
+
+/**
+* @struct SupervisedTask
+* @brief Supervision state of a single task.
+*/
+struct SupervisedTask {
+  const char* name;                   // Name reported when the deadline is missed.
+  uint32_t deadline;                  // Longest allowed time between check-ins in milliseconds.
+  std::atomic<uint32_t> lastCheckIn;  // Time of the last check-in in milliseconds.
+  std::atomic<bool> enabled;          // Whether the task is currently supervised.
+  std::atomic<bool> isReady;          // Whether the slot is filled in, the supervisor skips it until then.
+};
+
+// Supervised tasks. Slots are handed out once and never released.
+static SupervisedTask supervisedTasks[SUPERVISOR_MAX_TASKS];
+static std::atomic<uint8_t> claimedTaskCount(0);  // Slots handed out, stops at SUPERVISOR_MAX_TASKS.
+
+// Handle of the supervisor thread, null until initSupervisor() is called.
+static TaskHandle_t supervisorThreadHandle = NULL;
+
+// Stack and control block of the supervisor thread.
+static StackType_t supervisorThreadStack[SUPERVISOR_THREAD_STACK_SIZE];
+static StaticTask_t supervisorThreadBuffer;
+
+/**
+* @brief Finds the first task that missed its deadline.
+*
+* @param overdue Destination for the time since the last check-in of the task.
+* @return The overdue task, or nullptr if every task checked in on time.
+*/
+static const SupervisedTask* findOverdueTask(uint32_t& overdue) {
+  uint8_t count = claimedTaskCount.load(std::memory_order_relaxed);
+
+  for (uint8_t i = 0; i < count; ++i) {
+    const SupervisedTask& task = supervisedTasks[i];
+
+    if (!task.isReady.load(std::memory_order_acquire) || !task.enabled.load(std::memory_order_relaxed)) {
+      continue;
+    }
+
+    // Read the time after the check-in, a check-in landing in between would otherwise
+    // lie in the future and make the task look overdue by almost 2^32 ms.
+    uint32_t lastCheckIn = task.lastCheckIn.load(std::memory_order_relaxed);
+    overdue = millis() - lastCheckIn;
+
+    if (overdue > task.deadline) {
+      return &task;
+    }
+  }
+
+  return nullptr;
+}
+
+/**
+* @brief Thread function for supervising the registered tasks.
+*
+* The thread attaches itself to the hardware task watchdog and feeds it only while no task
+* is overdue. Once a task is overdue, it is reported and the watchdog is left to expire.
+*
+* @param pvParameters Pointer to task parameters (not used in this function).
+*/
+static void SupervisorThread(void* pvParameters) {
+  // Setup hardware Watchdog timer for this thread only. Bark Bark.
+  initWatchdog(SUPERVISOR_WATCHDOG_TIMEOUT, true);
+
+  TickType_t lastWakeTime = xTaskGetTickCount();
+
+  for (;;) {
+    uint32_t overdue = 0;
+    const SupervisedTask* task = findOverdueTask(overdue);
+
+    if (task == nullptr) {
+      esp_task_wdt_reset();
+    } else {
+      // Name the offender once, then stop feeding so the watchdog resets the device.
+      resetLogSetOffender(task->name);
+      debug(ERR, "Task '%s' missed its %u ms deadline, last check-in %u ms ago. Device will reset.", task->name, (unsigned int)task->deadline, (unsigned int)overdue);
+      flushLogger();
+
+      for (;;) {
+        vTaskDelay(portMAX_DELAY);
+      }
+    }
+
+    vTaskDelayUntil(&lastWakeTime, pdMS_TO_TICKS(SUPERVISOR_CHECK_INTERVAL));
+  }
+}
+
+/**
+* @brief Starts the supervisor thread and attaches it to the hardware task watchdog.
+*
+* Tasks can register before or after this call. Until it is called, check-ins are recorded
+* but not enforced.
+*/
+void initSupervisor() {
+  if (supervisorThreadHandle != NULL) {
+    return;
+  }
+
+  // Tasks registered before the supervisor started get a full deadline from now.
+  uint8_t count = claimedTaskCount.load(std::memory_order_relaxed);
+
+  for (uint8_t i = 0; i < count; ++i) {
+    supervisedTasks[i].lastCheckIn.store(millis(), std::memory_order_relaxed);
+  }
+
+  supervisorThreadHandle = xTaskCreateStaticPinnedToCore(
+    SupervisorThread,              // Function to implement the task.
+    "SupervisorThread",            // Name of the task.
+    SUPERVISOR_THREAD_STACK_SIZE,  // Stack size in words.
+    NULL,                          // Task input parameter.
+    SUPERVISOR_THREAD_PRIORITY,    // Priority of the task.
+    supervisorThreadStack,         // Stack buffer.
+    &supervisorThreadBuffer,       // Task control block.
+    tskNO_AFFINITY                 // Run on whichever core is idle.
+  );
+
+  // Log the status in the terminal.
+  debug(LOG, "Watchdog supervisor started with %d tasks.", count);
+}
+
+/**
+* @brief Registers a task to be supervised.
+*
+* The deadline starts counting at registration, so the task does not need to check in
+* right away.
+*
+* @param name Name reported when the task misses its deadline. Must stay valid.
+* @param deadline Longest allowed time between check-ins in milliseconds.
+* @return ID to pass to supervisorCheckIn(), or SUPERVISOR_INVALID_ID if all slots are taken.
+*/
+int8_t supervisorRegister(const char* name, uint32_t deadline) {
+  // Claim a slot. The count never passes the number of slots, so failed calls cannot wrap it.
+  uint8_t id = claimedTaskCount.load(std::memory_order_relaxed);
+
+  do {
+    if (id >= SUPERVISOR_MAX_TASKS) {
+      debug(ERR, "Supervisor has no free slot for task '%s'.", name);
+      return SUPERVISOR_INVALID_ID;
+    }
+  } while (!claimedTaskCount.compare_exchange_weak(id, id + 1, std::memory_order_relaxed));
+
+  SupervisedTask& task = supervisedTasks[id];
+  task.name = name;
+  task.deadline = deadline;
+  task.lastCheckIn.store(millis(), std::memory_order_relaxed);
+  task.enabled.store(true, std::memory_order_relaxed);
+
+  // Never waits for other registrations, the supervisor skips slots that are not ready yet.
+  task.isReady.store(true, std::memory_order_release);
+
+  return id;
+}
+
+/**
+* @brief Reports that a supervised task is alive.
+*
+* This is a single atomic store and can be called from any task.
+*
+* @param id ID returned by supervisorRegister().
+*/
+void supervisorCheckIn(int8_t id) {
+  if (id >= 0 && id < SUPERVISOR_MAX_TASKS) {
+    supervisedTasks[id].lastCheckIn.store(millis(), std::memory_order_relaxed);
+  }
+}
+
+/**
+* @brief Pauses or resumes supervision of a task.
+*
+* A paused task is not checked. Resuming counts as a check-in.
+*
+* @param id ID returned by supervisorRegister().
+* @param enabled false to pause supervision, true to resume it.
+*/
+void supervisorSetEnabled(int8_t id, bool enabled) {
+  if (id < 0 || id >= SUPERVISOR_MAX_TASKS) {
+    return;
+  }
+
+  supervisedTasks[id].lastCheckIn.store(millis(), std::memory_order_relaxed);
+  supervisedTasks[id].enabled.store(enabled, std::memory_order_relaxed);
+}
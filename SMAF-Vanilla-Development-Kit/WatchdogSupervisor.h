@@ -0,0 +1,86 @@
+/**
+* @file WatchdogSupervisor.h
+* @brief Declaration of the multi-task watchdog supervisor for Arduino project.
+*
+* This file contains the declarations of the functions of a supervisor that watches every
+* registered task instead of only the loop task. Each task checks in regularly, and the
+* supervisor feeds the hardware task watchdog only while every task has checked in within
+* its own deadline. When a task misses its deadline, the supervisor names it in the log and
+* in the reset log, then stops feeding the watchdog so that the device resets.
+*
+* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#ifndef WATCHDOG_SUPERVISOR_H
+#define WATCHDOG_SUPERVISOR_H
+
+#include "Arduino.h"
+
+// Define supervisor parameters.
+#define SUPERVISOR_MAX_TASKS 8              // Maximum number of supervised tasks.
+#define SUPERVISOR_CHECK_INTERVAL 1000      // Interval between deadline checks in milliseconds.
+#define SUPERVISOR_WATCHDOG_TIMEOUT 5       // Hardware watchdog timeout in seconds, after feeding stops.
+#define SUPERVISOR_THREAD_STACK_SIZE 3072   // Stack size of the supervisor thread.
+#define SUPERVISOR_THREAD_PRIORITY 10       // Above all application tasks, so a busy task cannot starve it.
+
+// Returned by supervisorRegister() when no slot is free.
+#define SUPERVISOR_INVALID_ID -1
+
+/**
+* @brief Starts the supervisor thread and attaches it to the hardware task watchdog.
+*
+* Tasks can register before or after this call. Until it is called, check-ins are recorded
+* but not enforced.
+*/
+void initSupervisor();
+
+/**
+* @brief Registers a task to be supervised.
+*
+* The deadline starts counting at registration, so the task does not need to check in
+* right away.
+*
+* @param name Name reported when the task misses its deadline. Must stay valid.
+* @param deadline Longest allowed time between check-ins in milliseconds.
+* @return ID to pass to supervisorCheckIn(), or SUPERVISOR_INVALID_ID if all slots are taken.
+*/
+int8_t supervisorRegister(const char* name, uint32_t deadline);
+
+/**
+* @brief Reports that a supervised task is alive.
+*
+* This is a single atomic store and can be called from any task.
+*
+* @param id ID returned by supervisorRegister().
+*/
+void supervisorCheckIn(int8_t id);
+
+/**
+* @brief Pauses or resumes supervision of a task.
+*
+* A paused task is not checked. Resuming counts as a check-in.
+*
+* @param id ID returned by supervisorRegister().
+* @param enabled false to pause supervision, true to resume it.
+*/
+void supervisorSetEnabled(int8_t id, bool enabled);
+
+#endif
@@ -37,6 +37,217 @@
 #include "Preferences.h"
 #include "WiFiConfig.h"
 #include "Helpers.h"
+#include "Metrics.h"
+#include "ConfigPage.h"
+#include "esp_rom_crc.h"
+#include "lwip/sockets.h"
+
+// Configuration metrics.
+static MetricCounter configPageRequestCount("smaf_config_page_requests_total", "Requests served by the configuration page.");
+static MetricCounter configSaveCount("smaf_config_saves_total", "Configurations saved from the configuration page.");
+static MetricCounter configWriteFailureCount("smaf_config_write_failures_total", "Configuration blob writes that failed.");
+static MetricCounter configUnchangedCount("smaf_config_unchanged_saves_total", "Saves skipped because the configuration did not change.");
+static MetricCounter configMigrationCount("smaf_config_migrations_total", "Configurations upgraded from an older layout.");
+static MetricCounter configCorruptCount("smaf_config_corrupt_total", "Configuration blobs rejected by their header or CRC.");
+static MetricCounter configInvalidCount("smaf_config_invalid_total", "Preference loads that found an incomplete configuration.");
+static MetricCounter configPageCachedCount("smaf_config_page_not_modified_total", "Page requests answered from the browser cache by ETag.");
+static MetricHistogram configPageFirstByteTime("smaf_config_page_ttfb_us", "Time from a received request to the first response byte.");
+static MetricGauge configPageHeapUsed("smaf_config_page_heap_bytes", "Heap held by the last response right before its first byte.");
+static MetricGauge configConnectionGauge("smaf_config_connections", "Open configuration server connections.");
+static MetricCounter configConnectionTimeoutCount("smaf_config_connection_timeouts_total", "Configuration server connections closed by a timeout.");
+static MetricCounter configScanCount("smaf_config_scans_total", "Background Wi-Fi scans started by the configuration page.");
+static MetricCounter configScanFailureCount("smaf_config_scan_failures_total", "Background Wi-Fi scans that failed or timed out.");
+static MetricHistogram configScanDuration("smaf_config_scan_duration_ms", "Duration of completed background Wi-Fi scans.");
+static MetricCounter configConnectionEvictedCount("smaf_config_connections_evicted_total", "Idle keep-alive connections closed to make room for a new one.");
+
+// Blob read and written by the preferences code. Its data also holds the changed copy
+// of the configuration while a form submission is saved.
+static ConfigBlob configBlob;
+
+// Settings and scan results sent to the page.
+static ConfigJson configJson;
+
+/**
+* @brief Get the text value of a setting.
+*
+* @param data The configuration.
+* @param field Schema row of a text setting.
+* @return Pointer to the zero-padded text in the configuration.
+*/
+static const char* getFieldText(const ConfigData& data, const ConfigField& field) {
+  return reinterpret_cast<const char*>(&data) + field.offset;
+}
+
+/**
+* @brief Set the text value of a setting, truncated to the field size.
+*
+* @param data The configuration.
+* @param field Schema row of a text setting.
+* @param value The new value.
+*/
+static void setFieldText(ConfigData& data, const ConfigField& field, const char* value) {
+  // Zero the whole field, so equal configurations compare equal byte for byte.
+  char* text = reinterpret_cast<char*>(&data) + field.offset;
+  strncpy(text, value, PREFERENCES_VALUE_SIZE - 1);
+  text[PREFERENCES_VALUE_SIZE - 1] = '\0';
+}
+
+/**
+* @brief Get the value of a number or switch setting.
+*
+* @param data The configuration.
+* @param field Schema row of a number or switch setting.
+* @return The value, 0 or 1 for switches.
+*/
+static uint16_t getFieldValue(const ConfigData& data, const ConfigField& field) {
+  const uint8_t* value = reinterpret_cast<const uint8_t*>(&data) + field.offset;
+
+  if (field.type == CONFIG_SWITCH) {
+    return *reinterpret_cast<const bool*>(value) ? 1 : 0;
+  }
+
+  return *reinterpret_cast<const uint16_t*>(value);
+}
+
+/**
+* @brief Set the value of a number or switch setting.
+*
+* @param data The configuration.
+* @param field Schema row of a number or switch setting.
+* @param value The new value, any value other than 0 enables a switch.
+*/
+static void setFieldValue(ConfigData& data, const ConfigField& field, uint16_t value) {
+  uint8_t* target = reinterpret_cast<uint8_t*>(&data) + field.offset;
+
+  if (field.type == CONFIG_SWITCH) {
+    *reinterpret_cast<bool*>(target) = value != 0;
+  } else {
+    *reinterpret_cast<uint16_t*>(target) = value;
+  }
+}
+
+/**
+* @brief Check if a setting is text.
+*
+* @param field Schema row of the setting.
+* @return true for text and network settings.
+*/
+static bool isTextField(const ConfigField& field) {
+  return field.type == CONFIG_TEXT || field.type == CONFIG_NETWORK;
+}
+
+/**
+* @brief Check if a setting lies within the bounds of its schema row.
+*
+* @param data The configuration.
+* @param field Schema row of the setting.
+* @return true if the text length or the value is within the bounds.
+*/
+static bool isFieldValid(const ConfigData& data, const ConfigField& field) {
+  uint16_t value = isTextField(field) ? strlen(getFieldText(data, field)) : getFieldValue(data, field);
+  return value >= field.minimum && value <= field.maximum;
+}
+
+/**
+* @brief Append a text as a quoted and escaped JSON string.
+*
+* @param json The JSON being built.
+* @param text The text, UTF-8 is passed through unchanged.
+*/
+static void appendJsonText(ConfigJson& json, const char* text) {
+  json.append('"');
+
+  for (; *text != '\0'; ++text) {
+    if (*text == '"' || *text == '\\') {
+      json.append('\\');
+      json.append(*text);
+    } else if ((uint8_t)*text < 0x20) {
+      json.appendf("\\u%04x", (unsigned int)*text);
+    } else {
+      json.append(*text);
+    }
+  }
+
+  json.append('"');
+}
+
+/**
+* @brief Check if a request path matches, ignoring the query.
+*
+* @param path Start of the path in the request line.
+* @param name The path to match.
+* @return true if the path is the given one, with or without a query.
+*/
+static bool isPath(const char* path, const char* name) {
+  size_t length = strlen(name);
+  return strncmp(path, name, length) == 0 && (path[length] == ' ' || path[length] == '?' || path[length] == '\0');
+}
+
+/**
+* @brief Check the name of a request header line, ignoring case.
+*
+* @param line The header line.
+* @param name The header name including the colon.
+* @return true if the line is the named header.
+*/
+static bool isHeader(const char* line, const char* name) {
+  return strncasecmp(line, name, strlen(name)) == 0;
+}
+
+/**
+* @brief Check if a connection idles between keep-alive requests.
+*
+* @param connection The connection.
+* @return true if a request has been served and the next one has not started.
+*/
+static bool isConnectionIdle(const ConfigConnection& connection) {
+  return connection.state == CONFIG_CONNECTION_READING && connection.requestCount > 0 && connection.requestLength == 0 && !connection.isRequestLineDone
+         && connection.inputOffset >= connection.inputLength;
+}
+
+/**
+* @brief Get the JSON name of a Wi-Fi authentication mode.
+*
+* @param security A wifi_auth_mode_t value.
+* @return Short name shown on the configuration page.
+*/
+static const char* getSecurityName(uint8_t security) {
+  switch (security) {
+    case WIFI_AUTH_OPEN:
+      return "open";
+    case WIFI_AUTH_WEP:
+      return "WEP";
+    case WIFI_AUTH_WPA_PSK:
+      return "WPA";
+    case WIFI_AUTH_WPA2_PSK:
+      return "WPA2";
+    case WIFI_AUTH_WPA_WPA2_PSK:
+      return "WPA/WPA2";
+    case WIFI_AUTH_WPA2_ENTERPRISE:
+      return "WPA2-Enterprise";
+    case WIFI_AUTH_WPA3_PSK:
+      return "WPA3";
+    case WIFI_AUTH_WPA2_WPA3_PSK:
+      return "WPA2/WPA3";
+    default:
+      return "other";
+  }
+}
+
+/**
+* @brief Resets a configuration to the defaults of a device that was never configured.
+*
+* @param data The configuration to reset.
+*/
+static void setConfigDefaults(ConfigData& data) {
+  memset(&data, 0, sizeof(data));
+
+  for (size_t i = 0; i < CONFIG_FIELD_COUNT; ++i) {
+    if (!isTextField(configSchema[i])) {
+      setFieldValue(data, configSchema[i], configSchema[i].defaultValue);
+    }
+  }
+}
 
 /**
 * @brief Constructor for WiFiConfig class.
@@ -77,6 +288,9 @@ void WiFiConfig::startConfiguration() {
   // Begin the configuration server instance.
   _configServerInstance.begin();
 
+  // Fill the network cache before the first page load asks for it.
+  _isScanRequested = true;
+
   // Display SoftAP information.
   debug(CMD, "Starting configuration server.");
   debug(SCS, "SoftAP configuration server started. Use the credentials below to enter configuration mode.");
@@ -87,238 +301,38 @@ void WiFiConfig::startConfiguration() {
 }
 
 /**
-* @brief Render the configuration page for device setup.
+* @brief Serve the configuration page for device setup.
 * 
-* This function serves an HTML configuration page to the connected client.
-* It processes the form submission and saves the configuration settings.
+* This function never waits for a client. Every call accepts new connections, reads
+* what has arrived on each open connection and writes the next part of each response.
+* Up to CONFIG_MAX_CONNECTIONS are served at the same time, with keep-alive, and every
+* connection that stops making progress is closed after its timeout.
 * 
-* @note The HTML structure and styling are included for presentation purposes.
+* The page itself is static and served gzip-compressed from flash with an ETag, so a
+* browser that already holds it gets a bodyless 304. The page loads the settings and the
+* cached scan results from /config.json. A form submission is saved before the page is sent.
+* 
+* @note Call this method continuously. A restart that applies saved settings happens on a
+*       later call, once the browser had time to load the page confirming the save.
 */
 void WiFiConfig::renderConfigurationPage() {
-  // Check if a client has connected.
-  WiFiClient client = _configServerInstance.accept();
-
-  if (!client) {
-    return;  // No client, exit the loop.
-  }
+  // Restart when the delay after a save is over.
+  if (_isRestartPending && (int32_t)(millis() - _restartTime) >= 0) {
+    debug(CMD, "Restarting device to apply preferences.");
 
-  // Wait until the client sends some data.
-  while (!client.available()) {
-    delay(10);
-  }
+    // Print queued messages before they are lost on restart.
+    flushLogger();
 
-  // Read the first line of the request.
-  String request = client.readStringUntil('\r');
-  // client.flush();
-  // client.clear();
-
-  /**
-  * @note THIS WILL BE UPDATED IN FUTURE VERSION.
-  */
-  // Serve the HTML page.
-  String html = String();
-
-  html += "<!DOCTYPE html>";
-  html += "<html lang=\"en\">";
-  html += "<head>";
-  html += "<meta charset=\"UTF-8\"><meta name=\"viewport\" content=\"width=device-width, initial-scale=1.0, user-scalable=no\">";
-  html += "<title>SMAF-DK-SAP</title>";
-  html += "<script> function refreshScan() {window.location.href = '/refresh';} </script>";
-  html += "<style>";
-  html += ":root {";
-  html += "--monochrome-100: hsl(210, 10%, 10%); --monochrome-125: hsl(210, 10%, 50%); --monochrome-150: hsl(210, 10%, 70%); --monochrome-200: hsl(210, 10%, 85%); --monochrome-250: hsl(210, 10%, 95%); --monochrome-300: hsl(0, 0%, 100%);";
-  html += "--info-50: hsl(210, 100%, 20%); --info-75: hsl(210, 100%, 35%); --info-100: hsl(210, 100%, 50%); --info-200: hsl(210, 100%, 95%);";
-  html += "--success-50: hsl(130, 100%, 15%); --success-75: hsl(130, 100%, 25%); --success-100: hsl(130, 100%, 40%); --success-200: hsl(130, 100%, 95%);";
-  html += "--error-50: hsl(0, 100%, 24%); --error-75: hsl(0, 100%, 35%); --error-100: hsl(0, 100%, 60%); --error-200: hsl(0, 100%, 97%);";
-  html += "}";
-  html += "* {font-family: system-ui, sans-serif; font-size: 16px; line-height: 1.5; color: var(--monochrome-100); margin: 0; padding: 0; box-sizing: border-box; outline: none; list-style: none; word-wrap: break-words; cursor: default;}";
-  html += "body {display: flex;flex-direction: column;flex-wrap: nowrap;align-items: center;padding: 1.5rem 1.5rem 8rem;}";
-  html += "h1, h2, h3, h4, h5, h6 {color: inherit; line-height: 1.15; margin-top: 3.5rem; margin-bottom: 1rem; font-weight: 700; letter-spacing: -0.2px}";
-  html += "h1 {font-size: 2.027rem; font-weight: 700;}";
-  html += "h2 {font-size: 1.802rem;}";
-  html += "h3 {font-size: 1.602rem;}";
-  html += "h4 {font-size: 1.424rem;}";
-  html += "h5 {font-size: 1.266rem; margin-bottom: 0.5rem;}";
-  html += "h6 {font-size: 1.125rem; margin-bottom: 0.5rem;}";
-  html += "p {color: inherit; margin-top: 1rem; margin-bottom: 1rem;}";
-  html += "label {font-weight: 500;}";
-  html += "form {max-width: 460px;}";
-  html += "input[type='text'], input[type='submit'], input[type='reset'], select, input[type='checkbox'], button {all: unset;}";
-  html += "input[type='text'], select {font-family: monospace, sans-serif; padding: 0.75rem 1rem; box-shadow: 0 0 0 1px var(--monochrome-200) inset; cursor: text;}";
-  html += "input[type='text']:hover, select:hover {box-shadow: 0 0 0 2px var(--monochrome-200) inset;}";
-  html += "input[type='text']:focus, select:focus {box-shadow: 0 0 0 2px var(--info-100) inset;}";
-  html += "input[type='submit'], input[type='reset'], button {font-weight: 500; cursor: pointer; padding: 1rem 1.5rem; flex-grow: 2; text-align: center;}";
-  html += "input[type='submit'] {background: var(--info-100); color: var(--monochrome-300);}";
-  html += "input[type='reset'], button {box-shadow: 0 0 0 1px var(--monochrome-200) inset; flex-shrink: 2; flex-grow: 1;}";
-  html += "input[type='submit']:hover {background: var(--info-75);}";
-  html += "input[type='submit']:active {background: var(--info-50);}";
-  html += "input[type='reset']:hover, button:hover {box-shadow: 0 0 0 2px var(--monochrome-200) inset;}";
-  html += "input[type='reset']:active, button:active {box-shadow: 0 0 0 2px var(--monochrome-200) inset; background: var(--monochrome-250);}";
-  html += ".horizontal-frame {display: flex; flex-wrap: wrap; flex-direction: row; gap: 1.0rem; margin-top: 1.0rem;}";
-  html += "section {border-left: 3px solid var(--info-100); background: var(--info-200); color: var(--info-50); padding: 1rem 1.25rem; margin: 1.5rem 0rem;}";
-  html += "section.success {border-left: 3px solid var(--success-100); background: var(--success-200); color: var(--success-50);}";
-  html += "section p {margin: 0; padding: 0;}";
-  html += "section h6 {margin-top: 0;}";
-  html += ".frame {display: flex; flex-direction: column; gap: 1.5rem; margin-top: 1.5rem;}";
-  html += ".input-frame {display: flex; flex-direction: column; gap: 0.25rem;}";
-  html += ".checkbox-frame {display: flex; flex-direction: row; justify-content: space-between; align-content: center; align-items: center; gap: 0.5rem;}";
-  html += ".switch {position: relative; display: flex; flex-shrink: 0; width: 40px; height: 24px;}";
-  html += ".track {cursor: pointer; display: flex; justify-content: flex-start; align-items: center; background-color: var(--monochrome-200); box-shadow: 0 0 0 3px var(--monochrome-200); width: 100%; height: 100%; border-radius: 100px;}";
-  html += ".track:hover {background-color: var(--monochrome-150); box-shadow: 0 0 0 3px var(--monochrome-150);}";
-  html += ".track:active {background-color: var(--monochrome-125); box-shadow: 0 0 0 3px var(--monochrome-125);}";
-  html += ".thumb {display: flex; justify-content: center; align-items: center; width: 24px; height: 24px; pointer-events: none; border-radius: 100%; box-shadow: 0 0 0 9.5px var(--monochrome-300) inset;}";
-  html += "input:checked + .track {background-color: var(--info-100); box-shadow: 0 0 0 3px var(--info-100); justify-content: flex-end;}";
-  html += "input:checked + .track:hover {background-color: var(--info-75); box-shadow: 0 0 0 3px var(--info-75);}";
-  html += "input:checked + .track:active {background-color: var(--info-50); box-shadow: 0 0 0 3px var(--info-50);}";
-  html += ".h1-override {margin-top: 1.5rem; margin-bottom: 1.5rem;}";
-  html += ".fake-link {text-decoration: underline; color: var(--info-100); font-weight: 500; cursor: pointer;}";
-  html += "em {all: unset; color: var(--error-100); font-weight: 500;}";
-  html += "</style>";
-  html += "</head>";
-  html += "<body>";
-
-  html += "<form action='/configuration' method='get'>";
-  html += "<h1>🤙</h1>";
-  html += "<h1 class=\"h1-override\">Ready to update<br>your settings?</h1>";
-  html += "<p>Welcome to SMAF Config Hub! Quickly set up your SMAF device to connect via WiFi and transmit data using MQTT.</p>";
-
-  // Check if the request is a form submission and save preferences.
-  if (request.indexOf("/configuration") != -1) {
-    // Display a success message with the saved configuration.
-    html += "<section class='success' style=\"display: block;\">";
-    html += "<h6>Success!</h6>";
-    html += "<p>Your SMAF device has successfully absorbed the new configuration. It's now all set to rock and roll with the updated settings.</p>";
-    html += "</section>";
+    ESP.restart();
   }
 
-  html += "<h4>WiFi router<br>configuration</h4>";
-  html += "<p>Secure connectivity by entering your WiFi details - SSID and password. SMAF stays linked to the network for seamless operation.</p>";
-  html += "<p class=\"fake-link\" onclick=\"refreshScan()\">Refresh network list</p>";
-  html += "<div class=\"frame\">";
-  html += "<div class=\"input-frame\">";
-  html += "<label for='" + String(NETWORK_NAME) + "'>Select SSID<em>*</em></label>";
-  html += "<select id='" + String(NETWORK_NAME) + "' type='text' name='" + String(NETWORK_NAME) + "' required>";
-
-  html += scanNetworks();
-
-  html += "</select>";
-  html += "</div>";
-  html += "<div class=\"input-frame\">";
-  html += "<label for='" + String(NETWORK_PASS) + "'>SSID Password<em>*</em></label>";
-  html += "<input id='" + String(NETWORK_PASS) + "' type='text' name='" + String(NETWORK_PASS) + "' value='" + getNetworkPass() + "' required>";
-  html += "</div>";
-  html += "</div>";
-  html += "<h4>MQTT server<br>configuration</h4>";
-  html += "<p>Tune communication with MQTT server settings. Enter the broker's address, port, and authentication details for a robust connection.</p>";
-  html += "<div class=\"frame\">";
-  html += "<div class=\"input-frame\">";
-  html += "<label for='" + String(MQTT_SERVER_ADDRESS) + "'>MQTT Server<em>*</em></label>";
-  html += "<input id='" + String(MQTT_SERVER_ADDRESS) + "' type='text' name='" + String(MQTT_SERVER_ADDRESS) + "' value='" + getMqttServerAddress() + "' required>";
-  html += "</div>";
-  html += "<div class=\"input-frame\">";
-  html += "<label for='" + String(MQTT_SERVER_PORT) + "'>MQTT Port<em>*</em></label>";
-  html += "<input id='" + String(MQTT_SERVER_PORT) + "' type='text' inputmode='numeric' pattern='[0-9]*' name='" + String(MQTT_SERVER_PORT) + "' value='" + String(getMqttServerPort()) + "' required>";
-  html += "</div>";
-  html += "<div class=\"input-frame\">";
-  html += "<label for='" + String(MQTT_USERNAME) + "'>MQTT Username<em>*</em></label>";
-  html += "<input id='" + String(MQTT_USERNAME) + "' type='text' name='" + String(MQTT_USERNAME) + "' value='" + getMqttUsername() + "' required>";
-  html += "</div>";
-  html += "<div class=\"input-frame\">";
-  html += "<label for='" + String(MQTT_PASS) + "'>MQTT Password<em>*</em></label>";
-  html += "<input id='" + String(MQTT_PASS) + "' type='text' name='" + String(MQTT_PASS) + "' value='" + getMqttPass() + "' required>";
-  html += "</div>";
-  html += "</div>";
-  html += "<h4>MQTT client & topic<br>configuration</h4>";
-  html += "<p>Personalize MQTT settings for SMAF by defining client specifics and choosing an optimal topic. Seamless communication is just a click away.</p>";
-  html += "<div class=\"frame\">";
-  html += "<div class=\"input-frame\">";
-  html += "<label for='" + String(MQTT_CLIENT_ID) + "'>MQTT Client ID<em>*</em></label>";
-  html += "<input id='" + String(MQTT_CLIENT_ID) + "' type='text' name='" + String(MQTT_CLIENT_ID) + "' value='" + getMqttClientId() + "' required>";
-  html += "</div>";
-  html += "<div class=\"input-frame\">";
-  html += "<label for='" + String(MQTT_TOPIC) + "'>MQTT Topic<em>*</em></label>";
-  html += "<input id='" + String(MQTT_TOPIC) + "' type='text' name='" + String(MQTT_TOPIC) + "' value='" + getMqttTopic() + "' required>";
-  html += "</div>";
-  html += "</div>";
-  html += "<h4>Audio/Visual<br>notifications</h4>";
-  html += "<p>Your device is equipped with a buzzer and two RGB LEDs to show various statuses of connection. You can enable or disable those if you are irritated by the power of the LEDs or the sound of the buzzer.</p>";
-  html += "<div class=\"frame\">";
-  html += "<div class=\"checkbox-frame\">";
-  html += "<label for='" + String(AUDIO_NOTIFICATIONS) + "'>Enable audio notifications</label>";
-  html += "<label class=\"switch\">";
-  html += "<input id='" + String(AUDIO_NOTIFICATIONS) + "' type=\"checkbox\" name='" + String(AUDIO_NOTIFICATIONS) + "' value=\"true\"" + (getAudioNotificationsStatus() ? "Checked" : "") + ">";
-  html += "<div class=\"track\">";
-  html += "<div class=\"thumb\"></div>";
-  html += "</div>";
-  html += "</label>";
-  html += "</div>";
-  html += "<div class=\"checkbox-frame\">";
-  html += "<label for='" + String(VISUAL_NOTIFICATIONS) + "'>Enable visual notifications</label>";
-  html += "<label class=\"switch\">";
-  html += "<input id='" + String(VISUAL_NOTIFICATIONS) + "' type=\"checkbox\" name='" + String(VISUAL_NOTIFICATIONS) + "' value=\"true\"" + (getVisualNotificationsStatus() ? "Checked" : "") + ">";
-  html += "<div class=\"track\">";
-  html += "<div class=\"thumb\"></div>";
-  html += "</div>";
-  html += "</label>";
-  html += "</div>";
-  html += "</div>";
-  html += "<h4>Finish<br>configuration</h4>";
-  html += "<p>Ready to roll? Click \"Upload Configuration\" to apply changes, and SMAF will initiate its own reset to seamlessly implement the updated settings.</p>";
-  html += "<section class='info'>";
-  html += "<p>Note: Ensure all necessary data is entered correctly; SMAF won't connect or transmit data if something with the data is wrong.</p>";
-  html += "</section>";
-  html += "<div class=\"horizontal-frame\">";
-  html += "<input type=\"reset\" value=\"Reset form\">";
-  html += "<input type=\"submit\" value=\"Upload configuration\">";
-  html += "</div>";
-  html += "</form>";
-  html += "</body>";
-  html += "</html>";
-
-  // Send the response to the client.
-  client.println("HTTP/1.1 200 OK");
-  client.println("Content-Type: text/html");
-  client.println("Connection: close");
-  client.println();
-  client.println(html);
-
-
-  // Check if the request is a form submission and save preferences.
-  if (request.indexOf("/configuration") != -1) {
-    // Show debug message.
-    debug(CMD, "Saving preferences to '%s' namespace.", _preferencesNamespace);
-
-    // Save preferences.
-    saveString(NETWORK_NAME, parseFieldValue(request, NETWORK_NAME));
-    saveString(NETWORK_PASS, parseFieldValue(request, NETWORK_PASS));
-    saveString(MQTT_SERVER_ADDRESS, parseFieldValue(request, MQTT_SERVER_ADDRESS));
-    saveInt(MQTT_SERVER_PORT, stringToUint16(parseFieldValue(request, MQTT_SERVER_PORT)));
-    saveString(MQTT_USERNAME, parseFieldValue(request, MQTT_USERNAME));
-    saveString(MQTT_PASS, parseFieldValue(request, MQTT_PASS));
-    saveString(MQTT_CLIENT_ID, parseFieldValue(request, MQTT_CLIENT_ID));
-    saveString(MQTT_TOPIC, parseFieldValue(request, MQTT_TOPIC));
-
-    if (parseFieldValue(request, AUDIO_NOTIFICATIONS).isEmpty()) {
-      saveBool(AUDIO_NOTIFICATIONS, false);
-    } else {
-      saveBool(AUDIO_NOTIFICATIONS, true);
-    }
+  serviceScan();
+  acceptConnections();
 
-    if (parseFieldValue(request, VISUAL_NOTIFICATIONS).isEmpty()) {
-      saveBool(VISUAL_NOTIFICATIONS, false);
-    } else {
-      saveBool(VISUAL_NOTIFICATIONS, true);
+  for (uint8_t i = 0; i < CONFIG_MAX_CONNECTIONS; ++i) {
+    if (_connections[i].state != CONFIG_CONNECTION_FREE) {
+      serviceConnection(_connections[i]);
     }
-
-    // Show debug message.
-    debug(SCS, "Saving preferences to '%s' namespace done.", _preferencesNamespace);
-    debug(CMD, "Restarting device to apply preferences.");
-
-    // Short delay before restart.
-    delay(2400);
-
-    // Uncomment the following line if a device restart is desired after saving preferences.
-    ESP.restart();
   }
 }
 
@@ -326,71 +340,35 @@ void WiFiConfig::renderConfigurationPage() {
 * @brief Load Wi-Fi and MQTT configuration preferences.
 *
 * This method reads configuration parameters from non-volatile storage using the
-* Preferences library. It loads Wi-Fi network name, password, MQTT server address,
-* port, username, password, client ID, and topic. After loading, it checks if all
-* essential configuration parameters are non-empty and valid to determine the
-* overall configuration validity.
+* Preferences library. After loading, it checks every setting against the bounds of
+* its schema row to determine the overall configuration validity. Secret settings are
+* only logged as set or not set.
 */
 bool WiFiConfig::loadPreferences() {
   // Show debug message.
   debug(CMD, "Loading preferences from '%s' namespace.", _preferencesNamespace);
 
-  // Load all preferences to variables.
-  static const char* networkName = getNetworkName();
-  static const char* networkPass = getNetworkPass();
-  static const char* mqttServerAddress = getMqttServerAddress();
-  static const char* mqttUsername = getMqttUsername();
-  static const char* mqttPass = getMqttPass();
-  static const char* mqttClientId = getMqttClientId();
-  static const char* mqttTopic = getMqttTopic();
-  static uint16_t mqttServerPort = getMqttServerPort();
-  static bool audioNotifications = getAudioNotificationsStatus();
-  static bool visualNotifications = getVisualNotificationsStatus();
-
-  // Log preferences information to console.
-  debug(LOG, "Network Name: '%s'.", networkName);
-  debug(LOG, "Network Password: '%s'.", networkPass);
-  debug(LOG, "MQTT Server address: '%s'.", mqttServerAddress);
-  debug(LOG, "MQTT Server port: '%d'.", mqttServerPort);
-  debug(LOG, "MQTT Username: '%s'.", mqttUsername);
-  debug(LOG, "MQTT Password: '%s'.", mqttPass);
-  debug(LOG, "MQTT Client ID: '%s'.", mqttClientId);
-  debug(LOG, "MQTT Topic: '%s'.", mqttTopic);
-  debug(LOG, "Audio notifications %s.", audioNotifications ? "enabled" : "disabled");
-  debug(LOG, "Visual notifications %s.", visualNotifications ? "enabled" : "disabled");
-
+  // The configuration blob is read at most once.
+  const ConfigData& data = config();
   bool isDataValid = true;
 
-  if (isEmpty(networkName) || networkName == "Unknown") {
-    isDataValid = false;
-  }
-
-  if (isEmpty(networkPass) || networkPass == "Unknown") {
-    isDataValid = false;
-  }
+  // Log every setting and check it against the bounds of its schema row.
+  for (size_t i = 0; i < CONFIG_FIELD_COUNT; ++i) {
+    const ConfigField& field = configSchema[i];
+    bool isValid = isFieldValid(data, field);
 
-  if (isEmpty(mqttServerAddress) || mqttServerAddress == "Unknown") {
-    isDataValid = false;
-  }
-
-  if (isEmpty(mqttUsername) || mqttUsername == "Unknown") {
-    isDataValid = false;
-  }
-
-  if (isEmpty(mqttPass) || mqttPass == "Unknown") {
-    isDataValid = false;
-  }
-
-  if (isEmpty(mqttClientId) || mqttClientId == "Unknown") {
-    isDataValid = false;
-  }
-
-  if (isEmpty(mqttTopic) || mqttTopic == "Unknown") {
-    isDataValid = false;
-  }
+    if (field.isSecret) {
+      debug(LOG, "%s: %s.", field.label, isEmpty(getFieldText(data, field)) ? "not set" : "set");
+    } else if (isTextField(field)) {
+      debug(LOG, "%s: '%s'.", field.label, getFieldText(data, field));
+    } else {
+      debug(LOG, "%s: '%u'.", field.label, (unsigned int)getFieldValue(data, field));
+    }
 
-  if (mqttServerPort == 0) {
-    isDataValid = false;
+    if (!isValid) {
+      debug(ERR, "%s is out of bounds, expected %u to %u%s.", field.label, (unsigned int)field.minimum, (unsigned int)field.maximum, isTextField(field) ? " characters" : "");
+      isDataValid = false;
+    }
   }
 
   // Show debug message.
@@ -398,6 +376,7 @@ bool WiFiConfig::loadPreferences() {
     debug(SCS, "Preferences data is valid.");
   } else {
     debug(ERR, "Preferences data is not valid. Default values are not sufficient for a successful network connection.");
+    configInvalidCount.increment();
   }
 
   return isDataValid;
@@ -430,98 +409,91 @@ void WiFiConfig::clearPreferences() {
 * @brief Get the configured Wi-Fi network name.
 * 
 * @return const char* representing the Wi-Fi network name.
-*         If empty, returns "NULL".
+*         An empty string if it is not configured.
 * 
-* @note The returned pointer is valid until the class instance is destroyed,
-*       or until the next call to a function that modifies the Wi-Fi network name.
+* @note The returned pointer points into the loaded configuration and stays valid while
+*       the instance exists. The text changes when a new configuration is saved.
 */
 const char* WiFiConfig::getNetworkName() {
-  static String data = loadString(NETWORK_NAME);
-  return data.c_str();
+  return config().networkName;
 }
 
 /**
 * @brief Get the configured Wi-Fi network password.
 * 
 * @return const char* representing the Wi-Fi network password.
-*         If empty, returns "NULL".
+*         An empty string if it is not configured.
 * 
-* @note The returned pointer is valid until the class instance is destroyed,
-*       or until the next call to a function that modifies the Wi-Fi network password.
+* @note The returned pointer points into the loaded configuration and stays valid while
+*       the instance exists. The text changes when a new configuration is saved.
 */
 const char* WiFiConfig::getNetworkPass() {
-  static String data = loadString(NETWORK_PASS);
-  return data.c_str();
+  return config().networkPass;
 }
 
 /**
 * @brief Get the configured MQTT server address.
 * 
 * @return const char* representing the MQTT server address.
-*         If empty, returns "NULL".
+*         An empty string if it is not configured.
 * 
-* @note The returned pointer is valid until the class instance is destroyed,
-*       or until the next call to a function that modifies the MQTT server address.
+* @note The returned pointer points into the loaded configuration and stays valid while
+*       the instance exists. The text changes when a new configuration is saved.
 */
 const char* WiFiConfig::getMqttServerAddress() {
-  static String data = loadString(MQTT_SERVER_ADDRESS);
-  return data.c_str();
+  return config().mqttServerAddress;
 }
 
 /**
 * @brief Get the configured MQTT username.
 * 
 * @return const char* representing the MQTT username.
-*         If empty, returns "NULL".
+*         An empty string if it is not configured.
 * 
-* @note The returned pointer is valid until the class instance is destroyed,
-*       or until the next call to a function that modifies the MQTT username.
+* @note The returned pointer points into the loaded configuration and stays valid while
+*       the instance exists. The text changes when a new configuration is saved.
 */
 const char* WiFiConfig::getMqttUsername() {
-  static String data = loadString(MQTT_USERNAME);
-  return data.c_str();
+  return config().mqttUsername;
 }
 
 /**
 * @brief Get the configured MQTT password.
 * 
 * @return const char* representing the MQTT password.
-*         If empty, returns "NULL".
+*         An empty string if it is not configured.
 * 
-* @note The returned pointer is valid until the class instance is destroyed,
-*       or until the next call to a function that modifies the MQTT password.
+* @note The returned pointer points into the loaded configuration and stays valid while
+*       the instance exists. The text changes when a new configuration is saved.
 */
 const char* WiFiConfig::getMqttPass() {
-  static String data = loadString(MQTT_PASS);
-  return data.c_str();
+  return config().mqttPass;
 }
 
 /**
 * @brief Get the configured MQTT client ID.
 * 
 * @return const char* representing the MQTT client ID.
-*         If empty, returns "NULL".
+*         An empty string if it is not configured.
 * 
-* @note The returned pointer is valid until the class instance is destroyed,
-*       or until the next call to a function that modifies the MQTT client ID.
+* @note The returned pointer points into the loaded configuration and stays valid while
+*       the instance exists. The text changes when a new configuration is saved.
 */
 const char* WiFiConfig::getMqttClientId() {
-  static String data = loadString(MQTT_CLIENT_ID);
-  return data.c_str();
+  return config().mqttClientId;
 }
 
 /**
 * @brief Get the configured MQTT topic.
 * 
 * @return const char* representing the MQTT topic.
-*         If empty, returns "NULL".
+*         An empty string if it is not configured.
 * 
-* @note The returned pointer is valid until the class instance is destroyed,
-*       or until the next call to a function that modifies the MQTT topic.
+* @note The returned pointer points into the loaded configuration and stays valid while
+*       the instance exists. The text changes when a new configuration is saved.
 */
 const char* WiFiConfig::getMqttTopic() {
-  static String data = loadString(MQTT_TOPIC);
-  return data.c_str();
+  return config().mqttTopic;
 }
 
 /**
@@ -530,11 +502,10 @@ const char* WiFiConfig::getMqttTopic() {
 * @return bool representing the status of audio notifications.
 *         Returns true if audio notifications are enabled, false otherwise.
 * 
-* @note The returned value is cached after the first call and remains the same for subsequent calls.
+* @note The configuration is loaded on the first call, the value changes when a new one is saved.
 */
 bool WiFiConfig::getAudioNotificationsStatus() {
-  static bool data = loadBool(AUDIO_NOTIFICATIONS);
-  return data;
+  return config().audioNotifications;
 }
 
 /**
@@ -543,24 +514,22 @@ bool WiFiConfig::getAudioNotificationsStatus() {
 * @return bool representing the status of visual notifications.
 *         Returns true if visual notifications are enabled, false otherwise.
 * 
-* @note The returned value is cached after the first call and remains the same for subsequent calls.
+* @note The configuration is loaded on the first call, the value changes when a new one is saved.
 */
 bool WiFiConfig::getVisualNotificationsStatus() {
-  static bool data = loadBool(VISUAL_NOTIFICATIONS);
-  return data;
+  return config().visualNotifications;
 }
 
 /**
 * @brief Get the configured MQTT server port.
 * 
 * @return uint16_t representing the MQTT server port.
-*         If not configured, returns a default value.
+*         0 if it is not configured.
 * 
-* @note The returned value is cached after the first call and remains the same for subsequent calls.
+* @note The configuration is loaded on the first call, the value changes when a new one is saved.
 */
 uint16_t WiFiConfig::getMqttServerPort() {
-  static uint16_t data = loadInt(MQTT_SERVER_PORT);
-  return data;
+  return config().mqttServerPort;
 }
 
 /**
@@ -648,233 +617,784 @@ uint16_t WiFiConfig::getConfigServerPort() {
 }
 
 /**
-* @brief Scan for available Wi-Fi networks and return them in HTML option format.
-* 
-* @return String containing the HTML option elements for each available network.
-*         If no networks are found, an empty string is returned.
-* 
-* @note The function scans for Wi-Fi networks, formats them as HTML option elements,
-*       and returns the resulting string. It also frees memory used for the scan results
-*       after processing.
+* @brief Accept waiting connections while a slot is free.
+*
+* If every slot is taken, a connection idling between keep-alive requests is closed to
+* make room. Otherwise new connections wait in the listen backlog.
 */
-String WiFiConfig::scanNetworks() {
-  int networksFound = WiFi.scanNetworks();
-  String networks = String();
-
-  if (networksFound != 0) {
-    for (int i = 0; i < networksFound; ++i) {
-      String network = String(WiFi.SSID(i).c_str());
-      networks += "<option value=\"" + network + "\">" + network + "</option>";
+void WiFiConfig::acceptConnections() {
+  while (_configServerInstance.hasClient()) {
+    ConfigConnection* slot = nullptr;
+
+    for (uint8_t i = 0; i < CONFIG_MAX_CONNECTIONS && slot == nullptr; ++i) {
+      if (_connections[i].state == CONFIG_CONNECTION_FREE) {
+        slot = &_connections[i];
+      }
+    }
+
+    // Browsers keep connections open they may never use again, a new one is more urgent.
+    for (uint8_t i = 0; i < CONFIG_MAX_CONNECTIONS && slot == nullptr; ++i) {
+      if (isConnectionIdle(_connections[i])) {
+        closeConnection(_connections[i]);
+        configConnectionEvictedCount.increment();
+        slot = &_connections[i];
+      }
+    }
+
+    if (slot == nullptr) {
+      return;
+    }
+
+    slot->client = _configServerInstance.accept();
+
+    if (!slot->client) {
+      return;
     }
 
-    // delay(10);
+    slot->requestCount = 0;
+    slot->inputLength = 0;
+    slot->inputOffset = 0;
+    resetConnection(*slot, CONFIG_REQUEST_TIMEOUT);
+    configConnectionGauge.add(1);
   }
+}
 
-  // Delete the scan result to free memory for code below.
-  WiFi.scanDelete();
+/**
+* @brief Advance the state machine of a connection.
+*
+* @param connection The connection.
+*/
+void WiFiConfig::serviceConnection(ConfigConnection& connection) {
+  if (connection.state == CONFIG_CONNECTION_READING) {
+    if (readRequest(connection)) {
+      connection.requestTime = micros();
+      connection.freeHeap = ESP.getFreeHeap();
+      connection.requestCount++;
+      configPageRequestCount.increment();
+
+      if (connection.requestCount >= CONFIG_KEEP_ALIVE_REQUESTS) {
+        connection.isKeepAlive = false;
+      }
+
+      prepareResponse(connection);
+    } else if (!connection.client.connected() && connection.client.available() == 0) {
+      closeConnection(connection);
+      return;
+    } else if ((int32_t)(millis() - connection.deadline) >= 0) {
+      // An idle keep-alive connection simply ends, a started or missing request is a timeout.
+      if (!isConnectionIdle(connection)) {
+        debug(ERR, "Configuration client timed out before completing its request.");
+        configConnectionTimeoutCount.increment();
+      }
+
+      closeConnection(connection);
+      return;
+    }
+  } else if (connection.state == CONFIG_CONNECTION_WAITING) {
+    prepareResponse(connection);
+  }
 
-  return networks;
+  if (connection.state != CONFIG_CONNECTION_SENDING) {
+    return;
+  }
+
+  if (sendResponse(connection)) {
+    if (_jsonOwner == &connection) {
+      _jsonOwner = nullptr;
+    }
+
+    if (connection.isKeepAlive) {
+      resetConnection(connection, CONFIG_KEEP_ALIVE_TIMEOUT);
+    } else {
+      connection.client.flush();
+      closeConnection(connection);
+    }
+  } else if (!connection.client.connected()) {
+    closeConnection(connection);
+  } else if ((int32_t)(millis() - connection.deadline) >= 0) {
+    debug(ERR, "Configuration client stopped receiving its response.");
+    configConnectionTimeoutCount.increment();
+    closeConnection(connection);
+  }
 }
 
 /**
-* @brief Load a string value from the preferences storage.
-* 
-* @param key The key associated with the string value to be loaded.
-* 
-* @return String containing the value associated with the specified key.
-*         If the key does not exist, "Unknown" is stored and returned.
-*         If the loading fails, a default value is returned.
-* 
-* @note The function initializes a Preferences instance with the specified namespace,
-*       checks if the key exists, stores a default value if it does not, loads the value,
-*       and ends the preferences session. If loading fails, an error message is logged
-*       and a default value is returned.
+* @brief Read the request bytes that have arrived on a connection.
+*
+* Only the request line and the few headers of interest are kept. A request line that
+* does not fit is marked as overlong and answered with an error. Bytes after the end of
+* the request stay in the input buffer for the next one.
+*
+* @param connection The connection.
+* @return true once the blank line ending the headers has been received.
 */
-String WiFiConfig::loadString(const char* key) {
-  // Create a Preferences instance with the specified namespace.
-  Preferences preferences;
-  static String data;
+bool WiFiConfig::readRequest(ConfigConnection& connection) {
+  while (true) {
+    if (connection.inputOffset >= connection.inputLength) {
+      if (connection.client.available() <= 0) {
+        return false;
+      }
 
-  if (preferences.begin(_preferencesNamespace, READ_WRITE_MODE)) {
-    // Check if key exists and store default value if FALSE.
-    if (!preferences.isKey(key)) {
-      preferences.putString(key, "Unknown");
+      int length = connection.client.read(connection.input, sizeof(connection.input));
+
+      if (length <= 0) {
+        return false;
+      }
+
+      connection.inputLength = length;
+      connection.inputOffset = 0;
     }
 
-    // Load value from key.
-    data = preferences.getString(key);
+    // The request timeout starts with the first byte, not with the keep-alive idle time.
+    if (connection.requestCount > 0 && connection.requestLength == 0 && !connection.isRequestLineDone) {
+      connection.deadline = millis() + CONFIG_REQUEST_TIMEOUT;
+    }
 
-    // End preferences session.
-    preferences.end();
+    while (connection.inputOffset < connection.inputLength) {
+      char c = (char)connection.input[connection.inputOffset++];
+
+      if (c == '\r') {
+        continue;
+      }
+
+      if (c != '\n') {
+        if (!connection.isRequestLineDone) {
+          if (connection.requestLength < sizeof(connection.request) - 1) {
+            connection.request[connection.requestLength++] = c;
+            connection.request[connection.requestLength] = '\0';
+          } else {
+            connection.isOverlong = true;
+          }
+        } else if (connection.lineLength < sizeof(connection.line) - 1) {
+          connection.line[connection.lineLength++] = c;
+          connection.line[connection.lineLength] = '\0';
+        }
+
+        continue;
+      }
+
+      if (!connection.isRequestLineDone) {
+        // Blank lines in front of a request are allowed.
+        if (connection.requestLength > 0) {
+          connection.isRequestLineDone = true;
+          connection.isKeepAlive = strstr(connection.request, " HTTP/1.1") != nullptr;
+        }
+
+        continue;
+      }
+
+      // A blank line ends the headers. Requests carry no body, the next byte starts a new request.
+      if (connection.lineLength == 0) {
+        return true;
+      }
+
+      if (isHeader(connection.line, "If-None-Match:")) {
+        connection.isPageCached = strstr(connection.line, CONFIG_PAGE_ETAG) != nullptr;
+      } else if (isHeader(connection.line, "Connection:")) {
+        const char* value = connection.line + strlen("Connection:");
+        value += strspn(value, " ");
+        connection.isKeepAlive = strncasecmp(value, "close", 5) != 0 && (connection.isKeepAlive || strncasecmp(value, "keep-alive", 10) == 0);
+      }
+
+      connection.lineLength = 0;
+      connection.line[0] = '\0';
+    }
+  }
+}
+
+/**
+* @brief Handle a received request and set up its response.
+*
+* The settings JSON is built into a single static buffer. While another response is
+* still sending it, the connection waits and this method is called again.
+*
+* @param connection The connection holding the request.
+*/
+void WiFiConfig::prepareResponse(ConfigConnection& connection) {
+  static const uint8_t noBody[1] = { 0 };
+
+  if (connection.isOverlong) {
+    connection.isKeepAlive = false;
+    setResponse(connection, "414 URI Too Long", "", noBody, 0);
+    return;
+  }
+
+  if (strncmp(connection.request, "GET ", 4) != 0) {
+    // A body of another method would be read as the next request, so close afterwards.
+    connection.isKeepAlive = false;
+    setResponse(connection, "405 Method Not Allowed", "Allow: GET\r\n", noBody, 0);
+    return;
+  }
+
+  const char* path = connection.request + 4;
+
+  bool isSettings = isPath(path, "/config.json");
+  bool isScan = isPath(path, "/scan");
+
+  if (isSettings || isScan || isPath(path, "/networks.json")) {
+    if (_jsonOwner != nullptr && _jsonOwner != &connection) {
+      connection.state = CONFIG_CONNECTION_WAITING;
+      return;
+    }
+
+    _jsonOwner = &connection;
+
+    // A refresh only starts a scan, the response lists the cache as it is and tells the
+    // page to ask again until the scan is complete.
+    if (isScan) {
+      _isScanRequested = true;
+      serviceScan();
+    }
+
+    if (isSettings) {
+      buildConfigJson(configJson);
+    } else {
+      configJson.clear();
+      configJson.append('{');
+      appendNetworks(configJson);
+      configJson.append('}');
+    }
+
+    if (configJson.isTruncated()) {
+      debug(ERR, "Configuration JSON does not fit into %u bytes.", (unsigned int)CONFIG_JSON_SIZE);
+      setResponse(connection, "500 Internal Server Error", "", noBody, 0);
+      return;
+    }
+
+    setResponse(connection, "200 OK", "Content-Type: application/json\r\nCache-Control: no-store\r\n", (const uint8_t*)configJson.c_str(), configJson.length());
+    return;
+  }
+
+  if (isPath(path, "/favicon.ico")) {
+    setResponse(connection, "404 Not Found", "", noBody, 0);
+    return;
+  }
+
+  // Save a form submission first, so the page shows the settings that are now in effect.
+  // The portal only runs in maintenance mode, so every submission restarts the device,
+  // which is the only way out of the portal.
+  if (isPath(path, "/configuration")) {
+    saveConfigurationForm(connection.request);
+    _isRestartPending = true;
+    _restartTime = millis() + CONFIG_RESTART_DELAY;
+  }
+
+  // Every other path gets the page, which also answers captive portal checks.
+  if (connection.isPageCached) {
+    configPageCachedCount.increment();
+    setResponse(connection, "304 Not Modified", "ETag: " CONFIG_PAGE_ETAG "\r\nCache-Control: no-cache\r\n", noBody, 0);
+    return;
+  }
+
+  // The browser revalidates on every load, a form submission always reaches the device.
+  setResponse(connection, "200 OK", "Content-Type: text/html; charset=utf-8\r\nContent-Encoding: gzip\r\nETag: " CONFIG_PAGE_ETAG "\r\nCache-Control: no-cache\r\n", configPageGzip, sizeof(configPageGzip));
+}
+
+/**
+* @brief Set up the response of a connection and start sending it.
+*
+* @param connection The connection.
+* @param status Status code and reason, e.g. "200 OK".
+* @param headers Additional header lines, each ending with CRLF.
+* @param body The body, must stay valid until the response is sent.
+* @param bodyLength Size of the body.
+*/
+void WiFiConfig::setResponse(ConfigConnection& connection, const char* status, const char* headers, const uint8_t* body, size_t bodyLength) {
+  connection.header.clear();
+  connection.header.appendf("HTTP/1.1 %s\r\n%s", status, headers);
+
+  // A 304 describes the cached page, its length would be the one of the page.
+  if (strncmp(status, "304", 3) != 0) {
+    connection.header.appendf("Content-Length: %u\r\n", (unsigned int)bodyLength);
+  }
+
+  if (connection.isKeepAlive) {
+    connection.header.appendf("Connection: keep-alive\r\nKeep-Alive: timeout=%u, max=%u\r\n\r\n",
+                              (unsigned int)(CONFIG_KEEP_ALIVE_TIMEOUT / 1000), (unsigned int)(CONFIG_KEEP_ALIVE_REQUESTS - connection.requestCount));
   } else {
-    // Return a default value if loading fails
-    debug(ERR, "Loading '%s' key from '%s' namespace failed. Will use default value.", key, _preferencesNamespace);
+    connection.header.append("Connection: close\r\n\r\n");
   }
 
-  return data.c_str();
+  connection.body = body;
+  connection.bodyLength = bodyLength;
+  connection.sent = 0;
+  connection.state = CONFIG_CONNECTION_SENDING;
+  connection.deadline = millis() + CONFIG_SEND_TIMEOUT;
+
+  // The response is complete, everything from here on is sending.
+  configPageFirstByteTime.observe(micros() - connection.requestTime);
+  configPageHeapUsed.set((int32_t)connection.freeHeap - (int32_t)ESP.getFreeHeap());
 }
 
 /**
-* @brief Save a string value to the specified key in the preferences namespace.
-* 
-* @param key The key to which the string value will be saved.
-* @param value The string value to save.
-* 
-* @note This function creates a Preferences instance, attempts to save the value associated 
-*       with the given key, and ensures the Preferences session is properly ended. If saving 
-*       fails, an error message is logged.
+* @brief Write the next part of the response of a connection.
+*
+* At most one chunk is written per call, and only as much as fits into the send buffer of
+* the socket. WiFiClient::write() waits for a full buffer to drain, so a client that stops
+* reading would hold up every other connection.
+*
+* @param connection The connection.
+* @return true once the whole response has been written.
 */
-void WiFiConfig::saveString(const char* key, String value) {
-  // Create a Preferences instance with the specified namespace.
-  Preferences preferences;
+bool WiFiConfig::sendResponse(ConfigConnection& connection) {
+  size_t headerLength = connection.header.length();
+  size_t total = headerLength + connection.bodyLength;
 
-  if (preferences.begin(_preferencesNamespace, READ_WRITE_MODE)) {
-    // Save the value to the specified key.
-    preferences.putString(key, value);
+  if (connection.sent < total) {
+    const uint8_t* data;
+    size_t length;
 
-    // End preferences session.
-    preferences.end();
+    if (connection.sent < headerLength) {
+      data = (const uint8_t*)connection.header.c_str() + connection.sent;
+      length = headerLength - connection.sent;
+    } else {
+      data = connection.body + (connection.sent - headerLength);
+      length = total - connection.sent;
+    }
 
-    // Show success message.
-    debug(SCS, "Data saved to '%s' key in '%s' namespace.", key, _preferencesNamespace);
-  } else {
-    // Log an error message if saving fails.
-    debug(ERR, "Saving data to '%s' key in '%s' namespace failed.", key, _preferencesNamespace);
+    ssize_t written = send(connection.client.fd(), data, min(length, (size_t)CONFIG_SEND_CHUNK_SIZE), MSG_DONTWAIT);
+
+    if (written > 0) {
+      connection.sent += written;
+      connection.deadline = millis() + CONFIG_SEND_TIMEOUT;
+    } else if (written < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+      // The connection is gone, the caller closes it.
+      connection.client.stop();
+    }
   }
+
+  return connection.sent >= total;
 }
 
 /**
-* @brief Load an integer value from the specified key in the preferences namespace.
-* 
-* @param key The key for the integer value to load.
-* 
-* @return uint16_t containing the value associated with the key.
-*         If the key does not exist, initializes it with a default value of 0 and returns 0.
-*         If loading fails, returns 0.
-* 
-* @note This function creates a Preferences instance, attempts to load the value associated 
-*       with the given key, and ensures the Preferences session is properly ended. If the key 
-*       does not exist, it initializes the key with a default value of 0.
+* @brief Prepare a connection for its next request.
+*
+* @param connection The connection.
+* @param timeout Time until the next request must be complete, in milliseconds.
 */
-uint16_t WiFiConfig::loadInt(const char* key) {
-  // Create a Preferences instance with the specified namespace.
-  Preferences preferences;
-  static int data;
+void WiFiConfig::resetConnection(ConfigConnection& connection, uint32_t timeout) {
+  connection.state = CONFIG_CONNECTION_READING;
+  connection.requestLength = 0;
+  connection.request[0] = '\0';
+  connection.lineLength = 0;
+  connection.line[0] = '\0';
+  connection.isRequestLineDone = false;
+  connection.isOverlong = false;
+  connection.isPageCached = false;
+  connection.isKeepAlive = false;
+  connection.deadline = millis() + timeout;
+}
 
-  if (preferences.begin(_preferencesNamespace, READ_WRITE_MODE)) {
-    // Check if key exists and store default value if FALSE.
-    if (preferences.isKey(key) == false) {
-      preferences.putInt(key, 0);
+/**
+* @brief Close a connection and free its slot.
+*
+* @param connection The connection.
+*/
+void WiFiConfig::closeConnection(ConfigConnection& connection) {
+  if (_jsonOwner == &connection) {
+    _jsonOwner = nullptr;
+  }
+
+  connection.client.stop();
+  connection.state = CONFIG_CONNECTION_FREE;
+  configConnectionGauge.add(-1);
+}
+
+/**
+* @brief Build the settings and scan results the configuration page is filled with.
+*
+* Every setting is listed with its schema row, so the page needs no knowledge of the
+* settings. Secrets are never sent, only whether one is stored.
+*
+* @param json Destination, check isTruncated() before sending it.
+*/
+void WiFiConfig::buildConfigJson(ConfigJson& json) {
+  static const char* const typeNames[] = { "text", "network", "number", "switch" };
+  const ConfigData& data = config();
+
+  json.clear();
+  json.append("{\"fields\":[");
+
+  for (size_t i = 0; i < CONFIG_FIELD_COUNT; ++i) {
+    const ConfigField& field = configSchema[i];
+
+    json.append(i == 0 ? "{\"key\":" : ",{\"key\":");
+    appendJsonText(json, field.key);
+    json.append(",\"label\":");
+    appendJsonText(json, field.label);
+    json.appendf(",\"type\":\"%s\",\"section\":%u,\"min\":%u,\"max\":%u", typeNames[field.type], (unsigned int)field.section, (unsigned int)field.minimum, (unsigned int)field.maximum);
+
+    if (field.isSecret) {
+      json.appendf(",\"secret\":true,\"set\":%s}", isEmpty(getFieldText(data, field)) ? "false" : "true");
+    } else if (isTextField(field)) {
+      json.append(",\"value\":");
+      appendJsonText(json, getFieldText(data, field));
+      json.append('}');
+    } else {
+      json.appendf(",\"value\":%u}", (unsigned int)getFieldValue(data, field));
     }
+  }
 
-    // Load value from key.
-    data = preferences.getInt(key);
+  json.append("],");
+  appendNetworks(json);
+  json.append('}');
+}
 
-    // End preferences session.
-    preferences.end();
-  } else {
-    // Log an error message and return a default value if loading fails.
-    debug(ERR, "Loading '%s' key from '%s' namespace failed. Will use default value.", key, _preferencesNamespace);
-    data = 0;
+/**
+* @brief Save the settings of a submitted configuration form.
+*
+* Every setting of the schema is parsed from the request into a copy of the active
+* configuration, which is then saved.
+*
+* @param request First line of the form submission request.
+*/
+void WiFiConfig::saveConfigurationForm(const String& request) {
+  debug(CMD, "Saving preferences to '%s' namespace.", _preferencesNamespace);
+
+  // Edit a copy in the shared blob, the active configuration stays untouched until the
+  // copy is stored. Loading the active one also uses the blob, so it is loaded first.
+  const ConfigData& activeConfig = config();
+  ConfigData& pendingConfig = configBlob.data;
+  pendingConfig = activeConfig;
+
+  for (size_t i = 0; i < CONFIG_FIELD_COUNT; ++i) {
+    const ConfigField& field = configSchema[i];
+    String value = parseFieldValue(request, field.key);
+
+    if (field.isSecret && value.isEmpty()) {
+      // The page never receives secrets, an empty input keeps the stored one.
+      continue;
+    } else if (field.type == CONFIG_SWITCH) {
+      // Browsers leave unchecked boxes out of the form.
+      setFieldValue(pendingConfig, field, !value.isEmpty());
+    } else if (field.type == CONFIG_NUMBER) {
+      setFieldValue(pendingConfig, field, stringToUint16(value));
+    } else {
+      setFieldText(pendingConfig, field, value.c_str());
+    }
   }
 
-  return data;
+  if (!saveConfig(pendingConfig)) {
+    return;
+  }
+
+  debug(SCS, "Saving preferences to '%s' namespace done.", _preferencesNamespace);
+  configSaveCount.increment();
 }
 
 /**
-* @brief Save an integer value to the specified key in the preferences namespace.
+* @brief Append the cached networks and the scan state as JSON object members.
 * 
-* @param key The key to which the integer value will be saved.
-* @param value The integer value to save.
+* Never scans, the cache is kept up to date by serviceScan().
 * 
-* @note This function creates a Preferences instance, attempts to save the value associated 
-*       with the given key, and ensures the Preferences session is properly ended. If saving 
-*       fails, an error message is logged.
+* @param json The JSON being built, inside an object.
 */
-void WiFiConfig::saveInt(const char* key, uint16_t value) {
-  // Create a Preferences instance with the specified namespace.
-  Preferences preferences;
+void WiFiConfig::appendNetworks(ConfigJson& json) {
+  json.append("\"networks\":[");
 
-  if (preferences.begin(_preferencesNamespace, READ_WRITE_MODE)) {
-    // Save the value to the specified key.
-    preferences.putInt(key, value);
+  for (uint8_t i = 0; i < _networkCount; ++i) {
+    const ConfigNetwork& network = _networks[i];
 
-    // End preferences session.
-    preferences.end();
+    json.append(i == 0 ? "{\"ssid\":" : ",{\"ssid\":");
+    appendJsonText(json, network.ssid);
+    json.appendf(",\"rssi\":%d,\"channel\":%u,\"security\":\"%s\"}", (int)network.rssi, (unsigned int)network.channel, getSecurityName(network.security));
+  }
 
-    // Show success message.
-    debug(SCS, "Data saved to '%s' key in '%s' namespace.", key, _preferencesNamespace);
-  } else {
-    // Log an error message if saving fails.
-    debug(ERR, "Saving data to '%s' key in '%s' namespace failed.", key, _preferencesNamespace);
+  json.appendf("],\"scanning\":%s", _isScanning || _isScanRequested ? "true" : "false");
+}
+
+/**
+* @brief Start, finish or abandon background scans.
+*
+* A scan starts every CONFIG_SCAN_INTERVAL, or right away when one was requested. The
+* results replace the cache once the scan is complete. A failed scan keeps the cache.
+*/
+void WiFiConfig::serviceScan() {
+  uint32_t now = millis();
+
+  if (_isScanning) {
+    int16_t networksFound = WiFi.scanComplete();
+
+    if (networksFound >= 0) {
+      collectScanResults(networksFound);
+      configScanDuration.observe(now - _scanTime);
+      _isScanning = false;
+    } else if (networksFound == WIFI_SCAN_FAILED || (int32_t)(now - _scanTime) >= CONFIG_SCAN_TIMEOUT) {
+      debug(ERR, "Wi-Fi scan failed, keeping %u cached networks.", (unsigned int)_networkCount);
+      configScanFailureCount.increment();
+      WiFi.scanDelete();
+      _isScanning = false;
+    }
+
+    return;
+  }
+
+  if (!_isScanRequested && (int32_t)(now - _scanTime) < CONFIG_SCAN_INTERVAL) {
+    return;
+  }
+
+  _isScanRequested = false;
+  _scanTime = now;
+
+  // Returns at once, the results are collected on a later call.
+  if (WiFi.scanNetworks(true) == WIFI_SCAN_FAILED) {
+    debug(ERR, "Wi-Fi scan could not be started.");
+    configScanFailureCount.increment();
+    return;
   }
+
+  _isScanning = true;
+  configScanCount.increment();
 }
 
 /**
-* @brief Load a boolean value from the specified key in the preferences namespace.
-* 
-* @param key The key for the boolean value to load.
-* 
-* @return bool containing the value associated with the key.
-*         If the key does not exist, initializes it with a default value of true and returns true.
-*         If loading fails, returns false.
-* 
-* @note This function creates a Preferences instance, attempts to load the value associated 
-*       with the given key, and ensures the Preferences session is properly ended. If the key 
-*       does not exist, it initializes the key with a default value of true.
+* @brief Replace the cache with the results of a completed scan.
+*
+* Access points sharing a name are listed once, with the strongest signal. When there are
+* more networks than the cache holds, the weakest are left out.
+*
+* @param networksFound Number of results of the scan.
 */
-bool WiFiConfig::loadBool(const char* key) {
-  // Create a Preferences instance with the specified namespace.
+void WiFiConfig::collectScanResults(int networksFound) {
+  _networkCount = 0;
+
+  for (int i = 0; i < networksFound; ++i) {
+    String ssid = WiFi.SSID(i);
+
+    // Hidden networks cannot be selected by name.
+    if (ssid.isEmpty()) {
+      continue;
+    }
+
+    ConfigNetwork candidate;
+    strncpy(candidate.ssid, ssid.c_str(), sizeof(candidate.ssid) - 1);
+    candidate.ssid[sizeof(candidate.ssid) - 1] = '\0';
+    candidate.rssi = (int8_t)constrain(WiFi.RSSI(i), -128, 0);
+    candidate.channel = (uint8_t)WiFi.channel(i);
+    candidate.security = (uint8_t)WiFi.encryptionType(i);
+
+    // Find the entry of the same name, or else the weakest entry of a full cache.
+    ConfigNetwork* entry = nullptr;
+
+    for (uint8_t j = 0; j < _networkCount && entry == nullptr; ++j) {
+      if (strcmp(_networks[j].ssid, candidate.ssid) == 0) {
+        entry = &_networks[j];
+      }
+    }
+
+    if (entry == nullptr && _networkCount < CONFIG_SCAN_MAX_NETWORKS) {
+      _networks[_networkCount++] = candidate;
+      continue;
+    }
+
+    if (entry == nullptr) {
+      entry = &_networks[0];
+
+      for (uint8_t j = 1; j < _networkCount; ++j) {
+        if (_networks[j].rssi < entry->rssi) {
+          entry = &_networks[j];
+        }
+      }
+    }
+
+    if (candidate.rssi > entry->rssi) {
+      *entry = candidate;
+    }
+  }
+
+  // Delete the scan result to free memory for code below.
+  WiFi.scanDelete();
+
+  // Strongest first, the cache is small enough for an insertion sort.
+  for (uint8_t i = 1; i < _networkCount; ++i) {
+    ConfigNetwork network = _networks[i];
+    uint8_t j = i;
+
+    for (; j > 0 && _networks[j - 1].rssi < network.rssi; --j) {
+      _networks[j] = _networks[j - 1];
+    }
+
+    _networks[j] = network;
+  }
+
+  debug(LOG, "Wi-Fi scan found %d access points, %u networks cached.", networksFound, (unsigned int)_networkCount);
+}
+
+/**
+* @brief Get the active configuration, loading it on first use.
+*
+* @return Reference to the active configuration.
+*/
+const ConfigData& WiFiConfig::config() {
+  if (!_isConfigLoaded) {
+    loadConfig();
+    _isConfigLoaded = true;
+  }
+
+  return _config;
+}
+
+/**
+* @brief Load the configuration blob in a single preferences session.
+*
+* A blob of an older version is upgraded and written back. Without a blob, the settings
+* of the per-key layout are migrated into a new blob and their keys are removed. If
+* neither exists, or the blob is damaged, the defaults are used.
+*/
+void WiFiConfig::loadConfig() {
+  ConfigBlob& blob = configBlob;
+  setConfigDefaults(_config);
+
+  // Opening read-only fails on a device that was never configured, the defaults then apply.
   Preferences preferences;
-  static bool data;
 
-  if (preferences.begin(_preferencesNamespace, READ_WRITE_MODE)) {
-    // Check if key exists and store default value if FALSE.
-    if (preferences.isKey(key) == false) {
-      preferences.putBool(key, true);
+  if (!preferences.begin(_preferencesNamespace, READ_ONLY_MODE)) {
+    debug(LOG, "No preferences in '%s' namespace, using defaults.", _preferencesNamespace);
+    return;
+  }
+
+  size_t length = preferences.getBytes(CONFIG_BLOB_KEY, &blob, sizeof(blob));
+  bool isMigrated = false;
+
+  if (length != 0) {
+    const ConfigBlobHeader& header = blob.header;
+    bool isHeaderValid = length >= sizeof(header)
+                         && header.magic == CONFIG_BLOB_MAGIC
+                         && header.size == length - sizeof(header)
+                         && header.version <= CONFIG_BLOB_VERSION;
+
+    if (isHeaderValid && esp_rom_crc32_le(0, (const uint8_t*)&blob.data, header.size) == header.crc) {
+      // Older layouts are a prefix of the current one, the appended fields keep their defaults.
+      memcpy(&_config, &blob.data, header.size < sizeof(_config) ? header.size : sizeof(_config));
+      isMigrated = header.version != CONFIG_BLOB_VERSION;
+    } else {
+      debug(ERR, "Configuration blob in '%s' namespace is damaged, using defaults.", _preferencesNamespace);
+      configCorruptCount.increment();
     }
+  } else {
+    isMigrated = readLegacyKeys(preferences, _config);
+  }
+
+  preferences.end();
+
+  if (!isMigrated) {
+    return;
+  }
 
-    // Load value from key.
-    data = preferences.getBool(key);
+  // Store the upgraded layout, so the migration runs only once.
+  debug(CMD, "Migrating preferences in '%s' namespace to layout version %u.", _preferencesNamespace, CONFIG_BLOB_VERSION);
+  configMigrationCount.increment();
+
+  if (!writeConfig(_config)) {
+    return;
+  }
+
+  // The settings now live in the blob, free the individual keys.
+  if (length == 0 && preferences.begin(_preferencesNamespace, READ_WRITE_MODE)) {
+    const char* const legacyKeys[] = { NETWORK_NAME, NETWORK_PASS, MQTT_SERVER_ADDRESS, MQTT_SERVER_PORT, MQTT_USERNAME,
+                                       MQTT_PASS, MQTT_CLIENT_ID, MQTT_TOPIC, AUDIO_NOTIFICATIONS, VISUAL_NOTIFICATIONS };
+
+    for (size_t i = 0; i < sizeof(legacyKeys) / sizeof(legacyKeys[0]); ++i) {
+      preferences.remove(legacyKeys[i]);
+    }
 
-    // End preferences session.
     preferences.end();
-  } else {
-    // Log an error message and return a default value if loading fails.
-    debug(ERR, "Loading '%s' key from '%s' namespace failed. Will use default value.", key, _preferencesNamespace);
-    data = false;
   }
+}
+
+/**
+* @brief Read the settings stored under individual keys by earlier firmware.
+*
+* Earlier firmware stored "Unknown" for text settings that were never configured, those
+* are read as empty.
+*
+* @param preferences Open preferences session.
+* @param data Configuration receiving the settings, holding the defaults on entry.
+* @return true if at least one setting was found.
+*/
+bool WiFiConfig::readLegacyKeys(Preferences& preferences, ConfigData& data) {
+  char text[PREFERENCES_VALUE_SIZE];
+  bool isFound = false;
 
-  return data;
+  for (size_t i = 0; i < CONFIG_FIELD_COUNT; ++i) {
+    const ConfigField& field = configSchema[i];
+
+    if (!preferences.isKey(field.key)) {
+      continue;
+    }
+
+    isFound = true;
+
+    if (field.type == CONFIG_SWITCH) {
+      setFieldValue(data, field, preferences.getBool(field.key));
+    } else if (field.type == CONFIG_NUMBER) {
+      setFieldValue(data, field, preferences.getInt(field.key));
+    } else if (preferences.getString(field.key, text, sizeof(text)) != 0 && strcmp(text, "Unknown") != 0) {
+      // Nothing is loaded if the stored value does not fit.
+      setFieldText(data, field, text);
+    }
+  }
+
+  return isFound;
 }
 
 /**
-* @brief Save a boolean value to the specified key in the preferences namespace.
-* 
-* @param key The key to which the boolean value will be saved.
-* @param value The boolean value to save.
-* 
-* @note This function creates a Preferences instance, attempts to save the value associated 
-*       with the given key, and ensures the Preferences session is properly ended. If saving 
-*       fails, an error message is logged.
+* @brief Write a configuration and make it the active one.
+*
+* Nothing is written if the configuration equals the active one, which spares the flash
+* when a form is submitted without changes.
+*
+* @param data The configuration to write.
+* @return true if the configuration is stored, false if the write failed.
 */
-void WiFiConfig::saveBool(const char* key, bool value) {
-  // Create a Preferences instance with the specified namespace.
+bool WiFiConfig::saveConfig(const ConfigData& data) {
+  if (memcmp(&data, &config(), sizeof(data)) == 0) {
+    debug(LOG, "Configuration unchanged, nothing written to '%s' namespace.", _preferencesNamespace);
+    configUnchangedCount.increment();
+    return true;
+  }
+
+  if (!writeConfig(data)) {
+    return false;
+  }
+
+  // Swap the stored copy in only once it is safely written.
+  _config = data;
+  return true;
+}
+
+/**
+* @brief Write a configuration blob in a single preferences session.
+*
+* @param data The configuration to write, may be the data of the shared blob.
+* @return true if the blob was written.
+*/
+bool WiFiConfig::writeConfig(const ConfigData& data) {
+  ConfigBlob& blob = configBlob;
+
+  if (&data != &blob.data) {
+    blob.data = data;
+  }
+
+  blob.header.magic = CONFIG_BLOB_MAGIC;
+  blob.header.version = CONFIG_BLOB_VERSION;
+  blob.header.size = sizeof(blob.data);
+  blob.header.crc = esp_rom_crc32_le(0, (const uint8_t*)&blob.data, sizeof(blob.data));
+
   Preferences preferences;
+  bool isWritten = false;
 
   if (preferences.begin(_preferencesNamespace, READ_WRITE_MODE)) {
-    // Save the value to the specified key.
-    preferences.putBool(key, value);
-
-    // End preferences session.
+    isWritten = preferences.putBytes(CONFIG_BLOB_KEY, &blob, sizeof(blob)) == sizeof(blob);
     preferences.end();
+  }
 
-    // Show success message.
-    debug(SCS, "Data saved to '%s' key in '%s' namespace.", key, _preferencesNamespace);
-  } else {
-    // Log an error message if saving fails.
-    debug(ERR, "Saving data to '%s' key in '%s' namespace failed.", key, _preferencesNamespace);
+  if (!isWritten) {
+    debug(ERR, "Saving configuration to '%s' namespace failed.", _preferencesNamespace);
+    configWriteFailureCount.increment();
   }
+
+  return isWritten;
 }
 
 /**
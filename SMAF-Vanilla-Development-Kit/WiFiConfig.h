@@ -39,25 +39,113 @@
 #include "WiFiServer.h"
 #include "Preferences.h"
 #include "Helpers.h"
-
-// Define constant strings for Wi-Fi network configuration.
-#define NETWORK_NAME "netName"  // Wi-Fi network name.
-#define NETWORK_PASS "netPass"  // Wi-Fi network password.
-
-// Define constant strings for MQTT configuration.
-#define MQTT_SERVER_ADDRESS "mqttSrvAdr"    // MQTT server address.
-#define MQTT_SERVER_PORT "mqttSrvPort"      // MQTT server port.
-#define MQTT_USERNAME "mqttUser"            // MQTT username.
-#define MQTT_PASS "mqttPass"                // MQTT password.
-#define MQTT_CLIENT_ID "mqttClient"         // MQTT client ID.
-#define MQTT_TOPIC "mqttTopic"              // MQTT topic.
-#define AUDIO_NOTIFICATIONS "audioNotif"    // Audio Notifications status.
-#define VISUAL_NOTIFICATIONS "visualNotif"  // Visual Notifications status.
+#include "FixedString.h"
+#include "ConfigSchema.h"
+
+// Define configuration blob parameters.
+// The whole configuration is stored as one blob under a single key. Earlier firmware stored
+// every setting under its own schema key, that layout is version 1 and is migrated on boot.
+#define CONFIG_BLOB_KEY "config"      // Preferences key of the configuration blob.
+#define CONFIG_BLOB_MAGIC 0x46414D53  // "SMAF" in little-endian byte order, marks a configuration blob.
+#define CONFIG_BLOB_VERSION 2         // Layout version of ConfigData.
+
+// Define configuration page parameters.
+#define CONFIG_JSON_SIZE 6144      // Size of the settings and scan results sent to the page, in bytes.
+#define CONFIG_RESTART_DELAY 2400  // Time between saving settings that need a restart and the restart, in milliseconds.
+
+// Define configuration server parameters.
+#define CONFIG_MAX_CONNECTIONS 4         // Connections served at the same time, more wait in the listen backlog.
+#define CONFIG_REQUEST_SIZE (sizeof("GET /configuration? HTTP/1.1") + getConfigQueryLength(0))  // Longest request line, a form submission with every setting at its maximum.
+#define CONFIG_HEADER_LINE_SIZE 48       // Start of a header line kept for parsing, enough for If-None-Match.
+#define CONFIG_REQUEST_TIMEOUT 3000      // Time a client has to complete its request, in milliseconds.
+#define CONFIG_KEEP_ALIVE_TIMEOUT 5000   // Time an idle keep-alive connection stays open, in milliseconds.
+#define CONFIG_KEEP_ALIVE_REQUESTS 32    // Requests served on one connection before it is closed.
+#define CONFIG_SEND_TIMEOUT 5000         // Time a response may make no progress before the connection is closed, in milliseconds.
+#define CONFIG_SEND_CHUNK_SIZE 1436      // Bytes written per connection and call, one TCP segment.
+#define CONFIG_INPUT_SIZE 64             // Bytes read from a connection at once.
+
+// Define Wi-Fi scan cache parameters.
+#define CONFIG_SCAN_INTERVAL 30000    // Interval between background scans in milliseconds.
+#define CONFIG_SCAN_TIMEOUT 15000     // Time after which a scan that did not complete is abandoned, in milliseconds.
+#define CONFIG_SCAN_MAX_NETWORKS 24   // Networks kept in the cache, the weakest are left out.
 
 // Define read/write modes for preferences.
 #define READ_WRITE_MODE false
 #define READ_ONLY_MODE true
 
+/**
+* @struct ConfigBlobHeader
+* @brief Header stored in front of the configuration data.
+*/
+struct ConfigBlobHeader {
+  uint32_t magic;    // CONFIG_BLOB_MAGIC.
+  uint16_t version;  // Layout version of the data.
+  uint16_t size;     // Size of the data in bytes.
+  uint32_t crc;      // CRC-32 of the data.
+};
+
+/**
+* @struct ConfigBlob
+* @brief Configuration blob as written to preferences.
+*/
+struct ConfigBlob {
+  ConfigBlobHeader header;
+  ConfigData data;
+};
+
+// Settings and scan results sent to the configuration page.
+typedef FixedString<CONFIG_JSON_SIZE> ConfigJson;
+
+/**
+* @struct ConfigNetwork
+* @brief Cached scan result of a Wi-Fi network, the strongest access point of its name.
+*/
+struct ConfigNetwork {
+  char ssid[33];     // Network name, up to 32 characters.
+  int8_t rssi;       // Signal strength in dBm.
+  uint8_t channel;   // Primary channel.
+  uint8_t security;  // Authentication mode, a wifi_auth_mode_t value.
+};
+
+/**
+* @enum ConfigConnectionStateEnum
+* @brief Enumeration of the states of a configuration server connection.
+*/
+enum ConfigConnectionStateEnum : byte {
+  CONFIG_CONNECTION_FREE,     // Slot is unused.
+  CONFIG_CONNECTION_READING,  // Receiving a request, or idle between keep-alive requests.
+  CONFIG_CONNECTION_WAITING,  // Request received, waiting for the settings JSON to be free.
+  CONFIG_CONNECTION_SENDING   // Sending the response.
+};
+
+/**
+* @struct ConfigConnection
+* @brief State of one configuration server connection.
+*/
+struct ConfigConnection {
+  WiFiClient client;
+  ConfigConnectionStateEnum state = CONFIG_CONNECTION_FREE;
+  char request[CONFIG_REQUEST_SIZE];     // Request line, e.g. "GET /config.json HTTP/1.1".
+  uint16_t requestLength = 0;            // Number of request line characters stored.
+  char line[CONFIG_HEADER_LINE_SIZE];    // Start of the header line being received.
+  uint8_t input[CONFIG_INPUT_SIZE];      // Bytes read but not parsed yet, e.g. of a pipelined request.
+  uint8_t inputLength = 0;               // Number of bytes in the input buffer.
+  uint8_t inputOffset = 0;               // Next input byte to parse.
+  uint8_t lineLength = 0;                // Number of header line characters stored.
+  bool isRequestLineDone = false;        // Whether the headers are being received.
+  bool isOverlong = false;               // Whether the request line did not fit.
+  bool isPageCached = false;             // Whether the client holds the current page.
+  bool isKeepAlive = false;              // Whether the connection stays open after the response.
+  uint8_t requestCount = 0;              // Requests received on this connection.
+  uint32_t deadline = 0;                 // Time by which the current state must make progress.
+  uint32_t requestTime = 0;              // Time the request was complete, in microseconds.
+  uint32_t freeHeap = 0;                 // Free heap when the request was complete.
+  FixedString<256> header;               // Response status line and headers.
+  const uint8_t* body = nullptr;         // Response body, in flash or in a static buffer.
+  size_t bodyLength = 0;                 // Response body size.
+  size_t sent = 0;                       // Response bytes written, header included.
+};
+
 class WiFiConfig {
 public:
   /**
@@ -85,12 +173,19 @@ public:
   void startConfiguration();
 
   /**
-  * @brief Render the configuration page for device setup.
+  * @brief Serve the configuration page for device setup.
   * 
-  * This function serves an HTML configuration page to the connected client.
-  * It processes the form submission and saves the configuration settings.
+  * This function never waits for a client. Every call accepts new connections, reads
+  * what has arrived on each open connection and writes the next part of each response.
+  * Up to CONFIG_MAX_CONNECTIONS are served at the same time, with keep-alive, and every
+  * connection that stops making progress is closed after its timeout.
   * 
-  * @note The HTML structure and styling are included for presentation purposes.
+  * The page itself is static and served gzip-compressed from flash with an ETag, so a
+  * browser that already holds it gets a bodyless 304. The page loads the settings and the
+  * cached scan results from /config.json. A form submission is saved before the page is sent.
+  * 
+  * @note Call this method continuously. A restart that applies saved settings happens on a
+  *       later call, once the browser had time to load the page confirming the save.
   */
   void renderConfigurationPage();
 
@@ -116,10 +211,10 @@ public:
   * @brief Get the configured Wi-Fi network name.
   * 
   * @return const char* representing the Wi-Fi network name.
-  *         If empty, returns "NULL".
+  *         An empty string if it is not configured.
   * 
-  * @note The returned pointer is valid until the class instance is destroyed,
-  *       or until the next call to a function that modifies the Wi-Fi network name.
+  * @note The returned pointer points into the loaded configuration and stays valid while
+  *       the instance exists. The text changes when a new configuration is saved.
   */
   const char* getNetworkName();
 
@@ -127,10 +222,10 @@ public:
   * @brief Get the configured Wi-Fi network password.
   * 
   * @return const char* representing the Wi-Fi network password.
-  *         If empty, returns "NULL".
+  *         An empty string if it is not configured.
   * 
-  * @note The returned pointer is valid until the class instance is destroyed,
-  *       or until the next call to a function that modifies the Wi-Fi network password.
+  * @note The returned pointer points into the loaded configuration and stays valid while
+  *       the instance exists. The text changes when a new configuration is saved.
   */
   const char* getNetworkPass();
 
@@ -138,10 +233,10 @@ public:
   * @brief Get the configured MQTT server address.
   * 
   * @return const char* representing the MQTT server address.
-  *         If empty, returns "NULL".
+  *         An empty string if it is not configured.
   * 
-  * @note The returned pointer is valid until the class instance is destroyed,
-  *       or until the next call to a function that modifies the MQTT server address.
+  * @note The returned pointer points into the loaded configuration and stays valid while
+  *       the instance exists. The text changes when a new configuration is saved.
   */
   const char* getMqttServerAddress();
 
@@ -149,10 +244,10 @@ public:
   * @brief Get the configured MQTT username.
   * 
   * @return const char* representing the MQTT username.
-  *         If empty, returns "NULL".
+  *         An empty string if it is not configured.
   * 
-  * @note The returned pointer is valid until the class instance is destroyed,
-  *       or until the next call to a function that modifies the MQTT username.
+  * @note The returned pointer points into the loaded configuration and stays valid while
+  *       the instance exists. The text changes when a new configuration is saved.
   */
   const char* getMqttUsername();
 
@@ -160,10 +255,10 @@ public:
   * @brief Get the configured MQTT password.
   * 
   * @return const char* representing the MQTT password.
-  *         If empty, returns "NULL".
+  *         An empty string if it is not configured.
   * 
-  * @note The returned pointer is valid until the class instance is destroyed,
-  *       or until the next call to a function that modifies the MQTT password.
+  * @note The returned pointer points into the loaded configuration and stays valid while
+  *       the instance exists. The text changes when a new configuration is saved.
   */
   const char* getMqttPass();
 
@@ -171,10 +266,10 @@ public:
   * @brief Get the configured MQTT client ID.
   * 
   * @return const char* representing the MQTT client ID.
-  *         If empty, returns "NULL".
+  *         An empty string if it is not configured.
   * 
-  * @note The returned pointer is valid until the class instance is destroyed,
-  *       or until the next call to a function that modifies the MQTT client ID.
+  * @note The returned pointer points into the loaded configuration and stays valid while
+  *       the instance exists. The text changes when a new configuration is saved.
   */
   const char* getMqttClientId();
 
@@ -182,10 +277,10 @@ public:
   * @brief Get the configured MQTT topic.
   * 
   * @return const char* representing the MQTT topic.
-  *         If empty, returns "NULL".
+  *         An empty string if it is not configured.
   * 
-  * @note The returned pointer is valid until the class instance is destroyed,
-  *       or until the next call to a function that modifies the MQTT topic.
+  * @note The returned pointer points into the loaded configuration and stays valid while
+  *       the instance exists. The text changes when a new configuration is saved.
   */
   const char* getMqttTopic();
 
@@ -195,7 +290,7 @@ public:
   * @return bool representing the status of audio notifications.
   *         Returns true if audio notifications are enabled, false otherwise.
   * 
-  * @note The returned value is cached after the first call and remains the same for subsequent calls.
+  * @note The configuration is loaded on the first call, the value changes when a new one is saved.
   */
   bool getAudioNotificationsStatus();
 
@@ -205,7 +300,7 @@ public:
   * @return bool representing the status of visual notifications.
   *         Returns true if visual notifications are enabled, false otherwise.
   * 
-  * @note The returned value is cached after the first call and remains the same for subsequent calls.
+  * @note The configuration is loaded on the first call, the value changes when a new one is saved.
   */
   bool getVisualNotificationsStatus();
 
@@ -228,6 +323,70 @@ private:
   // Preferences namespace.
   const char* _preferencesNamespace;
 
+  // Active configuration. It is only replaced as a whole, once a changed copy has been written.
+  ConfigData _config;
+  bool _isConfigLoaded = false;
+
+  // Restart that applies saved settings, delayed so the browser can load the page first.
+  bool _isRestartPending = false;
+  uint32_t _restartTime = 0;
+
+  // Configuration server connections.
+  ConfigConnection _connections[CONFIG_MAX_CONNECTIONS];
+
+  // Connection whose response is the settings JSON, which only one response uses at a time.
+  ConfigConnection* _jsonOwner = nullptr;
+
+  // Wi-Fi scan cache, sorted by signal strength, strongest first.
+  ConfigNetwork _networks[CONFIG_SCAN_MAX_NETWORKS];
+  uint8_t _networkCount = 0;
+  bool _isScanning = false;       // Whether a background scan is running.
+  bool _isScanRequested = false;  // Whether a scan should start as soon as possible.
+  uint32_t _scanTime = 0;         // Start of the running scan, or of the last one.
+
+  /**
+  * @brief Get the active configuration, loading it on first use.
+  *
+  * @return Reference to the active configuration.
+  */
+  const ConfigData& config();
+
+  /**
+  * @brief Load the configuration blob in a single preferences session.
+  *
+  * A blob of an older version is upgraded and written back. Without a blob, the settings
+  * of the per-key layout are migrated into a new blob and their keys are removed. If
+  * neither exists, or the blob is damaged, the defaults are used.
+  */
+  void loadConfig();
+
+  /**
+  * @brief Read the settings stored under individual keys by earlier firmware.
+  *
+  * @param preferences Open preferences session.
+  * @param data Configuration receiving the settings, holding the defaults on entry.
+  * @return true if at least one setting was found.
+  */
+  bool readLegacyKeys(Preferences& preferences, ConfigData& data);
+
+  /**
+  * @brief Write a configuration and make it the active one.
+  *
+  * Nothing is written if the configuration equals the active one.
+  *
+  * @param data The configuration to write.
+  * @return true if the configuration is stored, false if the write failed.
+  */
+  bool saveConfig(const ConfigData& data);
+
+  /**
+  * @brief Write a configuration blob in a single preferences session.
+  *
+  * @param data The configuration to write.
+  * @return true if the blob was written.
+  */
+  bool writeConfig(const ConfigData& data);
+
   /**
   * @brief Get the configured network name for SoftAP.
   * 
@@ -273,98 +432,107 @@ private:
   uint16_t getConfigServerPort();
 
   /**
-  * @brief Scan for available Wi-Fi networks and return them in HTML option format.
-  * 
-  * @return String containing the HTML option elements for each available network.
-  *         If no networks are found, an empty string is returned.
-  * 
-  * @note The function scans for Wi-Fi networks, formats them as HTML option elements,
-  *       and returns the resulting string. It also frees memory used for the scan results
-  *       after processing.
+  * @brief Accept waiting connections while a slot is free.
+  *
+  * If every slot is taken, a connection idling between keep-alive requests is closed to
+  * make room. Otherwise new connections wait in the listen backlog.
   */
-  String scanNetworks();
+  void acceptConnections();
 
   /**
-  * @brief Load a string value from the preferences storage.
-  * 
-  * @param key The key associated with the string value to be loaded.
-  * 
-  * @return String containing the value associated with the specified key.
-  *         If the key does not exist, "Unknown" is stored and returned.
-  *         If the loading fails, a default value is returned.
-  * 
-  * @note The function initializes a Preferences instance with the specified namespace,
-  *       checks if the key exists, stores a default value if it does not, loads the value,
-  *       and ends the preferences session. If loading fails, an error message is logged
-  *       and a default value is returned.
+  * @brief Advance the state machine of a connection.
+  *
+  * @param connection The connection.
   */
-  String loadString(const char* key);
+  void serviceConnection(ConfigConnection& connection);
 
   /**
-  * @brief Save a string value to the specified key in the preferences namespace.
-  * 
-  * @param key The key to which the string value will be saved.
-  * @param value The string value to save.
-  * 
-  * @note This function creates a Preferences instance, attempts to save the value associated 
-  *       with the given key, and ensures the Preferences session is properly ended. If saving 
-  *       fails, an error message is logged.
+  * @brief Read the request bytes that have arrived on a connection.
+  *
+  * @param connection The connection.
+  * @return true once the blank line ending the headers has been received.
   */
-  void saveString(const char* key, String value);
+  bool readRequest(ConfigConnection& connection);
 
   /**
-  * @brief Load an integer value from the specified key in the preferences namespace.
-  * 
-  * @param key The key for the integer value to load.
-  * 
-  * @return uint16_t containing the value associated with the key.
-  *         If the key does not exist, initializes it with a default value of 0 and returns 0.
-  *         If loading fails, returns 0.
-  * 
-  * @note This function creates a Preferences instance, attempts to load the value associated 
-  *       with the given key, and ensures the Preferences session is properly ended. If the key 
-  *       does not exist, it initializes the key with a default value of 0.
+  * @brief Handle a received request and set up its response.
+  *
+  * @param connection The connection holding the request.
   */
-  uint16_t loadInt(const char* key);
+  void prepareResponse(ConfigConnection& connection);
 
   /**
-  * @brief Save an integer value to the specified key in the preferences namespace.
-  * 
-  * @param key The key to which the integer value will be saved.
-  * @param value The integer value to save.
-  * 
-  * @note This function creates a Preferences instance, attempts to save the value associated 
-  *       with the given key, and ensures the Preferences session is properly ended. If saving 
-  *       fails, an error message is logged.
+  * @brief Set up the response of a connection and start sending it.
+  *
+  * @param connection The connection.
+  * @param status Status code and reason, e.g. "200 OK".
+  * @param headers Additional header lines, each ending with CRLF.
+  * @param body The body, must stay valid until the response is sent.
+  * @param bodyLength Size of the body.
   */
-  void saveInt(const char* key, uint16_t value);
+  void setResponse(ConfigConnection& connection, const char* status, const char* headers, const uint8_t* body, size_t bodyLength);
 
   /**
-  * @brief Load a boolean value from the specified key in the preferences namespace.
-  * 
-  * @param key The key for the boolean value to load.
-  * 
-  * @return bool containing the value associated with the key.
-  *         If the key does not exist, initializes it with a default value of true and returns true.
-  *         If loading fails, returns false.
-  * 
-  * @note This function creates a Preferences instance, attempts to load the value associated 
-  *       with the given key, and ensures the Preferences session is properly ended. If the key 
-  *       does not exist, it initializes the key with a default value of true.
+  * @brief Write the next part of the response of a connection.
+  *
+  * @param connection The connection.
+  * @return true once the whole response has been written.
   */
-  bool loadBool(const char* key);
+  bool sendResponse(ConfigConnection& connection);
 
   /**
-  * @brief Save a boolean value to the specified key in the preferences namespace.
-  * 
-  * @param key The key to which the boolean value will be saved.
-  * @param value The boolean value to save.
+  * @brief Prepare a connection for its next request.
+  *
+  * @param connection The connection.
+  * @param timeout Time until the next request must be complete, in milliseconds.
+  */
+  void resetConnection(ConfigConnection& connection, uint32_t timeout);
+
+  /**
+  * @brief Close a connection and free its slot.
+  *
+  * @param connection The connection.
+  */
+  void closeConnection(ConfigConnection& connection);
+
+  /**
+  * @brief Build the settings and scan results the configuration page is filled with.
+  *
+  * Every setting is listed with its schema row, so the page needs no knowledge of the
+  * settings. Secrets are never sent, only whether one is stored.
+  *
+  * @param json Destination, check isTruncated() before sending it.
+  */
+  void buildConfigJson(ConfigJson& json);
+
+  /**
+  * @brief Save the settings of a submitted configuration form.
+  *
+  * @param request First line of the form submission request.
+  */
+  void saveConfigurationForm(const String& request);
+
+  /**
+  * @brief Append the cached networks and the scan state as JSON object members.
   * 
-  * @note This function creates a Preferences instance, attempts to save the value associated 
-  *       with the given key, and ensures the Preferences session is properly ended. If saving 
-  *       fails, an error message is logged.
+  * @param json The JSON being built, inside an object.
+  */
+  void appendNetworks(ConfigJson& json);
+
+  /**
+  * @brief Start, finish or abandon background scans.
+  *
+  * A scan starts every CONFIG_SCAN_INTERVAL, or right away when one was requested. The
+  * results replace the cache once the scan is complete.
+  */
+  void serviceScan();
+
+  /**
+  * @brief Replace the cache with the results of a completed scan.
+  *
+  * @param networksFound Number of results of the scan.
   */
-  void saveBool(const char* key, bool value);
+  void collectScanResults(int networksFound);
 
   /**
   * @brief Parse and extract the value of a field from a URL-encoded String.
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""
+SMAF-Vanilla-Development-Kit configuration page generator.
+
+Compresses tools/config_page.html with gzip and writes it as a byte array into
+SMAF-Vanilla-Development-Kit/ConfigPage.h, together with the ETag the firmware sends
+for it. Run it after every change of the page and commit both files:
+
+    python3 tools/smaf_config_page.py
+
+The output is reproducible: the gzip header carries no timestamp or file name, so the
+same page always gives the same bytes and the same ETag. Comments of the page are not
+shipped.
+
+MIT License. See LICENSE in the repository root.
+"""
+
+import argparse
+import gzip
+import hashlib
+import os
+import re
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+DEFAULT_INPUT = os.path.join(ROOT, "tools", "config_page.html")
+DEFAULT_OUTPUT = os.path.join(ROOT, "SMAF-Vanilla-Development-Kit", "ConfigPage.h")
+
+COMMENT_PATTERN = re.compile(r"<!--.*?-->\s*", re.DOTALL)
+BYTES_PER_LINE = 16
+
+LICENSE = """* @license MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/"""
+
+
+def compress(page):
+    """Gzip the page without timestamp, so the output only depends on the content."""
+    return gzip.compress(COMMENT_PATTERN.sub("", page).encode("utf-8"), compresslevel=9, mtime=0)
+
+
+def render_header(data, source_size):
+    etag = '"%s"' % hashlib.sha256(data).hexdigest()[:16]
+    lines = []
+    for offset in range(0, len(data), BYTES_PER_LINE):
+        lines.append("  " + ", ".join("0x%02x" % byte for byte in data[offset:offset + BYTES_PER_LINE]) + ",")
+
+    return "\n".join([
+        "/**",
+        "* @file ConfigPage.h",
+        "* @brief Gzip-compressed configuration page for Arduino project.",
+        "*",
+        "* This file is generated by tools/smaf_config_page.py from tools/config_page.html.",
+        "* Do not edit it by hand. The page is %d bytes, %d bytes compressed." % (source_size, len(data)),
+        "*",
+        LICENSE,
+        "",
+        "#ifndef CONFIG_PAGE_H",
+        "#define CONFIG_PAGE_H",
+        "",
+        '#include "Arduino.h"',
+        "",
+        "// Entity tag of the page, changes with every change of the page.",
+        "#define CONFIG_PAGE_ETAG \"%s\"" % etag.replace('"', '\\"'),
+        "",
+        "// Compressed page, stays in flash.",
+        "static const uint8_t configPageGzip[] PROGMEM = {",
+        "\n".join(lines),
+        "};",
+        "",
+        "#endif",
+        "",
+    ])
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--input", default=DEFAULT_INPUT, help="page source, default tools/config_page.html")
+    parser.add_argument("--output", default=DEFAULT_OUTPUT, help="firmware header to write")
+    args = parser.parse_args()
+
+    try:
+        with open(args.input, encoding="utf-8") as stream:
+            page = stream.read()
+    except OSError as error:
+        sys.exit("Reading the page failed: %s" % error)
+
+    data = compress(page)
+
+    with open(args.output, "w", encoding="utf-8", newline="\n") as stream:
+        stream.write(render_header(data, len(page.encode("utf-8"))))
+
+    print("%s: %d bytes compressed to %d bytes." % (os.path.relpath(args.output, ROOT), len(page.encode("utf-8")), len(data)))
+
+
+if __name__ == "__main__":
+    main()
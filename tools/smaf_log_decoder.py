@@ -0,0 +1,267 @@
+#!/usr/bin/env python3
+"""
+SMAF-Vanilla-Development-Kit binary log decoder.
+
+Firmware built with -DLOG_BINARY_MODE=1 does not send formatted text. Each debug()
+call sends a compact frame holding a 32-bit format string ID (FNV-1a hash of the
+format string, computed at compile time) and the raw arguments. This tool builds the
+ID table from the sketch sources and turns the frames back into the usual log lines.
+
+Frame layout (multi-byte fields are little-endian):
+    0xA5 | length | type << 4 | core | format ID (4) | millis (4) | payload | xor
+
+Usage:
+    # Generate the ID table for the current sources (run as part of the build).
+    python3 tools/smaf_log_decoder.py table -o build/log_ids.json
+
+    # Decode a capture file, stdin, or a serial port (requires pyserial).
+    python3 tools/smaf_log_decoder.py decode capture.bin --table build/log_ids.json
+    python3 tools/smaf_log_decoder.py decode --port /dev/ttyUSB0
+
+Without --table, the table is regenerated from the sources on every run. Bytes
+outside valid frames (boot ROM output, Serial.printf banners) are passed through.
+
+MIT License. See LICENSE in the repository root.
+"""
+
+import argparse
+import json
+import os
+import re
+import struct
+import sys
+
+FRAME_SYNC = 0xA5
+FRAME_HEADER_SIZE = 11  # Sync, length, type/core, format ID, timestamp.
+MAX_PAYLOAD_SIZE = 48   # LOG_RECORD_PAYLOAD_SIZE in Logger.h.
+
+MESSAGE_TYPES = {0: "LOG", 1: "ERROR", 2: "OK", 3: "CMD"}
+
+DEFAULT_SOURCE_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "SMAF-Vanilla-Development-Kit")
+
+# debug(TYPE, "format", ...) and LOG_FORMAT_ID("format") with a single string literal.
+FORMAT_PATTERN = re.compile(r'(?:\bdebug\s*\(\s*\w+\s*,|\bLOG_FORMAT_ID\s*\()\s*"((?:[^"\\]|\\.)*)"')
+
+# printf conversion specification.
+CONVERSION_PATTERN = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|j|z|t|L)?([diouxXeEfFgGaAcsp%])")
+
+ESCAPES = {"n": "\n", "r": "\r", "t": "\t", "0": "\0", "\\": "\\", '"': '"', "'": "'", "a": "\a", "b": "\b", "f": "\f", "v": "\v"}
+
+
+def fnv1a(data):
+    """Same hash as logFormatId() in Logger.h."""
+    value = 2166136261
+    for byte in data:
+        value = ((value ^ byte) * 16777619) & 0xFFFFFFFF
+    return value
+
+
+def unescape(literal):
+    """Decode the escape sequences of a C string literal body."""
+    result = []
+    i = 0
+    while i < len(literal):
+        char = literal[i]
+        if char == "\\" and i + 1 < len(literal):
+            following = literal[i + 1]
+            if following == "x":
+                match = re.match(r"[0-9a-fA-F]{1,2}", literal[i + 2:])
+                result.append(chr(int(match.group(0), 16)))
+                i += 2 + len(match.group(0))
+                continue
+            result.append(ESCAPES.get(following, following))
+            i += 2
+            continue
+        result.append(char)
+        i += 1
+    return "".join(result)
+
+
+def build_table(source_dir):
+    """Map format IDs to format strings for every debug() call in the sources."""
+    table = {}
+    for name in sorted(os.listdir(source_dir)):
+        if not name.endswith((".ino", ".cpp", ".h")):
+            continue
+        with open(os.path.join(source_dir, name), encoding="utf-8") as source:
+            text = source.read()
+        for match in FORMAT_PATTERN.finditer(text):
+            format_string = unescape(match.group(1))
+            format_id = fnv1a(format_string.encode("utf-8"))
+            existing = table.get(format_id)
+            if existing is not None and existing != format_string:
+                sys.exit("Format ID collision 0x%08x between %r and %r" % (format_id, existing, format_string))
+            table[format_id] = format_string
+    return table
+
+
+def load_table(path):
+    with open(path, encoding="utf-8") as table_file:
+        return {int(key, 16): value for key, value in json.load(table_file).items()}
+
+
+def render(format_string, payload):
+    """Rebuild the message text by walking the conversions of the format string."""
+    output = []
+    position = 0
+    offset = 0
+
+    def take(size, code):
+        nonlocal offset
+        if offset + size > len(payload):
+            raise ValueError("truncated")
+        value = struct.unpack_from(code, payload, offset)[0]
+        offset += size
+        return value
+
+    def take_string():
+        nonlocal offset
+        end = payload.find(b"\0", offset)
+        if end < 0:
+            end = len(payload)
+        value = payload[offset:end].decode("utf-8", "replace")
+        offset = end + 1
+        return value
+
+    for match in CONVERSION_PATTERN.finditer(format_string):
+        output.append(format_string[position:match.start()])
+        position = match.end()
+        flags, width, precision, length, conversion = match.groups()
+
+        if conversion == "%":
+            output.append("%")
+            continue
+
+        try:
+            if width == "*":
+                width = str(take(4, "<i"))
+            if precision == "*":
+                precision = str(take(4, "<i"))
+
+            if conversion == "s":
+                value = take_string()
+            elif conversion in "eEfFgGaA":
+                value = take(8, "<d")
+            elif length in ("ll", "j"):
+                value = take(8, "<q" if conversion in "di" else "<Q")
+            elif conversion == "p":
+                value = take(4, "<I")
+            else:
+                value = take(4, "<i" if conversion in "di" else "<I")
+        except ValueError:
+            output.append("<truncated>")
+            break
+
+        spec = "%" + flags + (width or "") + ("." + precision if precision is not None else "")
+        if conversion == "p":
+            output.append(("0x%08x" % value))
+        elif conversion == "c":
+            output.append((spec + "c") % chr(value & 0xFF))
+        elif conversion in "aA":
+            output.append(float(value).hex())
+        else:
+            output.append((spec + ("d" if conversion in "iu" else conversion)) % value)
+    else:
+        output.append(format_string[position:])
+
+    return "".join(output)
+
+
+def decode_stream(chunks, table, show_timestamp):
+    """Yield decoded lines and passthrough text from an iterable of byte chunks."""
+    buffer = bytearray()
+    for chunk in chunks:
+        buffer.extend(chunk)
+        while buffer:
+            sync = buffer.find(bytes([FRAME_SYNC]))
+            if sync != 0:
+                passthrough = buffer if sync < 0 else buffer[:sync]
+                yield passthrough.decode("utf-8", "replace")
+                del buffer[:len(passthrough)]
+                continue
+            if len(buffer) < FRAME_HEADER_SIZE:
+                break
+            length = buffer[1]
+            frame_size = FRAME_HEADER_SIZE + length + 1
+            if length > MAX_PAYLOAD_SIZE:
+                yield chr(buffer[0])
+                del buffer[:1]
+                continue
+            if len(buffer) < frame_size:
+                break
+            checksum = 0
+            for byte in buffer[1:frame_size - 1]:
+                checksum ^= byte
+            if checksum != buffer[frame_size - 1]:
+                yield buffer[:1].decode("latin-1")
+                del buffer[:1]
+                continue
+
+            type_core = buffer[2]
+            format_id, timestamp = struct.unpack_from("<II", buffer, 3)
+            payload = bytes(buffer[FRAME_HEADER_SIZE:FRAME_HEADER_SIZE + length])
+            del buffer[:frame_size]
+
+            format_string = table.get(format_id)
+            if format_string is None:
+                text = "<unknown format 0x%08x, payload %s>" % (format_id, payload.hex())
+            else:
+                text = render(format_string, payload)
+
+            prefix = "%10.3f | " % (timestamp / 1000.0) if show_timestamp else ""
+            yield "%sCORE-%02d | %5s | %s\n" % (prefix, type_core & 0x0F, MESSAGE_TYPES.get(type_core >> 4, "?"), text)
+
+
+def read_chunks(args):
+    if args.port:
+        import serial  # pyserial
+        connection = serial.Serial(args.port, args.baud, timeout=0.2)
+        while True:
+            data = connection.read(256)
+            if data:
+                yield data
+    else:
+        source = sys.stdin.buffer if args.input in (None, "-") else open(args.input, "rb")
+        with source:
+            while True:
+                data = source.read(4096)
+                if not data:
+                    return
+                yield data
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--sources", default=DEFAULT_SOURCE_DIR, help="sketch directory to scan for format strings")
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    table_command = commands.add_parser("table", help="generate the format ID table")
+    table_command.add_argument("-o", "--output", help="output JSON file (default: stdout)")
+
+    decode_command = commands.add_parser("decode", help="decode binary log output")
+    decode_command.add_argument("input", nargs="?", help="capture file, '-' for stdin")
+    decode_command.add_argument("--table", help="ID table generated by the table command")
+    decode_command.add_argument("--port", help="serial port to read from")
+    decode_command.add_argument("--baud", type=int, default=115200)
+    decode_command.add_argument("--timestamps", action="store_true", help="prefix lines with device uptime")
+
+    args = parser.parse_args()
+
+    if args.command == "table":
+        table = build_table(args.sources)
+        document = json.dumps({"0x%08x" % key: value for key, value in sorted(table.items())}, indent=2, ensure_ascii=False)
+        if args.output:
+            with open(args.output, "w", encoding="utf-8") as output:
+                output.write(document + "\n")
+        else:
+            print(document)
+        return
+
+    table = load_table(args.table) if args.table else build_table(args.sources)
+    for text in decode_stream(read_chunks(args), table, args.timestamps):
+        sys.stdout.write(text)
+        sys.stdout.flush()
+
+
+if __name__ == "__main__":
+    main()
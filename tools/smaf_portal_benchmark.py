@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+"""
+SMAF-Vanilla-Development-Kit configuration portal benchmark.
+
+Requests pages of the configuration portal a number of times and reports the time to
+first byte, the total response time and the bytes on the wire of every path. The heap
+the device held for its last response is read from the metrics endpoint, which runs on
+the SoftAP as well. Join the SoftAP of a device in maintenance mode first:
+
+    python3 tools/smaf_portal_benchmark.py --paths / /config.json --save static.json
+    python3 tools/smaf_portal_benchmark.py --paths / --compare static.json
+    python3 tools/smaf_portal_benchmark.py --parallel 6
+
+With --parallel, the requests of a path are sent over that many connections at once, the
+way a phone browser loads a page. A server that handles one client at a time shows it
+in the upper time-to-first-byte percentiles.
+
+A saved result of a firmware that builds the page on every request serves as the
+baseline. Firmware without the metrics endpoint on the SoftAP reports no heap value.
+
+The requests are sent with gzip accepted and without cache validators, so every request
+transfers the full page.
+
+MIT License. See LICENSE in the repository root.
+"""
+
+import argparse
+import concurrent.futures
+import json
+import re
+import socket
+import sys
+import time
+
+PERCENTILES = (50, 90, 100)
+HEAP_PATTERN = re.compile(r"^smaf_config_page_heap_bytes\s+(-?\d+)\s*$", re.MULTILINE)
+
+
+def request(host, port, path, timeout):
+    """Send one GET request, return the time to first byte, the total time and the response size."""
+    start = time.monotonic()
+    with socket.create_connection((host, port), timeout=timeout) as connection:
+        connection.sendall(("GET %s HTTP/1.1\r\nHost: %s\r\nAccept-Encoding: gzip\r\nConnection: close\r\n\r\n" % (path, host)).encode("ascii"))
+        sent = time.monotonic()
+        chunk = connection.recv(4096)
+        first_byte = time.monotonic()
+        size = len(chunk)
+        while chunk:
+            chunk = connection.recv(4096)
+            size += len(chunk)
+    end = time.monotonic()
+    if size == 0:
+        raise OSError("empty response for %s" % path)
+    return (first_byte - sent) * 1000, (end - start) * 1000, size
+
+
+def read_heap(host, port, timeout):
+    """Heap held by the last portal response, None if the endpoint is not reachable."""
+    try:
+        with socket.create_connection((host, port), timeout=timeout) as connection:
+            connection.sendall(b"GET /metrics HTTP/1.1\r\nConnection: close\r\n\r\n")
+            text = b""
+            chunk = connection.recv(4096)
+            while chunk:
+                text += chunk
+                chunk = connection.recv(4096)
+    except OSError:
+        return None
+    match = HEAP_PATTERN.search(text.decode("utf-8", errors="replace"))
+    return int(match.group(1)) if match else None
+
+
+def percentile(values, rank):
+    ordered = sorted(values)
+    return round(ordered[max(0, -(-rank * len(ordered) // 100) - 1)], 1)
+
+
+def run(args):
+    result = {}
+    for path in args.paths:
+        with concurrent.futures.ThreadPoolExecutor(max_workers=args.parallel) as executor:
+            samples = list(executor.map(lambda _: request(args.host, args.port, path, args.timeout), range(args.count)))
+        heap = read_heap(args.host, args.metrics_port, args.timeout)
+        result[path] = {
+            "count": len(samples),
+            "bytes": samples[-1][2],
+            "ttfb_ms": {"p%d" % p: percentile([sample[0] for sample in samples], p) for p in PERCENTILES},
+            "total_ms": {"p%d" % p: percentile([sample[1] for sample in samples], p) for p in PERCENTILES},
+            "heap_bytes": heap,
+        }
+    return result
+
+
+def format_value(value):
+    return "-" if value is None else str(value)
+
+
+def print_report(result, baseline):
+    header = "%-16s %8s %10s" % ("path", "bytes", "heap") + "".join(" %9s" % ("ttfb p%d" % p) for p in PERCENTILES) + " %10s" % "total p50"
+    print(header + (" %10s %10s" % ("base ttfb", "base heap") if baseline else ""))
+    for path, values in result.items():
+        line = "%-16s %8d %10s" % (path, values["bytes"], format_value(values["heap_bytes"]))
+        line += "".join(" %9s" % values["ttfb_ms"]["p%d" % p] for p in PERCENTILES)
+        line += " %10s" % values["total_ms"]["p50"]
+        if baseline:
+            reference = baseline.get(path, {})
+            line += " %10s %10s" % (format_value(reference.get("ttfb_ms", {}).get("p50")), format_value(reference.get("heap_bytes")))
+        print(line)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--host", default="192.168.4.1", help="device address on the SoftAP, default 192.168.4.1")
+    parser.add_argument("--port", type=int, default=80, help="configuration server port, default 80")
+    parser.add_argument("--metrics-port", type=int, default=9100, help="metrics endpoint port, default 9100")
+    parser.add_argument("--paths", nargs="+", default=["/", "/config.json"], help="paths to request, default / and /config.json")
+    parser.add_argument("--count", type=int, default=20, help="requests per path, default 20")
+    parser.add_argument("--parallel", type=int, default=1, help="connections open at the same time, default 1")
+    parser.add_argument("--timeout", type=float, default=15, help="socket timeout in seconds, default 15")
+    parser.add_argument("--save", help="write the result to a JSON file")
+    parser.add_argument("--compare", help="JSON result of an earlier run to show side by side")
+    args = parser.parse_args()
+
+    baseline = None
+    if args.compare:
+        with open(args.compare, encoding="utf-8") as stream:
+            baseline = json.load(stream)
+
+    try:
+        result = run(args)
+    except OSError as error:
+        sys.exit("Request failed: %s" % error)
+
+    print_report(result, baseline)
+
+    if args.save:
+        with open(args.save, "w", encoding="utf-8") as stream:
+            json.dump(result, stream, indent=2)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+"""
+SMAF-Vanilla-Development-Kit sampling profile to flame graph converter.
+
+Firmware built with -DPROFILER_ENABLED=1 samples the interrupted program counter and
+task at PROFILER_SAMPLE_RATE and dumps folded entries, either on the Serial monitor
+between PROF-BEGIN and PROF-END markers or on the "<topic>/profile" MQTT topic:
+
+    PROF loopTask;0x42001234 17
+
+This tool resolves the addresses against the firmware ELF file with addr2line and
+writes folded stacks ("task;function count"), the input format of flamegraph.pl,
+speedscope and inferno.
+
+Usage:
+    python3 tools/smaf_profile_to_flamegraph.py capture.txt --elf build/SMAF.ino.elf > profile.folded
+    flamegraph.pl profile.folded > profile.svg
+
+Only the interrupted frame is sampled, so every stack has two levels: the task and the
+function that was executing. Use --lines to split functions by source line.
+
+MIT License. See LICENSE in the repository root.
+"""
+
+import argparse
+import collections
+import re
+import shutil
+import subprocess
+import sys
+
+ENTRY_PATTERN = re.compile(r"^(?:PROF\s+)?(?P<task>[^;\s][^;]*);0x(?P<pc>[0-9a-fA-F]+)\s+(?P<count>\d+)\s*$")
+
+ADDR2LINE_CANDIDATES = (
+    "xtensa-esp32s3-elf-addr2line",
+    "xtensa-esp32-elf-addr2line",
+    "xtensa-esp32s2-elf-addr2line",
+    "riscv32-esp-elf-addr2line",
+)
+
+
+def read_samples(stream):
+    """Sum folded entries from every dump found in the input."""
+    samples = collections.Counter()
+    for line in stream:
+        match = ENTRY_PATTERN.match(line.strip())
+        if match:
+            samples[(match.group("task"), int(match.group("pc"), 16))] += int(match.group("count"))
+    return samples
+
+
+def find_addr2line(explicit):
+    if explicit:
+        return explicit
+    for candidate in ADDR2LINE_CANDIDATES:
+        path = shutil.which(candidate)
+        if path:
+            return path
+    sys.exit("addr2line not found, pass --addr2line with the toolchain binary.")
+
+
+def resolve(addresses, elf, addr2line, with_lines):
+    """Map addresses to function names, or function:file:line with --lines."""
+    if not addresses:
+        return {}
+    ordered = sorted(addresses)
+    result = subprocess.run(
+        [addr2line, "-f", "-C", "-e", elf] + ["0x%08x" % address for address in ordered],
+        check=True, capture_output=True, text=True)
+    lines = result.stdout.splitlines()
+    names = {}
+    for index, address in enumerate(ordered):
+        function = lines[2 * index].strip() if 2 * index < len(lines) else "??"
+        location = lines[2 * index + 1].strip() if 2 * index + 1 < len(lines) else "??:0"
+        if function == "??":
+            function = "0x%08x" % address
+        if with_lines:
+            function = "%s:%s" % (function, location.rsplit("/", 1)[-1])
+        # Folded stack frames cannot contain separators.
+        names[address] = function.replace(";", ":").replace(" ", "_")
+    return names
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("input", nargs="?", help="Serial capture or MQTT dump, default stdin")
+    parser.add_argument("--elf", help="firmware ELF file used to resolve addresses")
+    parser.add_argument("--addr2line", help="path to the toolchain addr2line binary")
+    parser.add_argument("--lines", action="store_true", help="include source file and line in frames")
+    args = parser.parse_args()
+
+    stream = open(args.input, encoding="utf-8", errors="replace") if args.input else sys.stdin
+    with stream:
+        samples = read_samples(stream)
+
+    if args.elf:
+        names = resolve({pc for _, pc in samples if pc}, args.elf, find_addr2line(args.addr2line), args.lines)
+    else:
+        names = {}
+
+    folded = collections.Counter()
+    for (task, pc), count in samples.items():
+        function = names.get(pc, "0x%08x" % pc) if pc else "unknown"
+        folded["%s;%s" % (task.replace(" ", "_"), function)] += count
+
+    for stack, count in folded.most_common():
+        print("%s %d" % (stack, count))
+
+
+if __name__ == "__main__":
+    main()